@@ -0,0 +1,420 @@
+/**********************************************************************
+**	SOURCE FILE:	bufferPool.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    void setMemoryBudget(long long)
+**    long long memoryBudget()
+**    long long memoryReserved()
+**    long long estimateJobMemory(const QString &, long long)
+**    long long reserveMemory(long long)
+**    void releaseMemory(long long)
+**    JobBuffers *acquireBuffers()
+**    void releaseBuffers(JobBuffers *)
+**    void detachCarrier(JobBuffers *)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Keeps the memory of queued and daemon jobs bounded so the program
+** can run for days on large images.
+**
+** Before it decodes anything a job reserves what it will need against
+** the memory budget, and waits while other jobs hold too much of it.
+** A job that can never fit in the budget is turned away instead.
+** The secret is read into buffers taken from a pool, and a carrier,
+** which comes shared from the carrier cache, is copied into pooled
+** pixels before the secret is written into it. Once a job is done its
+** buffers go back to the pool, so the next job of the same size works
+** in memory that is already there. Buffers over MAX_POOLED_MB, and any
+** over MAX_POOLED_BUFFERS, are freed instead of being kept.
+*************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <QImageReader>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include "bufferPool.h"
+#include "imageStego.h"
+#include "jpegStego.h"
+#include "y4mStego.h"
+
+using namespace std;
+
+static QMutex poolLock;
+static QWaitCondition memoryReleased;
+static long long budget = (long long) DEFAULT_MEMORY_BUDGET_MB * 1024 * 1024;
+static long long reserved = 0;
+static vector<JobBuffers *> freeBuffers;
+
+
+/*****************************************************************
+** Function: setMemoryBudget
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setMemoryBudget(long long bytes)
+**            long long bytes -- Most memory all jobs together may reserve
+**
+** Returns: void
+**********************************************************************/
+void setMemoryBudget(long long bytes)
+{
+    QMutexLocker locker(&poolLock);
+    budget = bytes;
+    memoryReleased.wakeAll();
+}
+
+
+
+/*****************************************************************
+** Function: memoryBudget
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long memoryBudget()
+**
+** Returns:
+**          long long -- Most memory all jobs together may reserve
+**********************************************************************/
+long long memoryBudget()
+{
+    QMutexLocker locker(&poolLock);
+    return budget;
+}
+
+
+
+/*****************************************************************
+** Function: memoryReserved
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long memoryReserved()
+**
+** Returns:
+**          long long -- Memory the running jobs have reserved
+**********************************************************************/
+long long memoryReserved()
+{
+    QMutexLocker locker(&poolLock);
+    return reserved;
+}
+
+
+
+/*****************************************************************
+** Function: estimateJobMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Counts the frames a Y4M carrier streams through
+** October 19th, 2026 - Counts the coefficients of a JPEG carrier
+** October 19th, 2026 - Counts the encoded file read on a cache miss
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long estimateJobMemory(const QString &carrierPath, long long secretSize)
+**            const QString &carrierPath -- Carrier the job will decode
+**            long long secretSize -- Size of the secret the job holds in memory
+**
+** Returns:
+**          long long -- Bytes the job will need at most
+**
+** Notes:
+** Only reads the header of the carrier. The pixels are counted twice,
+** once for the decoded carrier and once for the converted copy or
+** the encoded output made from it. A JPEG carrier may instead be kept
+** as a JPEG, which holds all its coefficients, so it counts whichever
+** of the two is more. The encoded file is counted too, as a carrier
+** missing from the carrier cache is decoded from it and some image
+** formats (e.g. WebP) read all of it before decoding.
+**********************************************************************/
+long long estimateJobMemory(const QString &carrierPath, long long secretSize)
+{
+    //a video is streamed a few frames at a time, the secret along with it
+    if (y4mIsCarrier(carrierPath.toStdString()))
+    {
+        return y4mJobMemory(carrierPath.toStdString());
+    }
+
+    QImageReader reader(carrierPath);
+    QSize size = reader.size();
+    if (!size.isValid())
+    {
+        return secretSize;
+    }
+
+    long long bytesPerPixel = (carrierBitDepth(reader.imageFormat()) == 16) ? 8 : 4;
+    long long needed = (long long) size.width() * size.height() * bytesPerPixel * 2 + secretSize
+                       + QFileInfo(carrierPath).size();
+
+    if (jpegIsCarrier(carrierPath.toStdString()))
+    {
+        needed = max(needed, jpegJobMemory(carrierPath.toStdString()) + secretSize);
+    }
+
+    return needed;
+}
+
+
+
+/*****************************************************************
+** Function: reserveMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Turns away jobs larger than the whole budget
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long reserveMemory(long long bytes)
+**            long long bytes -- Memory the job needs
+**
+** Returns:
+**          long long -- Memory reserved, to hand back to releaseMemory,
+**                       or -1 if the job needs more than the whole budget
+**
+** Notes:
+** Blocks until the memory fits in the budget. A job larger than the
+** whole budget could only run by going over it, so it is turned away
+** and logged, and the caller fails it.
+**********************************************************************/
+long long reserveMemory(long long bytes)
+{
+    QMutexLocker locker(&poolLock);
+
+    //the budget may shrink while waiting
+    while (bytes <= budget && reserved + bytes > budget)
+    {
+        memoryReleased.wait(&poolLock);
+    }
+
+    if (bytes > budget)
+    {
+        fprintf(stderr, "A job needs %lld MB, more than the memory budget of %lld MB\n",
+                bytes / (1024 * 1024), budget / (1024 * 1024));
+        return -1;
+    }
+    reserved += bytes;
+
+    return bytes;
+}
+
+
+
+/*****************************************************************
+** Function: releaseMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void releaseMemory(long long bytes)
+**            long long bytes -- Memory returned by reserveMemory
+**
+** Returns: void
+**********************************************************************/
+void releaseMemory(long long bytes)
+{
+    QMutexLocker locker(&poolLock);
+    reserved -= bytes;
+    memoryReleased.wakeAll();
+}
+
+
+
+/*****************************************************************
+** Function: acquireBuffers
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          JobBuffers *acquireBuffers()
+**
+** Returns:
+**          JobBuffers * -- Buffers for one job, to hand back to releaseBuffers
+**********************************************************************/
+JobBuffers *acquireBuffers()
+{
+    QMutexLocker locker(&poolLock);
+
+    if (freeBuffers.empty())
+    {
+        return new JobBuffers();
+    }
+
+    JobBuffers *buffers = freeBuffers.back();
+    freeBuffers.pop_back();
+
+    return buffers;
+}
+
+
+
+/*****************************************************************
+** Function: releaseBuffers
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void releaseBuffers(JobBuffers *buffers)
+**            JobBuffers *buffers -- Buffers from acquireBuffers
+**
+** Returns: void
+**
+** Notes:
+** A carrier the job wrote into holds pixels of its own, which become
+** the pooled pixels of the buffers. A carrier still shared with the
+** carrier cache or the window is let go rather than kept alive by the
+** pool.
+**********************************************************************/
+void releaseBuffers(JobBuffers *buffers)
+{
+    long long maxPooled = (long long) MAX_POOLED_MB * 1024 * 1024;
+
+    if (buffers->carrier.isDetached())
+    {
+        buffers->pixels.swap(buffers->carrier);
+    }
+    buffers->carrier = QImage();
+
+    if (buffers->pixels.sizeInBytes() > maxPooled)
+    {
+        buffers->pixels = QImage();
+    }
+
+    if ((long long) buffers->secret.capacity() > maxPooled)
+    {
+        vector<char>().swap(buffers->secret);
+    }
+    buffers->secret.clear();
+
+    QMutexLocker locker(&poolLock);
+    if (freeBuffers.size() < MAX_POOLED_BUFFERS)
+    {
+        freeBuffers.push_back(buffers);
+        return;
+    }
+
+    locker.unlock();
+    delete buffers;
+}
+
+
+
+/*****************************************************************
+** Function: detachCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void detachCarrier(JobBuffers *buffers)
+**            JobBuffers *buffers -- Buffers holding the carrier a job is about to write
+**
+** Returns: void
+**
+** Notes:
+** Called before a secret is written into the carrier. A carrier shared
+** with the carrier cache would otherwise be copied into new memory on
+** the first write. If the pooled pixels have the same size and layout
+** it is copied into them instead; otherwise it is copied as usual, and
+** the copy is pooled once the job is done.
+**********************************************************************/
+void detachCarrier(JobBuffers *buffers)
+{
+    QImage *carrier = &buffers->carrier;
+    QImage *pixels = &buffers->pixels;
+
+    if (carrier->isNull() || carrier->isDetached())
+    {
+        return;
+    }
+
+    if (pixels->size() != carrier->size() || pixels->format() != carrier->format()
+            || pixels->bytesPerLine() != carrier->bytesPerLine())
+    {
+        *carrier = carrier->copy();
+        return;
+    }
+
+    memcpy(pixels->bits(), carrier->constBits(), (size_t) carrier->sizeInBytes());
+    pixels->setColorTable(carrier->colorTable());
+    pixels->setDotsPerMeterX(carrier->dotsPerMeterX());
+    pixels->setDotsPerMeterY(carrier->dotsPerMeterY());
+
+    carrier->swap(*pixels);
+    *pixels = QImage();
+}
@@ -0,0 +1,30 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QImage>
+#include <QString>
+#include <vector>
+
+#define DEFAULT_MEMORY_BUDGET_MB 1024
+#define MAX_POOLED_BUFFERS 16
+#define MAX_POOLED_MB 256
+
+//pixel and payload buffers a job works in
+struct JobBuffers
+{
+    QImage carrier;
+    QImage pixels;              //pooled storage the carrier is copied into before it is written
+    std::vector<char> secret;
+};
+
+void setMemoryBudget(long long);
+long long memoryBudget();
+long long memoryReserved();
+long long estimateJobMemory(const QString &, long long);
+long long reserveMemory(long long);
+void releaseMemory(long long);
+JobBuffers *acquireBuffers();
+void releaseBuffers(JobBuffers *);
+void detachCarrier(JobBuffers *);
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,387 @@
+/**********************************************************************
+**	SOURCE FILE:	carrierCache.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    void setCarrierCacheBudget(long long)
+**    void clearCarrierCache()
+**    CarrierCacheStats carrierCacheStats()
+**    bool readCachedCarrier(const QString &, QImage *, QString *)
+**    void evictCarriers(long long)
+**    bool sameFile(const QFileInfo &, const CarrierFile &)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Keeps the carriers decoded lately so embedding into the same image
+** again, e.g. another secret or other bit positions, skips the decode.
+** One cache is shared by the window, the queued jobs and the daemon.
+**
+** Carriers are found by a hash of the bytes of their file, so a file
+** that was replaced is decoded again and copies of one image under
+** other names are decoded once. The hash of each path is kept with the
+** size and modification time of the file, and the file is only hashed
+** again once those change. They are kept converted to the layout
+** the scanline functions work on (see carrierLayout). Each caller gets
+** its own QImage sharing the cached pixels, which only copies them
+** once it embeds into them, so reading a secret never copies at all.
+**
+** The least recently used carriers are dropped once the cache holds
+** more than its budget. A carrier larger than the whole budget is not
+** kept. This budget is separate from the memory budget of the jobs
+** (see bufferPool): a job hands its reservation back when it is done,
+** while a cached carrier stays until it is evicted, so counting it
+** against the jobs would leave them waiting on memory nothing is going
+** to release. The two budgets together bound what the program holds.
+*************************************************************************/
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QImageReader>
+#include <QCryptographicHash>
+#include "carrierCache.h"
+#include "imageStego.h"
+
+using namespace std;
+
+//one decoded carrier and when it was last handed out
+struct CachedCarrier
+{
+    QImage image;
+    quint64 lastUsed;
+};
+
+//the hash of a carrier file when it was last read
+struct CarrierFile
+{
+    qint64 size;
+    qint64 modified;            //milliseconds since the epoch
+    QByteArray key;
+};
+
+static void evictCarriers(long long);
+static bool sameFile(const QFileInfo &, const CarrierFile &);
+
+static QMutex cacheLock;
+static QHash<QByteArray, CachedCarrier> carriers;
+static QHash<QString, CarrierFile> carrierFiles;
+static long long cacheBudget = (long long) DEFAULT_CARRIER_CACHE_MB * 1024 * 1024;
+static long long cachedBytes = 0;
+static quint64 useCount = 0;
+static long long numHits = 0;
+static long long numMisses = 0;
+
+
+/*****************************************************************
+** Function: setCarrierCacheBudget
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setCarrierCacheBudget(long long bytes)
+**            long long bytes -- Most pixel memory the cache may hold, 0 to turn it off
+**
+** Returns: void
+**********************************************************************/
+void setCarrierCacheBudget(long long bytes)
+{
+    QMutexLocker locker(&cacheLock);
+    cacheBudget = bytes;
+    evictCarriers(0);
+}
+
+
+
+/*****************************************************************
+** Function: clearCarrierCache
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void clearCarrierCache()
+**
+** Returns: void
+**
+** Notes:
+** Carriers still in use by a job stay alive until the job is done.
+**********************************************************************/
+void clearCarrierCache()
+{
+    QMutexLocker locker(&cacheLock);
+    carriers.clear();
+    carrierFiles.clear();
+    cachedBytes = 0;
+}
+
+
+
+/*****************************************************************
+** Function: carrierCacheStats
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          CarrierCacheStats carrierCacheStats()
+**
+** Returns:
+**          CarrierCacheStats -- Hits, misses and what the cache holds
+**********************************************************************/
+CarrierCacheStats carrierCacheStats()
+{
+    QMutexLocker locker(&cacheLock);
+
+    CarrierCacheStats stats;
+    stats.hits = numHits;
+    stats.misses = numMisses;
+    stats.bytes = cachedBytes;
+    stats.carriers = carriers.size();
+
+    return stats;
+}
+
+
+
+/*****************************************************************
+** Function: readCachedCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Hashes the file only when its size or time changed
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool readCachedCarrier(const QString &path, QImage *carrier, QString *error)
+**            const QString &path -- Image file of the carrier
+**            QImage *carrier -- Set to the decoded carrier
+**            QString *error -- Set to what went wrong
+**
+** Returns:
+**          bool -- False if the carrier could not be read
+**
+** Notes:
+** A file whose size and modification time are as they were when it
+** was last hashed is found without reading it. Otherwise the file is
+** hashed as it streams past, and only decoded when the cache does not
+** have it; the encoded bytes are never held in memory. A file changed
+** while it was decoded is not kept. Two jobs missing on the same
+** carrier at once both decode it, and the second one's copy is the
+** one kept.
+**********************************************************************/
+bool readCachedCarrier(const QString &path, QImage *carrier, QString *error)
+{
+    QFileInfo info(path);
+    QString filePath = info.absoluteFilePath();
+
+    QMutexLocker locker(&cacheLock);
+    QHash<QString, CarrierFile>::iterator known = carrierFiles.find(filePath);
+    if (known != carrierFiles.end() && sameFile(info, *known))
+    {
+        QHash<QByteArray, CachedCarrier>::iterator found = carriers.find(known->key);
+        if (found != carriers.end())
+        {
+            found->lastUsed = ++useCount;
+            numHits++;
+            *carrier = found->image;
+            return true;
+        }
+    }
+    locker.unlock();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    QByteArray key = hash.result();
+
+    CarrierFile hashed;
+    hashed.size = info.size();
+    hashed.modified = info.lastModified().toMSecsSinceEpoch();
+    hashed.key = key;
+
+    locker.relock();
+    carrierFiles.insert(filePath, hashed);
+
+    QHash<QByteArray, CachedCarrier>::iterator found = carriers.find(key);
+    if (found != carriers.end())
+    {
+        found->lastUsed = ++useCount;
+        numHits++;
+        *carrier = found->image;
+        return true;
+    }
+
+    numMisses++;
+    locker.unlock();
+
+    file.seek(0);
+    QImageReader reader(&file, info.suffix().toLatin1());
+
+    if (!reader.read(carrier))
+    {
+        *error = reader.errorString();
+        return false;
+    }
+    file.close();
+    carrierLayout(carrier);
+
+    long long size = carrier->sizeInBytes();
+
+    //the hash only stands for the pixels if the file did not change under the decode
+    QFileInfo decoded(path);
+    if (!sameFile(decoded, hashed))
+    {
+        return true;
+    }
+
+    locker.relock();
+    if (size > cacheBudget)
+    {
+        return true;
+    }
+
+    found = carriers.find(key);
+    if (found != carriers.end())
+    {
+        cachedBytes -= found->image.sizeInBytes();
+        carriers.erase(found);
+    }
+
+    evictCarriers(size);
+
+    CachedCarrier cached;
+    cached.image = *carrier;
+    cached.lastUsed = ++useCount;
+    carriers.insert(key, cached);
+    cachedBytes += size;
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: evictCarriers
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Forgets the files hashed to the carriers dropped
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void evictCarriers(long long room)
+**            long long room -- Bytes to make room for under the budget
+**
+** Returns: void
+**
+** Notes:
+** Called with the cache locked. Drops the least recently used
+** carriers until the room fits, and forgets the files hashed to them.
+** The cache holds few carriers, so the oldest is found by looking
+** through all of them.
+**********************************************************************/
+static void evictCarriers(long long room)
+{
+    while (!carriers.isEmpty() && cachedBytes + room > cacheBudget)
+    {
+        QHash<QByteArray, CachedCarrier>::iterator oldest = carriers.begin();
+        for (QHash<QByteArray, CachedCarrier>::iterator i = carriers.begin(); i != carriers.end(); ++i)
+        {
+            if (i->lastUsed < oldest->lastUsed)
+            {
+                oldest = i;
+            }
+        }
+
+        QByteArray key = oldest.key();
+        cachedBytes -= oldest->image.sizeInBytes();
+        carriers.erase(oldest);
+
+        QHash<QString, CarrierFile>::iterator i = carrierFiles.begin();
+        while (i != carrierFiles.end())
+        {
+            if (i->key == key)
+            {
+                i = carrierFiles.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: sameFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool sameFile(const QFileInfo &info, const CarrierFile &hashed)
+**            const QFileInfo &info -- File as it is now
+**            const CarrierFile &hashed -- File as it was when hashed
+**
+** Returns:
+**          bool -- True if the size and modification time are unchanged
+**********************************************************************/
+static bool sameFile(const QFileInfo &info, const CarrierFile &hashed)
+{
+    return info.exists() && info.size() == hashed.size
+           && info.lastModified().toMSecsSinceEpoch() == hashed.modified;
+}
@@ -0,0 +1,24 @@
+#ifndef CARRIERCACHE_H
+#define CARRIERCACHE_H
+
+#include <QImage>
+#include <QString>
+
+//held apart from the memory budget of the jobs, see carrierCache.cpp
+#define DEFAULT_CARRIER_CACHE_MB 256
+
+//how the cache has done since the program started
+struct CarrierCacheStats
+{
+    long long hits;
+    long long misses;
+    long long bytes;            //pixels held
+    int carriers;
+};
+
+void setCarrierCacheBudget(long long);
+void clearCarrierCache();
+CarrierCacheStats carrierCacheStats();
+bool readCachedCarrier(const QString &, QImage *, QString *);
+
+#endif // CARRIERCACHE_H
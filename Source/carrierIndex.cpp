@@ -0,0 +1,552 @@
+/**********************************************************************
+**	SOURCE FILE:	carrierIndex.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    bool loadCarrierIndex(const QString &, QVector<CarrierEntry> *)
+**    bool saveCarrierIndex(const QString &, const QVector<CarrierEntry> &)
+**    bool updateCarrierIndex(const QString &, const QString &, int, CarrierIndexStats *)
+**    int findSmallestCarrier(const QVector<CarrierEntry> &, const string &, long long, const bool *,
+**                            const StegoOptions *)
+**    void readHeaders(const QDir *, QVector<CarrierEntry> *, const QVector<int> *, int, int)
+**    void readHeader(const QString &, CarrierEntry *)
+**    qint64 slotsPerBit(const CarrierEntry &)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Keeps an index of the carriers in a folder tree so one big enough
+** for a secret can be picked without opening any of them.
+**
+** Only the header of each image is read (QImageReader::size and
+** imageFormat), never its pixels, on a pool of threads since the time
+** goes into waiting on the disk. The index is a text file with a line
+** per file: its path, size and modification time, its dimensions,
+** format, channels and depth, and the bytes it holds with 1 to 16 bits
+** per channel. Updating it only reads the headers of files that are new
+** or changed since the last update and drops the ones that are gone.
+**
+** Finding the smallest carrier a secret fits in is a pass over the
+** index in memory, with the header of the secret counted exactly (see
+** stegoSlotsNeeded).
+*************************************************************************/
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QImageReader>
+#include <QThread>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include "carrierIndex.h"
+#include "imageStego.h"
+
+using namespace std;
+
+static void readHeaders(const QDir *, QVector<CarrierEntry> *, const QVector<int> *, int, int);
+static void readHeader(const QString &, CarrierEntry *);
+static qint64 slotsPerBit(const CarrierEntry &);
+
+
+/*****************************************************************
+** Function: loadCarrierIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool loadCarrierIndex(const QString &indexFile, QVector<CarrierEntry> *entries)
+**            const QString &indexFile -- Index to read
+**            QVector<CarrierEntry> *entries -- Receives one entry per file
+**
+** Returns:
+**          bool -- False if the file is missing or not an index
+**
+** Notes:
+** Lines that do not parse are skipped, so a damaged line only costs
+** that file being read again on the next update.
+**********************************************************************/
+bool loadCarrierIndex(const QString &indexFile, QVector<CarrierEntry> *entries)
+{
+    entries->clear();
+
+    QFile file(indexFile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    if (file.readLine().trimmed() != CARRIER_INDEX_MAGIC)
+    {
+        return false;
+    }
+
+    while (!file.atEnd())
+    {
+        QList<QByteArray> fields = file.readLine().trimmed().split('\t');
+        if (fields.size() != 8 + MAX_NUM_BITS)
+        {
+            continue;
+        }
+
+        CarrierEntry entry;
+        bool valid = true;
+        bool ok;
+
+        entry.path = QString::fromUtf8(fields[0]);
+        entry.fileSize = fields[1].toLongLong(&ok);
+        valid = valid && ok;
+        entry.modified = fields[2].toLongLong(&ok);
+        valid = valid && ok;
+        entry.width = fields[3].toInt(&ok);
+        valid = valid && ok;
+        entry.height = fields[4].toInt(&ok);
+        valid = valid && ok;
+        entry.format = fields[5].toInt(&ok);
+        valid = valid && ok;
+        entry.channels = fields[6].toInt(&ok);
+        valid = valid && ok;
+        entry.depth = fields[7].toInt(&ok);
+        valid = valid && ok;
+
+        for (int i = 0; i < MAX_NUM_BITS; i++)
+        {
+            entry.capacity[i] = fields[8 + i].toLongLong(&ok);
+            valid = valid && ok;
+        }
+
+        if (valid && !entry.path.isEmpty())
+        {
+            entries->append(entry);
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: saveCarrierIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool saveCarrierIndex(const QString &indexFile, const QVector<CarrierEntry> &entries)
+**            const QString &indexFile -- Index to write
+**            const QVector<CarrierEntry> &entries -- One entry per file
+**
+** Returns:
+**          bool -- False if the index could not be written
+**
+** Notes:
+** The entries are written from the smallest carrier to the largest.
+** The old index is only replaced once the new one is complete.
+**********************************************************************/
+bool saveCarrierIndex(const QString &indexFile, const QVector<CarrierEntry> &entries)
+{
+    QVector<CarrierEntry> sorted = entries;
+    stable_sort(sorted.begin(), sorted.end(), [](const CarrierEntry &a, const CarrierEntry &b)
+    {
+        return slotsPerBit(a) < slotsPerBit(b);
+    });
+
+    QSaveFile file(indexFile);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << CARRIER_INDEX_MAGIC << '\n';
+
+    for (int i = 0; i < sorted.size(); i++)
+    {
+        const CarrierEntry &entry = sorted[i];
+        out << entry.path << '\t' << entry.fileSize << '\t' << entry.modified << '\t'
+            << entry.width << '\t' << entry.height << '\t' << entry.format << '\t'
+            << entry.channels << '\t' << entry.depth;
+
+        for (int bits = 0; bits < MAX_NUM_BITS; bits++)
+        {
+            out << '\t' << entry.capacity[bits];
+        }
+        out << '\n';
+    }
+
+    out.flush();
+    return out.status() == QTextStream::Ok && file.commit();
+}
+
+
+
+/*****************************************************************
+** Function: updateCarrierIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool updateCarrierIndex(const QString &folder, const QString &indexFile, int numThreads,
+**                                  CarrierIndexStats *stats)
+**            const QString &folder -- Top of the folder tree of carriers
+**            const QString &indexFile -- Index to bring up to date
+**            int numThreads -- Headers read at once, 0 for INDEX_READERS_PER_CORE per core
+**            CarrierIndexStats *stats -- Set to what the update did
+**
+** Returns:
+**          bool -- False if the folder can not be read or the index written
+**
+** Notes:
+** Walks the tree for files with the suffix of an image format Qt can
+** read. A file with the same size and modification time as in the
+** index keeps its entry, every other one has its header read. Files
+** that turn out not to be images stay in the index (with no size) so
+** they are not read again until they change.
+**********************************************************************/
+bool updateCarrierIndex(const QString &folder, const QString &indexFile, int numThreads, CarrierIndexStats *stats)
+{
+    stats->carriers = 0;
+    stats->read = 0;
+    stats->kept = 0;
+    stats->removed = 0;
+    stats->unreadable = 0;
+
+    QDir root(folder);
+    if (!root.exists())
+    {
+        return false;
+    }
+
+    QVector<CarrierEntry> previous;
+    loadCarrierIndex(indexFile, &previous);
+
+    QHash<QString, int> known;
+    for (int i = 0; i < previous.size(); i++)
+    {
+        known.insert(previous[i].path, i);
+    }
+
+    QSet<QString> suffixes;
+    QList<QByteArray> formats = QImageReader::supportedImageFormats();
+    for (int i = 0; i < formats.size(); i++)
+    {
+        suffixes.insert(QString::fromLatin1(formats[i]).toLower());
+    }
+
+    QVector<CarrierEntry> entries;
+    QVector<int> toRead;
+    int seen = 0;
+
+    QDirIterator files(folder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (files.hasNext())
+    {
+        files.next();
+        QFileInfo info = files.fileInfo();
+
+        //a path with a tab or line break would break the lines of the index
+        QString path = root.relativeFilePath(info.filePath());
+        if (!suffixes.contains(info.suffix().toLower()) || path.contains('\t') || path.contains('\n'))
+        {
+            continue;
+        }
+
+        CarrierEntry entry;
+        entry.path = path;
+        entry.fileSize = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+
+        QHash<QString, int>::const_iterator found = known.constFind(path);
+        if (found != known.constEnd())
+        {
+            seen++;
+
+            const CarrierEntry &old = previous[found.value()];
+            if (old.fileSize == entry.fileSize && old.modified == entry.modified)
+            {
+                entries.append(old);
+                stats->kept++;
+                continue;
+            }
+        }
+
+        entries.append(entry);
+        toRead.append(entries.size() - 1);
+    }
+
+    stats->removed = previous.size() - seen;
+    stats->read = toRead.size();
+
+    //reading a header is mostly waiting on the disk, so run more readers than cores
+    if (numThreads <= 0)
+    {
+        numThreads = QThread::idealThreadCount() * INDEX_READERS_PER_CORE;
+    }
+    numThreads = qBound(1, numThreads, qMax(1, toRead.size()));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QVector<QFuture<void> > readers;
+    for (int i = 0; i < numThreads; i++)
+    {
+        readers.append(QtConcurrent::run(&pool, readHeaders, &root, &entries, &toRead, i, numThreads));
+    }
+
+    for (int i = 0; i < readers.size(); i++)
+    {
+        readers[i].waitForFinished();
+    }
+
+    for (int i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].width > 0)
+        {
+            stats->carriers++;
+        }
+        else
+        {
+            stats->unreadable++;
+        }
+    }
+
+    return saveCarrierIndex(indexFile, entries);
+}
+
+
+
+/*****************************************************************
+** Function: findSmallestCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int findSmallestCarrier(const QVector<CarrierEntry> &entries, const string &name, long long size,
+**                                  const bool *enabledBits, const StegoOptions *options)
+**            const QVector<CarrierEntry> &entries -- Index of the carriers
+**            const string &name -- Name the secret is embedded under
+**            long long size -- Size of the secret
+**            const bool *enabledBits -- Bit positions to embed in
+**            const StegoOptions *options -- How the data would be spread, may be null
+**
+** Returns:
+**          int -- Entry of the carrier with the least room the secret fits
+**                 in, or -1 if none does
+**
+** Notes:
+** A carrier only qualifies if it has every enabled bit position, so
+** the high positions rule out 8 bit carriers. Ties go to the smaller
+** file.
+**********************************************************************/
+int findSmallestCarrier(const QVector<CarrierEntry> &entries, const string &name, long long size,
+                        const bool *enabledBits, const StegoOptions *options)
+{
+    long long needed = stegoSlotsNeeded(name, size, options);
+
+    int numBits = 0;
+    int highest = -1;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        if (enabledBits[i])
+        {
+            numBits++;
+            highest = i;
+        }
+    }
+
+    if (needed < 0 || numBits == 0)
+    {
+        return -1;
+    }
+
+    int best = -1;
+    qint64 bestSlots = 0;
+
+    for (int i = 0; i < entries.size(); i++)
+    {
+        const CarrierEntry &entry = entries[i];
+        if (entry.width == 0 || highest >= entry.depth)
+        {
+            continue;
+        }
+
+        qint64 slots = slotsPerBit(entry) * numBits;
+        if (slots < needed)
+        {
+            continue;
+        }
+
+        if (best == -1 || slots < bestSlots || (slots == bestSlots && entry.fileSize < entries[best].fileSize))
+        {
+            best = i;
+            bestSlots = slots;
+        }
+    }
+
+    return best;
+}
+
+
+
+/*****************************************************************
+** Function: readHeaders
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void readHeaders(const QDir *root, QVector<CarrierEntry> *entries, const QVector<int> *toRead,
+**                           int first, int step)
+**            const QDir *root -- Folder the paths are relative to
+**            QVector<CarrierEntry> *entries -- Entries of the index
+**            const QVector<int> *toRead -- Entries whose headers are read
+**            int first -- First of toRead this reader takes
+**            int step -- Number of readers
+**
+** Returns: void
+**
+** Notes:
+** Runs on a reader thread, taking every step-th entry so the readers
+** never touch the same one.
+**********************************************************************/
+static void readHeaders(const QDir *root, QVector<CarrierEntry> *entries, const QVector<int> *toRead,
+                        int first, int step)
+{
+    for (int i = first; i < toRead->size(); i += step)
+    {
+        CarrierEntry *entry = &(*entries)[(*toRead)[i]];
+        readHeader(root->filePath(entry->path), entry);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: readHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void readHeader(const QString &path, CarrierEntry *entry)
+**            const QString &path -- Image file
+**            CarrierEntry *entry -- Receives the dimensions, format and capacity
+**
+** Returns: void
+**
+** Notes:
+** Formats that do not say what they decode to from their header are
+** counted as 8 bit colour. The capacity is the same count of slots the
+** window shows, header included.
+**********************************************************************/
+static void readHeader(const QString &path, CarrierEntry *entry)
+{
+    QImageReader reader(path);
+    QSize size = reader.size();
+
+    entry->width = 0;
+    entry->height = 0;
+    entry->format = QImage::Format_Invalid;
+    entry->channels = 0;
+    entry->depth = 0;
+
+    if (size.isValid() && !size.isEmpty())
+    {
+        QImage::Format format = reader.imageFormat();
+        if (format == QImage::Format_Invalid)
+        {
+            format = QImage::Format_RGB32;
+        }
+
+        entry->width = size.width();
+        entry->height = size.height();
+        entry->format = (int) format;
+        entry->channels = carrierChannels(format);
+        entry->depth = carrierBitDepth(format);
+    }
+
+    for (int bits = 1; bits <= MAX_NUM_BITS; bits++)
+    {
+        entry->capacity[bits - 1] = (bits <= entry->depth) ? slotsPerBit(*entry) * bits / 8 : 0;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: slotsPerBit
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          qint64 slotsPerBit(const CarrierEntry &entry)
+**            const CarrierEntry &entry -- Carrier in the index
+**
+** Returns:
+**          qint64 -- Slots the carrier has for each bit position enabled
+**********************************************************************/
+static qint64 slotsPerBit(const CarrierEntry &entry)
+{
+    return (qint64) entry.width * entry.height * entry.channels;
+}
@@ -0,0 +1,43 @@
+#ifndef CARRIERINDEX_H
+#define CARRIERINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <string>
+#include "stegoCore.h"
+
+#define CARRIER_INDEX_NAME ".imagestego-index"
+#define CARRIER_INDEX_MAGIC "imagestego-index 1"
+#define INDEX_READERS_PER_CORE 4
+
+//what the header of one carrier says, read without decoding its pixels
+struct CarrierEntry
+{
+    QString path;                   //relative to the indexed folder
+    qint64 fileSize;
+    qint64 modified;                //milliseconds since the epoch
+    int width;                      //0 if the file is not a readable image
+    int height;
+    int format;                     //QImage::Format the carrier decodes to
+    int channels;
+    int depth;
+    qint64 capacity[MAX_NUM_BITS];  //bytes with 1 to 16 bits per channel, 0 past the depth
+};
+
+//what an update of the index did
+struct CarrierIndexStats
+{
+    int carriers;                   //readable images in the index
+    int read;                       //headers read
+    int kept;                       //unchanged since the last update
+    int removed;                    //gone since the last update
+    int unreadable;                 //files with an image suffix that are not images
+};
+
+bool loadCarrierIndex(const QString &, QVector<CarrierEntry> *);
+bool saveCarrierIndex(const QString &, const QVector<CarrierEntry> &);
+bool updateCarrierIndex(const QString &, const QString &, int, CarrierIndexStats *);
+int findSmallestCarrier(const QVector<CarrierEntry> &, const std::string &, long long, const bool *,
+                        const StegoOptions *);
+
+#endif // CARRIERINDEX_H
@@ -0,0 +1,211 @@
+/**********************************************************************
+**	SOURCE FILE:	carrierLoader.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    CarrierLoader(QObject *parent = 0)
+**    ~CarrierLoader()
+**    int load(QString)
+**    void readCarrier(CarrierLoader *, int, QString)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Loads carrier images on a worker thread so the GUI never waits on a
+** decode. Each load reports in stages: the dimensions as soon as the
+** header is read, a scaled preview when the format can produce one
+** cheaply, and finally the full image. The coefficients of a JPEG
+** carrier are counted there too, since that reads the whole file.
+*************************************************************************/
+#include <QImageReader>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFileInfo>
+#include "carrierLoader.h"
+#include "stegoTrace.h"
+#include "carrierCache.h"
+#include "jpegStego.h"
+
+using namespace std;
+
+
+/*****************************************************************
+** Function: CarrierLoader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          CarrierLoader(QObject *parent)
+**            QObject *parent -- Owner of the loader
+**
+** Returns: N/A (Constructor)
+**
+** Notes:
+** Sets up the single worker thread the loads run on.
+**********************************************************************/
+CarrierLoader::CarrierLoader(QObject *parent) : QObject(parent)
+{
+    worker.setMaxThreadCount(1);
+    nextTicket = 0;
+}
+
+
+
+/*****************************************************************
+** Function: ~CarrierLoader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          ~CarrierLoader()
+**
+** Returns: N/A (Destructor)
+**
+** Notes:
+** Drops loads that have not started and waits for the current one.
+**********************************************************************/
+CarrierLoader::~CarrierLoader()
+{
+    worker.clear();
+    worker.waitForDone();
+}
+
+
+
+/*****************************************************************
+** Function: load
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int load(QString filePath)
+**            QString filePath -- Image to load
+**
+** Returns:
+**          int -- Ticket that every signal of this load will carry
+**
+** Notes:
+** Queues the image to be loaded and returns right away.
+**********************************************************************/
+int CarrierLoader::load(QString filePath)
+{
+    int ticket = nextTicket++;
+    QtConcurrent::run(&worker, readCarrier, this, ticket, filePath);
+
+    return ticket;
+}
+
+
+
+/*****************************************************************
+** Function: readCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Traces the decode
+** October 19th, 2026 - Takes the image from the carrier cache
+** October 19th, 2026 - Counts the coefficients of JPEG carriers
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void readCarrier(CarrierLoader *loader, int ticket, QString filePath)
+**            CarrierLoader *loader -- Loader to report through
+**            int ticket -- Ticket of the load
+**            QString filePath -- Image to load
+**
+** Returns: void
+**
+** Notes:
+** Runs on the worker thread. The size comes from the header without
+** decoding any pixels. A preview is only made when the format can
+** decode straight to a smaller size (e.g. JPEG), since for other
+** formats it would cost as much as the full decode. The full decode
+** goes through the carrier cache, so loading a carrier again does not
+** decode it again, and is traced. A JPEG carrier has the bits its
+** coefficients can hold counted once here, before the image is
+** reported, so the window never reads the file to show the capacity.
+**********************************************************************/
+void CarrierLoader::readCarrier(CarrierLoader *loader, int ticket, QString filePath)
+{
+    traceStartJob("load " + QFileInfo(filePath).fileName().toStdString());
+
+    QImageReader reader(filePath);
+    QSize size = reader.size();
+    if (size.isValid())
+    {
+        emit loader->headerRead(ticket, size, (int) reader.imageFormat());
+
+        if ((size.width() > PREVIEW_SIZE || size.height() > PREVIEW_SIZE)
+                && reader.supportsOption(QImageIOHandler::ScaledSize))
+        {
+            QImageReader previewReader(filePath);
+            previewReader.setScaledSize(size.scaled(PREVIEW_SIZE, PREVIEW_SIZE, Qt::KeepAspectRatio));
+
+            QImage preview = previewReader.read();
+            if (!preview.isNull())
+            {
+                emit loader->previewReady(ticket, preview);
+            }
+        }
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QImage image;
+    QString error;
+    bool decoded = readCachedCarrier(filePath, &image, &error);
+    traceEnd(&span, (long long) image.width() * image.height(), image.sizeInBytes());
+
+    if (decoded && jpegIsCarrier(filePath.toStdString()))
+    {
+        traceBegin(&span, STAGE_DECODE);
+        long long capacity = jpegCapacity(filePath.toStdString());
+        traceEnd(&span, (long long) image.width() * image.height(), 0);
+
+        emit loader->jpegCapacityRead(ticket, (qint64) capacity);
+    }
+
+    emit loader->traced(QString::fromStdString(traceFinishJob()));
+
+    if (!decoded)
+    {
+        emit loader->loadFailed(ticket, error);
+    }
+    else
+    {
+        emit loader->imageReady(ticket, image);
+    }
+}
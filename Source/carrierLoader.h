@@ -0,0 +1,37 @@
+#ifndef CARRIERLOADER_H
+#define CARRIERLOADER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+#define PREVIEW_SIZE 1024
+
+class CarrierLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    CarrierLoader(QObject *parent = 0);
+    ~CarrierLoader();
+    int load(QString);
+
+signals:
+    void headerRead(int, QSize, int);
+    void previewReady(int, QImage);
+    void imageReady(int, QImage);
+    void jpegCapacityRead(int, qint64);
+    void loadFailed(int, QString);
+    void traced(QString);
+
+private:
+    static void readCarrier(CarrierLoader *, int, QString);
+
+    //a single worker so queued loads finish in the order they were dropped
+    QThreadPool worker;
+    int nextTicket;
+};
+
+#endif // CARRIERLOADER_H
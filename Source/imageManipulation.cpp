@@ -4,8 +4,44 @@
 **	PROGRAM:	Steganography
 **
 **	FUNCTIONS:
-**  int embedBitsInPixel(QRgb *, queue<int> *, bool *, int, int)
-**  void retrieveBitsFromPixel(queue<int> *, QRgb *, bool *)
+**  void buildBitMask(BitMask *, const bool *, int)
+**  int channelsInFormat(PixelFormat)
+**  int depthInFormat(PixelFormat)
+**  int pixelSizeInFormat(PixelFormat)
+**  void seedMatchingRandom(MatchingRandom *, unsigned long long)
+**  long embedBitsInScanline(unsigned char *, int, PixelFormat, const BitMask *, long,
+**                           const unsigned char *, long, long, MatchingRandom *)
+**  long retrieveBitsFromScanline(const unsigned char *, int, PixelFormat, const BitMask *, long,
+**                                unsigned char *, long, long)
+**  unsigned int getBits(const unsigned char *, long, int)
+**  void putBits(unsigned char *, long, unsigned int, int)
+**  unsigned int depositField(const BitMask *, unsigned int)
+**  unsigned int extractField(const BitMask *, unsigned int)
+**  void getLayout(PixelFormat, SampleLayout *)
+**  unsigned int readSample(const unsigned char *, const SampleLayout *, int, int)
+**  void writeSample(unsigned char *, const SampleLayout *, int, int, unsigned int)
+**  void mergeSamples8(unsigned char *, const unsigned char *, long, const unsigned char *)
+**  void mergeSamples16(unsigned short *, const unsigned short *, long, const unsigned short *)
+**  unsigned int nextRandomBit(MatchingRandom *)
+**  unsigned int matchSample(unsigned int, unsigned int, unsigned int, unsigned int, unsigned int,
+**                           MatchingRandom *)
+**  void matchSamples8(unsigned char *, const unsigned char *, long, const unsigned char *,
+**                     unsigned char, MatchingRandom *)
+**  void matchSamples16(unsigned short *, const unsigned short *, long, const unsigned short *,
+**                      unsigned short, MatchingRandom *)
+**  long readScanlineSamples(const unsigned char *, int, PixelFormat, unsigned short *)
+**  void readTextureLine(const unsigned char *, int, PixelFormat, const BitMask *, unsigned short *)
+**  unsigned int sobelCost(const unsigned short *, const unsigned short *, const unsigned short *,
+**                         int, int)
+**  void markTexturedPixels(const unsigned short *, const unsigned short *, const unsigned short *,
+**                          int, int, unsigned char *)
+**  bool buildSyndromeTable()
+**  unsigned int blockSyndrome(const unsigned char *, long, int)
+**  void matrixEncode(unsigned char *, const unsigned char *, long, int)
+**  void matrixDecode(const unsigned char *, unsigned char *, long, int)
+**  void bitPlaneSamples(const unsigned short *, long, int, unsigned char *)
+**  void differenceSamples(const unsigned short *, const unsigned short *, long, unsigned int,
+**                         unsigned char *)
 **
 **	DATE:        September 23rd, 2016
 **
@@ -18,20 +54,81 @@
 **	NOTES:
 ** All functionality for manipulating the individual pixels
 ** and bits in an image.
+**
+** The carrier is treated as one long run of "slots": pixel by pixel,
+** channel by channel (R, G, B, or just the one channel of grayscale
+** and palette images) and then the enabled bit positions of the
+** channel from highest to lowest. The bits of the secret fill the
+** slots in order, most significant bit of each byte first, and are
+** flipped on the way in for secrecy.
+**
+** Scanlines are worked on directly in their native layout. Whole
+** pixels go through lookup tables that move all the bits of a channel
+** at once, and the results are merged into the scanline with SSE2
+** where it is available.
+**
+** With LSB matching the lowest enabled position of a channel is not
+** overwritten. When it does not already hold the bit of the secret,
+** the channel is moved one step of that position up or down at random
+** (down at the top of its range, up at the bottom), which leaves the
+** same bit behind without the pairs of values that plain replacement
+** gives away. The random steps come from two xorshift128+ generators
+** run side by side in an SSE2 register.
+**
+** For adaptive embedding the texture of each pixel is measured with a
+** Sobel filter over the channels with the enabled bit positions
+** cleared. Embedding never changes those bits, so the retriever finds
+** the same textured pixels in the carrier that the embedder did.
+**
+** Matrix embedding hides k bits of the secret in each block of 2^k
+** slots as the syndrome of a Hamming code: the XOR of the positions
+** of the set bits in the block. At most one slot of the block has to
+** change, where plain embedding changes about half of the slots it
+** writes. Position 0 is left out of the syndrome so that the blocks
+** line up with bytes and a syndrome takes one table lookup per byte.
+**
+** For the viewer, bit planes and differences of the channel values
+** are amplified into bytes that can be shown as pixels.
 *************************************************************************/
-#include <iostream>
-#include <QImage>
-#include <queue>
+#include <cstring>
 #include "imageManipulation.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
+#define CHUNK_PIXELS 256
+
+//where the channels of a pixel live within a scanline
+struct SampleLayout
+{
+    int numChannels;                //channels that hold the secret
+    int samplesPerPixel;            //samples per pixel, including alpha
+    int offsets[NUM_CHANNELS];      //sample of each channel within a pixel
+    int alpha;                      //sample holding alpha, -1 if there is none
+    bool wide;                      //16 bit samples
+};
+
+//byte position of R, G, B and alpha within a native QRgb
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static const int rgb32Offsets[4] = {1, 2, 3, 0};
+#else
+static const int rgb32Offsets[4] = {2, 1, 0, 3};
+#endif
+
+//syndrome of each byte (XOR of the positions of its set bits, most
+//significant first) in the low 3 bits, and its parity in bit 3
+static unsigned char syndromeTable[256];
+static bool buildSyndromeTable();
+static bool syndromeTableBuilt = buildSyndromeTable();
+
 
 /*****************************************************************
-** Function: embedBitsInPixel
+** Function: buildBitMask
 **
-** Date: September 23rd, 2016
+** Date: October 19th, 2026
 **
 ** Revisions:
 **
@@ -41,103 +138,132 @@ using namespace std;
 ** Programmer: Rhea Lauzon
 **
 ** Interface:
-**          int embedBitsInPixel(QRgb *pixel, queue<int> *bits, bool *enabledBits, int numBitsPerChannel, int bitsRemaining)
-**              QRgb *pixel -- The pixel who's RGB channels will be manipulated
-**              queue<int> *bits -- The bits of the secret to be embedded
-**              bool *enabledBits -- The bits in each channel that are available for manipulation
-**              int numBitsPerChannel -- Number of bits that are available per channel
-**              int bitsRemaining -- The number of bits remaining to be used in this pixel
+**          void buildBitMask(BitMask *bitMask, const bool *enabledBits, int depth)
+**              BitMask *bitMask -- Mask to fill in
+**              const bool *enabledBits -- The bits in each channel that are available for manipulation
+**              int depth -- Bits per channel of the carrier (8 or 16)
 **
 **
 ** Returns:
-**			int -- The number of bits that were able to be insert
-**                 into this particular pixel.
+**			void
 **
 ** Notes:
-** Manipulates a pixel based on the bits that are available in each of
-** the three colour channels (RGB). Since the available bits could be
-** half the character 'A' and half the character 'B', we have to keep
-** track of an offset into the bits that have already been filled
-** with data from the secret.
+** Builds the lookup tables for the enabled positions. "Deposit"
+** tables spread the bits of the secret out into the enabled
+** positions of a byte, "extract" tables pull them back together.
 **********************************************************************/
-int embedBitsInPixel(QRgb *pixel, queue<int> *bits, bool *enabledBits, int numBitsPerChannel, int bitsRemaining)
+void buildBitMask(BitMask *bitMask, const bool *enabledBits, int depth)
 {
-    //determine the offset into the bits based off how many bits are remaining in this pixel
-    int offset = numBitsPerChannel * 3 - bitsRemaining;
-    int numBitsConsumed = 0;
-    bool done = false;
-
-    //get all the bits from the various channels
-    QColor tempColor(*pixel);
-    bitset<NUM_BITS> redBits(tempColor.red());
-    bitset<NUM_BITS> greenBits(tempColor.green());
-    bitset<NUM_BITS> blueBits(tempColor.blue());
+    int lowPositions[NUM_BITS];
+    int highPositions[NUM_BITS];
+    int numLow = 0;
+    int numHigh = 0;
 
+    bitMask->depth = depth;
+    bitMask->numBits = 0;
+    bitMask->mask = 0;
 
-    for (int channel = 0; channel < 3; channel++)
+    //collect the enabled positions from highest to lowest
+    for (int pos = depth - 1; pos >= 0; pos--)
     {
-        for (int i = 0; i < NUM_BITS; i++)
+        if (enabledBits[pos])
         {
-            //go to the correct offset before setting bits
-            if (enabledBits[NUM_BITS - i -1])
+            bitMask->positions[bitMask->numBits++] = pos;
+            bitMask->mask |= 1u << pos;
+
+            if (pos >= NUM_BITS)
             {
-                //decrement the offset until we are at the correct enabled bit that we havent used
-                if (offset > 0)
-                {
-                    offset--;
-                    continue;
-                }
+                highPositions[numHigh++] = pos - NUM_BITS;
+            }
+            else
+            {
+                lowPositions[numLow++] = pos;
+            }
+        }
+    }
 
-                //set the bit now that we are at the correct offset
-                //NOTE: for "ecnryption" we flip all the bits
-                if (channel == 0)
-                {
-                    redBits.set(NUM_BITS - i - 1, !((bool)bits->front()));
-                }
-                else if (channel == 1)
-                {
-                    greenBits.set(NUM_BITS - i - 1, !((bool)bits->front()));
-                }
-                else if (channel == 2)
-                {
-                    blueBits.set(NUM_BITS - i - 1, !((bool)bits->front()));
-                }
+    bitMask->numLowBits = numLow;
 
-                //remove the bit from the front
-                bits->pop();
-                numBitsConsumed++;
+    for (int value = 0; value < 256; value++)
+    {
+        bitMask->depositLow[value] = 0;
+        bitMask->depositHigh[value] = 0;
+        bitMask->extractLow[value] = 0;
+        bitMask->extractHigh[value] = 0;
 
-                if (bits->size() == 0)
-                {
-                    done = true;
-                    break;
-                }
+        for (int i = 0; i < numLow; i++)
+        {
+            if (value < (1 << numLow) && ((value >> (numLow - i - 1)) & 1))
+            {
+                bitMask->depositLow[value] |= 1 << lowPositions[i];
             }
+            bitMask->extractLow[value] = (bitMask->extractLow[value] << 1) | ((value >> lowPositions[i]) & 1);
         }
 
-        if (done)
+        for (int i = 0; i < numHigh; i++)
         {
-            break;
+            if (value < (1 << numHigh) && ((value >> (numHigh - i - 1)) & 1))
+            {
+                bitMask->depositHigh[value] |= 1 << highPositions[i];
+            }
+            bitMask->extractHigh[value] = (bitMask->extractHigh[value] << 1) | ((value >> highPositions[i]) & 1);
         }
     }
+}
 
-    //update the pixel with the new data
-    QRgb newPixel;
-    newPixel = qRgb(redBits.to_ulong(), greenBits.to_ulong(), blueBits.to_ulong());
-    *pixel = newPixel;
 
-    //return how many bits we used in the channel
-    return numBitsConsumed;
 
-}
+/*****************************************************************
+** Function: getBits
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int getBits(const unsigned char *data, long bitPos, int count)
+**              const unsigned char *data -- Buffer to read from
+**              long bitPos -- Bit to start at (0 is the top bit of the first byte)
+**              int count -- Number of bits to read (at most 16)
+**
+**
+** Returns:
+**			unsigned int -- The bits, the first one read being the highest
+**
+** Notes:
+** Never reads past the byte holding the last requested bit.
+**********************************************************************/
+static inline unsigned int getBits(const unsigned char *data, long bitPos, int count)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    long first = bitPos >> 3;
+    long last = (bitPos + count - 1) >> 3;
+    unsigned int value = 0;
+
+    for (long i = first; i <= last; i++)
+    {
+        value = (value << 8) | data[i];
+    }
 
+    int unused = (int) (((last + 1) << 3) - (bitPos + count));
+    return (value >> unused) & ((1u << count) - 1);
+}
 
 
 
 /*****************************************************************
-** Function: retrieveBitsFromPixel
+** Function: putBits
 **
-** Date: October 3rd, 2016
+** Date: October 19th, 2026
 **
 ** Revisions:
 **
@@ -147,54 +273,1564 @@ int embedBitsInPixel(QRgb *pixel, queue<int> *bits, bool *enabledBits, int numBi
 ** Programmer: Rhea Lauzon
 **
 ** Interface:
-**      void retrieveBitsFromPixel(queue<int> *bitsRetrieved, QRgb *pixel, bool *enabledBits)
-**          queue<int> *bitsRetrieved -- Pointer to a queue that contains the bits retrieved from the RGB channel
-**          QRgb *pixel -- The pixel we are fetching data from
-**          bool *enabledBits -- Pointer that contains the positions in a channel that we are using
-**
+**          void putBits(unsigned char *data, long bitPos, unsigned int value, int count)
+**              unsigned char *data -- Buffer to write to
+**              long bitPos -- Bit to start at (0 is the top bit of the first byte)
+**              unsigned int value -- Bits to write, the highest is written first
+**              int count -- Number of bits to write (at most 16)
 **
 **
 ** Returns:
 **			void
 **
 ** Notes:
-** Retrieves bits from the 3 colour channels (RGB) based off the
-** bit positions specified.
+** Bits around the written range are left alone.
 **********************************************************************/
-void retrieveBitsFromPixel(queue<int> *bitsRetrieved, QRgb *pixel, bool *enabledBits)
+static inline void putBits(unsigned char *data, long bitPos, unsigned int value, int count)
 {
-    //get all the bits from the RGB channel
-    QColor tempColor(*pixel);
-    bitset<NUM_BITS> redBits(tempColor.red());
-    bitset<NUM_BITS> greenBits(tempColor.green());
-    bitset<NUM_BITS> blueBits(tempColor.blue());
+    for (int i = 0; i < count; i++)
+    {
+        long pos = bitPos + i;
+        unsigned char bit = (unsigned char) (0x80 >> (pos & 7));
+
+        if ((value >> (count - i - 1)) & 1)
+        {
+            data[pos >> 3] |= bit;
+        }
+        else
+        {
+            data[pos >> 3] &= ~bit;
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: depositField
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int depositField(const BitMask *bitMask, unsigned int field)
+**              const BitMask *bitMask -- Enabled positions
+**              unsigned int field -- One channel's worth of secret bits
+**
+**
+** Returns:
+**			unsigned int -- The bits spread out into the enabled positions
+**********************************************************************/
+static inline unsigned int depositField(const BitMask *bitMask, unsigned int field)
+{
+    return ((unsigned int) bitMask->depositHigh[field >> bitMask->numLowBits] << NUM_BITS)
+           | bitMask->depositLow[field & ((1u << bitMask->numLowBits) - 1)];
+}
+
+
+
+/*****************************************************************
+** Function: extractField
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int extractField(const BitMask *bitMask, unsigned int sample)
+**              const BitMask *bitMask -- Enabled positions
+**              unsigned int sample -- Value of a channel
+**
+**
+** Returns:
+**			unsigned int -- The bits in the enabled positions packed together
+**********************************************************************/
+static inline unsigned int extractField(const BitMask *bitMask, unsigned int sample)
+{
+    return ((unsigned int) bitMask->extractHigh[(sample >> NUM_BITS) & 0xFF] << bitMask->numLowBits)
+           | bitMask->extractLow[sample & 0xFF];
+}
 
-    //go through each channel and pull the bits out of the specific positions
-    for (int channelNum = 0; channelNum < 3; channelNum++)
+
+
+/*****************************************************************
+** Function: getLayout
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void getLayout(PixelFormat format, SampleLayout *layout)
+**              PixelFormat format -- Layout of the scanline
+**              SampleLayout *layout -- Filled in with where each channel lives
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+static void getLayout(PixelFormat format, SampleLayout *layout)
+{
+    switch (format)
     {
-        //NOTE:: We flip all the bits because the original bits were flipped
-        //for secrecy
-        for (int bitPos = 0; bitPos < NUM_BITS; bitPos++)
+        default:
+        case FORMAT_RGB32:
         {
-            if (enabledBits[NUM_BITS - bitPos - 1])
-            {
-                if (channelNum == 0)
-                {
-                    //fetch the bit from the red channel
-                    bitsRetrieved->push(!redBits[NUM_BITS - bitPos - 1]);
-                }
-                else if (channelNum == 1)
-                {
-                    //fetch the bit from the green channel
-                    bitsRetrieved->push(!greenBits[NUM_BITS - bitPos - 1]);
-                }
-                else if (channelNum == 2)
-                {
-                    //fetch the bit from the blue channel
-                    bitsRetrieved->push(!blueBits[NUM_BITS - bitPos - 1]);
-                }
+            layout->numChannels = NUM_CHANNELS;
+            layout->samplesPerPixel = 4;
+            layout->offsets[0] = rgb32Offsets[0];
+            layout->offsets[1] = rgb32Offsets[1];
+            layout->offsets[2] = rgb32Offsets[2];
+            layout->alpha = rgb32Offsets[3];
+            layout->wide = false;
+        }
+        break;
 
-            }
+        case FORMAT_RGBA64:
+        {
+            layout->numChannels = NUM_CHANNELS;
+            layout->samplesPerPixel = 4;
+            layout->offsets[0] = 0;
+            layout->offsets[1] = 1;
+            layout->offsets[2] = 2;
+            layout->alpha = 3;
+            layout->wide = true;
+        }
+        break;
+
+        case FORMAT_GRAY8:
+        case FORMAT_GRAY16:
+        case FORMAT_INDEXED8:
+        {
+            layout->numChannels = 1;
+            layout->samplesPerPixel = 1;
+            layout->offsets[0] = 0;
+            layout->alpha = -1;
+            layout->wide = (format == FORMAT_GRAY16);
         }
+        break;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: channelsInFormat
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int channelsInFormat(PixelFormat format)
+**              PixelFormat format -- Layout of the scanline
+**
+**
+** Returns:
+**			int -- Number of channels of each pixel that hold the secret
+**********************************************************************/
+int channelsInFormat(PixelFormat format)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    return layout.numChannels;
+}
+
+
+
+/*****************************************************************
+** Function: depthInFormat
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int depthInFormat(PixelFormat format)
+**              PixelFormat format -- Layout of the scanline
+**
+**
+** Returns:
+**			int -- Bits per channel (8 or 16)
+**********************************************************************/
+int depthInFormat(PixelFormat format)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    return layout.wide ? MAX_NUM_BITS : NUM_BITS;
+}
+
+
+
+/*****************************************************************
+** Function: pixelSizeInFormat
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int pixelSizeInFormat(PixelFormat format)
+**              PixelFormat format -- Layout of the scanline
+**
+**
+** Returns:
+**			int -- Bytes per pixel, including alpha
+**********************************************************************/
+int pixelSizeInFormat(PixelFormat format)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    return layout.samplesPerPixel * (layout.wide ? 2 : 1);
+}
+
+
+
+/*****************************************************************
+** Function: readSample
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int readSample(const unsigned char *line, const SampleLayout *layout, int pixel, int channel)
+**              const unsigned char *line -- Scanline
+**              const SampleLayout *layout -- Layout of the scanline
+**              int pixel -- Pixel within the scanline
+**              int channel -- Channel of the pixel
+**
+**
+** Returns:
+**			unsigned int -- Value of the channel
+**********************************************************************/
+static inline unsigned int readSample(const unsigned char *line, const SampleLayout *layout, int pixel, int channel)
+{
+    long index = (long) pixel * layout->samplesPerPixel + layout->offsets[channel];
+
+    if (layout->wide)
+    {
+        return ((const unsigned short *) line)[index];
+    }
+
+    return line[index];
+}
+
+
+
+/*****************************************************************
+** Function: writeSample
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void writeSample(unsigned char *line, const SampleLayout *layout, int pixel, int channel, unsigned int value)
+**              unsigned char *line -- Scanline
+**              const SampleLayout *layout -- Layout of the scanline
+**              int pixel -- Pixel within the scanline
+**              int channel -- Channel of the pixel
+**              unsigned int value -- New value of the channel
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+static inline void writeSample(unsigned char *line, const SampleLayout *layout, int pixel, int channel, unsigned int value)
+{
+    long index = (long) pixel * layout->samplesPerPixel + layout->offsets[channel];
+
+    if (layout->wide)
+    {
+        ((unsigned short *) line)[index] = (unsigned short) value;
+    }
+    else
+    {
+        line[index] = (unsigned char) value;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: mergeSamples8
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void mergeSamples8(unsigned char *line, const unsigned char *deposit, long count, const unsigned char *keep)
+**              unsigned char *line -- Samples to update
+**              const unsigned char *deposit -- Secret bits already in position
+**              long count -- Number of samples (whole pixels)
+**              const unsigned char *keep -- 16 byte pattern of the bits to keep
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Clears the enabled positions of every sample and ORs the secret in,
+** 16 samples at a time.
+**********************************************************************/
+static void mergeSamples8(unsigned char *line, const unsigned char *deposit, long count, const unsigned char *keep)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i keepBits = _mm_loadu_si128((const __m128i *) keep);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i *) (line + i));
+        __m128i secret = _mm_loadu_si128((const __m128i *) (deposit + i));
+        _mm_storeu_si128((__m128i *) (line + i), _mm_or_si128(_mm_and_si128(samples, keepBits), secret));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        line[i] = (line[i] & keep[i & 15]) | deposit[i];
+    }
+}
+
+
+
+/*****************************************************************
+** Function: mergeSamples16
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void mergeSamples16(unsigned short *line, const unsigned short *deposit, long count, const unsigned short *keep)
+**              unsigned short *line -- Samples to update
+**              const unsigned short *deposit -- Secret bits already in position
+**              long count -- Number of samples (whole pixels)
+**              const unsigned short *keep -- 8 sample pattern of the bits to keep
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Same as mergeSamples8 but on 16 bit lanes, 8 samples at a time.
+**********************************************************************/
+static void mergeSamples16(unsigned short *line, const unsigned short *deposit, long count, const unsigned short *keep)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i keepBits = _mm_loadu_si128((const __m128i *) keep);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i *) (line + i));
+        __m128i secret = _mm_loadu_si128((const __m128i *) (deposit + i));
+        _mm_storeu_si128((__m128i *) (line + i), _mm_or_si128(_mm_and_si128(samples, keepBits), secret));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        line[i] = (line[i] & keep[i & 7]) | deposit[i];
+    }
+}
+
+
+
+/*****************************************************************
+** Function: seedMatchingRandom
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void seedMatchingRandom(MatchingRandom *random, unsigned long long seed)
+**              MatchingRandom *random -- Generator to seed
+**              unsigned long long seed -- Any value
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Spreads the seed over the state with splitmix64, which never leaves
+** a generator all zero.
+**********************************************************************/
+void seedMatchingRandom(MatchingRandom *random, unsigned long long seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        seed += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        random->state[i] = z ^ (z >> 31);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: nextRandomBit
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int nextRandomBit(MatchingRandom *random)
+**              MatchingRandom *random -- Generator to step
+**
+**
+** Returns:
+**			unsigned int -- 0 or 1
+**
+** Notes:
+** Steps the first of the two generators on its own, for the samples
+** that are not done in a whole register.
+**********************************************************************/
+static inline unsigned int nextRandomBit(MatchingRandom *random)
+{
+    unsigned long long s1 = random->state[0];
+    unsigned long long s0 = random->state[2];
+    random->state[0] = s0;
+    s1 ^= s1 << 23;
+    random->state[2] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+
+    return (unsigned int) ((random->state[2] + s0) >> 63);
+}
+
+
+
+/*****************************************************************
+** Function: matchSample
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int matchSample(unsigned int sample, unsigned int keep, unsigned int deposit,
+**                                   unsigned int step, unsigned int maxSample, MatchingRandom *random)
+**              unsigned int sample -- Channel value
+**              unsigned int keep -- Bits of the channel that are not written
+**              unsigned int deposit -- Bits to write, already in position
+**              unsigned int step -- Lowest enabled position as a value
+**              unsigned int maxSample -- Largest value of a channel
+**              MatchingRandom *random -- Picks up or down
+**
+**
+** Returns:
+**			unsigned int -- The new channel value
+**********************************************************************/
+static inline unsigned int matchSample(unsigned int sample, unsigned int keep, unsigned int deposit,
+                                       unsigned int step, unsigned int maxSample, MatchingRandom *random)
+{
+    unsigned int replaced = (sample & keep) | deposit;
+    if (((sample ^ replaced) & step) == 0)
+    {
+        return replaced;
+    }
+
+    bool canAdd = (sample + step <= maxSample);
+    bool canSubtract = (sample >= step);
+    bool add = canAdd && (!canSubtract || nextRandomBit(random));
+    unsigned int moved = add ? sample + step : sample - step;
+
+    return (moved & keep) | deposit;
+}
+
+
+
+/*****************************************************************
+** Function: matchSamples8
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void matchSamples8(unsigned char *line, const unsigned char *deposit, long count,
+**                             const unsigned char *keep, unsigned char step, MatchingRandom *random)
+**              unsigned char *line -- Samples to update
+**              const unsigned char *deposit -- Secret bits already in position
+**              long count -- Number of samples (whole pixels)
+**              const unsigned char *keep -- 16 byte pattern of the bits to keep
+**              unsigned char step -- Lowest enabled position as a value
+**              MatchingRandom *random -- Picks up or down
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** The LSB matching version of mergeSamples8. Each 16 samples take one
+** step of both generators, the top bit of each random byte picking the
+** direction of its sample.
+**********************************************************************/
+static void matchSamples8(unsigned char *line, const unsigned char *deposit, long count,
+                          const unsigned char *keep, unsigned char step, MatchingRandom *random)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i keepBits = _mm_loadu_si128((const __m128i *) keep);
+    __m128i steps = _mm_set1_epi8((char) step);
+    __m128i highest = _mm_set1_epi8((char) (0xFF - step));
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = _mm_loadu_si128((const __m128i *) random->state);
+    __m128i b = _mm_loadu_si128((const __m128i *) (random->state + 2));
+
+    for (; i + 16 <= count; i += 16)
+    {
+        //xorshift128+ in both 64 bit lanes
+        __m128i s1 = a;
+        __m128i s0 = b;
+        a = s0;
+        s1 = _mm_xor_si128(s1, _mm_slli_epi64(s1, 23));
+        b = _mm_xor_si128(_mm_xor_si128(s1, s0), _mm_xor_si128(_mm_srli_epi64(s1, 17), _mm_srli_epi64(s0, 26)));
+        __m128i up = _mm_cmplt_epi8(_mm_add_epi64(b, s0), zero);
+
+        __m128i samples = _mm_loadu_si128((const __m128i *) (line + i));
+        __m128i secret = _mm_loadu_si128((const __m128i *) (deposit + i));
+        __m128i replaced = _mm_or_si128(_mm_and_si128(samples, keepBits), secret);
+        __m128i mismatched = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(samples, replaced), steps), steps);
+
+        //up unless at the top, down unless at the bottom
+        __m128i canAdd = _mm_cmpeq_epi8(_mm_subs_epu8(samples, highest), zero);
+        __m128i canSubtract = _mm_cmpeq_epi8(_mm_subs_epu8(steps, samples), zero);
+        __m128i add = _mm_and_si128(canAdd, _mm_or_si128(up, _mm_andnot_si128(canSubtract, _mm_set1_epi8(-1))));
+        __m128i moved = _mm_or_si128(_mm_and_si128(add, _mm_add_epi8(samples, steps)),
+                                     _mm_andnot_si128(add, _mm_sub_epi8(samples, steps)));
+
+        __m128i chosen = _mm_or_si128(_mm_and_si128(mismatched, moved), _mm_andnot_si128(mismatched, samples));
+        _mm_storeu_si128((__m128i *) (line + i), _mm_or_si128(_mm_and_si128(chosen, keepBits), secret));
+    }
+
+    _mm_storeu_si128((__m128i *) random->state, a);
+    _mm_storeu_si128((__m128i *) (random->state + 2), b);
+#endif
+
+    for (; i < count; i++)
+    {
+        line[i] = (unsigned char) matchSample(line[i], keep[i & 15], deposit[i], step, 0xFF, random);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: matchSamples16
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void matchSamples16(unsigned short *line, const unsigned short *deposit, long count,
+**                              const unsigned short *keep, unsigned short step, MatchingRandom *random)
+**              unsigned short *line -- Samples to update
+**              const unsigned short *deposit -- Secret bits already in position
+**              long count -- Number of samples (whole pixels)
+**              const unsigned short *keep -- 8 sample pattern of the bits to keep
+**              unsigned short step -- Lowest enabled position as a value
+**              MatchingRandom *random -- Picks up or down
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Same as matchSamples8 but on 16 bit lanes, 8 samples at a time.
+**********************************************************************/
+static void matchSamples16(unsigned short *line, const unsigned short *deposit, long count,
+                           const unsigned short *keep, unsigned short step, MatchingRandom *random)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i keepBits = _mm_loadu_si128((const __m128i *) keep);
+    __m128i steps = _mm_set1_epi16((short) step);
+    __m128i highest = _mm_set1_epi16((short) (0xFFFF - step));
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = _mm_loadu_si128((const __m128i *) random->state);
+    __m128i b = _mm_loadu_si128((const __m128i *) (random->state + 2));
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i s1 = a;
+        __m128i s0 = b;
+        a = s0;
+        s1 = _mm_xor_si128(s1, _mm_slli_epi64(s1, 23));
+        b = _mm_xor_si128(_mm_xor_si128(s1, s0), _mm_xor_si128(_mm_srli_epi64(s1, 17), _mm_srli_epi64(s0, 26)));
+        __m128i up = _mm_cmplt_epi16(_mm_add_epi64(b, s0), zero);
+
+        __m128i samples = _mm_loadu_si128((const __m128i *) (line + i));
+        __m128i secret = _mm_loadu_si128((const __m128i *) (deposit + i));
+        __m128i replaced = _mm_or_si128(_mm_and_si128(samples, keepBits), secret);
+        __m128i mismatched = _mm_cmpeq_epi16(_mm_and_si128(_mm_xor_si128(samples, replaced), steps), steps);
+
+        __m128i canAdd = _mm_cmpeq_epi16(_mm_subs_epu16(samples, highest), zero);
+        __m128i canSubtract = _mm_cmpeq_epi16(_mm_subs_epu16(steps, samples), zero);
+        __m128i add = _mm_and_si128(canAdd, _mm_or_si128(up, _mm_andnot_si128(canSubtract, _mm_set1_epi16(-1))));
+        __m128i moved = _mm_or_si128(_mm_and_si128(add, _mm_add_epi16(samples, steps)),
+                                     _mm_andnot_si128(add, _mm_sub_epi16(samples, steps)));
+
+        __m128i chosen = _mm_or_si128(_mm_and_si128(mismatched, moved), _mm_andnot_si128(mismatched, samples));
+        _mm_storeu_si128((__m128i *) (line + i), _mm_or_si128(_mm_and_si128(chosen, keepBits), secret));
+    }
+
+    _mm_storeu_si128((__m128i *) random->state, a);
+    _mm_storeu_si128((__m128i *) (random->state + 2), b);
+#endif
+
+    for (; i < count; i++)
+    {
+        line[i] = (unsigned short) matchSample(line[i], keep[i & 7], deposit[i], step, 0xFFFF, random);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: embedBitsInScanline
+**
+** Date: September 23rd, 2016
+**
+** Revisions:
+** October 19th, 2026 - Works on whole scanlines of 8 or 16 bit channels
+**                      instead of one QRgb at a time
+** October 19th, 2026 - Grayscale and palette scanlines in their native layout
+** October 19th, 2026 - Can embed by LSB matching
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long embedBitsInScanline(unsigned char *line, int width, PixelFormat format, const BitMask *bitMask,
+**                                   long slot, const unsigned char *data, long dataBit, long numBits,
+**                                   MatchingRandom *random)
+**              unsigned char *line -- The scanline who's channels will be manipulated
+**              int width -- Number of pixels in the scanline
+**              PixelFormat format -- Layout of the scanline
+**              const BitMask *bitMask -- The bits in each channel that are available for manipulation
+**              long slot -- First slot of the scanline to fill
+**              const unsigned char *data -- The bits of the secret to be embedded
+**              long dataBit -- First bit of data to embed
+**              long numBits -- Number of bits of data to embed
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			long -- The number of bits that were able to be inserted
+**                  into this particular scanline.
+**
+** Notes:
+** Since a slot range can start or end part way through a pixel (half
+** the character 'A' and half the character 'B'), the partial pixels
+** at either end are filled one bit at a time. Every whole pixel in
+** between has its channels deposited through the lookup tables into
+** a small buffer which is then merged into the scanline. The lowest
+** position of a channel is always filled last, after the others of
+** the channel hold their final bits, so LSB matching can move the
+** whole channel then.
+**********************************************************************/
+long embedBitsInScanline(unsigned char *line, int width, PixelFormat format, const BitMask *bitMask,
+                         long slot, const unsigned char *data, long dataBit, long numBits, MatchingRandom *random)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    int bitsPerPixel = bitMask->numBits * layout.numChannels;
+    if (bitsPerPixel == 0)
+    {
+        return 0;
+    }
+
+    long slotsInLine = (long) width * bitsPerPixel;
+    if (slot >= slotsInLine)
+    {
+        return 0;
+    }
+
+    long total = numBits;
+    if (total > slotsInLine - slot)
+    {
+        total = slotsInLine - slot;
+    }
+
+    long done = 0;
+    unsigned int invert = (1u << bitMask->numBits) - 1;
+    int spp = layout.samplesPerPixel;
+    int lowest = bitMask->positions[bitMask->numBits - 1];
+    unsigned int maxSample = layout.wide ? 0xFFFF : 0xFF;
+
+    //fill one bit at a time until we reach the start of a pixel
+    while (done < total && (slot + done) % bitsPerPixel != 0)
+    {
+        long current = slot + done;
+        int pixel = (int) (current / bitsPerPixel);
+        int channel = (int) ((current % bitsPerPixel) / bitMask->numBits);
+        int pos = bitMask->positions[current % bitMask->numBits];
+
+        //NOTE: for "encryption" we flip all the bits
+        unsigned int sample = readSample(line, &layout, pixel, channel);
+        unsigned int bit = (!getBits(data, dataBit + done, 1)) << pos;
+        if (random != NULL && pos == lowest)
+        {
+            sample = matchSample(sample, ~bitMask->mask, (sample & bitMask->mask & ~(1u << pos)) | bit,
+                                 1u << pos, maxSample, random);
+        }
+        else
+        {
+            sample = (sample & ~(1u << pos)) | bit;
+        }
+        writeSample(line, &layout, pixel, channel, sample);
+
+        done++;
+    }
+
+    //whole pixels through the lookup tables, a chunk at a time
+    int pixel = (int) ((slot + done) / bitsPerPixel);
+    long wholePixels = (total - done) / bitsPerPixel;
+
+    if (layout.wide)
+    {
+        unsigned short deposit[CHUNK_PIXELS * 4];
+        unsigned short keep[8];
+        for (int i = 0; i < 8; i++)
+        {
+            keep[i] = (i % spp == layout.alpha) ? 0xFFFF : (unsigned short) ~bitMask->mask;
+        }
+
+        while (wholePixels > 0)
+        {
+            int count = (wholePixels < CHUNK_PIXELS) ? (int) wholePixels : CHUNK_PIXELS;
+
+            for (int p = 0; p < count; p++)
+            {
+                for (int channel = 0; channel < layout.numChannels; channel++)
+                {
+                    unsigned int field = getBits(data, dataBit + done, bitMask->numBits) ^ invert;
+                    deposit[p * spp + layout.offsets[channel]] = (unsigned short) depositField(bitMask, field);
+                    done += bitMask->numBits;
+                }
+
+                if (layout.alpha != -1)
+                {
+                    deposit[p * spp + layout.alpha] = 0;
+                }
+            }
+
+            if (random != NULL)
+            {
+                matchSamples16(((unsigned short *) line) + (long) pixel * spp, deposit, (long) count * spp, keep,
+                               (unsigned short) (1u << lowest), random);
+            }
+            else
+            {
+                mergeSamples16(((unsigned short *) line) + (long) pixel * spp, deposit, (long) count * spp, keep);
+            }
+            pixel += count;
+            wholePixels -= count;
+        }
+    }
+    else
+    {
+        unsigned char deposit[CHUNK_PIXELS * 4];
+        unsigned char keep[16];
+        for (int i = 0; i < 16; i++)
+        {
+            keep[i] = (i % spp == layout.alpha) ? 0xFF : (unsigned char) ~bitMask->mask;
+        }
+
+        while (wholePixels > 0)
+        {
+            int count = (wholePixels < CHUNK_PIXELS) ? (int) wholePixels : CHUNK_PIXELS;
+
+            for (int p = 0; p < count; p++)
+            {
+                for (int channel = 0; channel < layout.numChannels; channel++)
+                {
+                    unsigned int field = getBits(data, dataBit + done, bitMask->numBits) ^ invert;
+                    deposit[p * spp + layout.offsets[channel]] = (unsigned char) depositField(bitMask, field);
+                    done += bitMask->numBits;
+                }
+
+                if (layout.alpha != -1)
+                {
+                    deposit[p * spp + layout.alpha] = 0;
+                }
+            }
+
+            if (random != NULL)
+            {
+                matchSamples8(line + (long) pixel * spp, deposit, (long) count * spp, keep,
+                              (unsigned char) (1u << lowest), random);
+            }
+            else
+            {
+                mergeSamples8(line + (long) pixel * spp, deposit, (long) count * spp, keep);
+            }
+            pixel += count;
+            wholePixels -= count;
+        }
+    }
+
+    //fill whatever is left of the last (partial) pixel
+    while (done < total)
+    {
+        long current = slot + done;
+        int channel = (int) ((current % bitsPerPixel) / bitMask->numBits);
+        int pos = bitMask->positions[current % bitMask->numBits];
+
+        unsigned int sample = readSample(line, &layout, pixel, channel);
+        unsigned int bit = (!getBits(data, dataBit + done, 1)) << pos;
+        if (random != NULL && pos == lowest)
+        {
+            sample = matchSample(sample, ~bitMask->mask, (sample & bitMask->mask & ~(1u << pos)) | bit,
+                                 1u << pos, maxSample, random);
+        }
+        else
+        {
+            sample = (sample & ~(1u << pos)) | bit;
+        }
+        writeSample(line, &layout, pixel, channel, sample);
+
+        done++;
+    }
+
+    //return how many bits we used in the scanline
+    return done;
+}
+
+
+
+
+/*****************************************************************
+** Function: retrieveBitsFromScanline
+**
+** Date: October 3rd, 2016
+**
+** Revisions:
+** October 19th, 2026 - Works on whole scanlines of 8 or 16 bit channels
+**                      instead of one QRgb at a time
+** October 19th, 2026 - Grayscale and palette scanlines in their native layout
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**      long retrieveBitsFromScanline(const unsigned char *line, int width, PixelFormat format, const BitMask *bitMask,
+**                                    long slot, unsigned char *data, long dataBit, long numBits)
+**          const unsigned char *line -- The scanline we are fetching data from
+**          int width -- Number of pixels in the scanline
+**          PixelFormat format -- Layout of the scanline
+**          const BitMask *bitMask -- The positions in a channel that we are using
+**          long slot -- First slot of the scanline to read
+**          unsigned char *data -- Buffer that receives the bits retrieved
+**          long dataBit -- First bit of data to write
+**          long numBits -- Number of bits wanted
+**
+**
+**
+** Returns:
+**			long -- The number of bits retrieved from this scanline
+**
+** Notes:
+** Retrieves bits from the colour channels (RGB, or the single
+** grayscale or palette channel) based off the bit positions specified. Whole channels are read with one table
+** lookup per byte of the channel.
+**********************************************************************/
+long retrieveBitsFromScanline(const unsigned char *line, int width, PixelFormat format, const BitMask *bitMask,
+                              long slot, unsigned char *data, long dataBit, long numBits)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    int bitsPerPixel = bitMask->numBits * layout.numChannels;
+    if (bitsPerPixel == 0)
+    {
+        return 0;
+    }
+
+    long slotsInLine = (long) width * bitsPerPixel;
+    if (slot >= slotsInLine)
+    {
+        return 0;
+    }
+
+    long total = numBits;
+    if (total > slotsInLine - slot)
+    {
+        total = slotsInLine - slot;
+    }
+
+    long done = 0;
+    unsigned int invert = (1u << bitMask->numBits) - 1;
+
+    //NOTE:: We flip all the bits because the original bits were flipped
+    //for secrecy
+    while (done < total)
+    {
+        long current = slot + done;
+        int pixel = (int) (current / bitsPerPixel);
+        int channel = (int) ((current % bitsPerPixel) / bitMask->numBits);
+        int index = (int) (current % bitMask->numBits);
+
+        unsigned int sample = readSample(line, &layout, pixel, channel);
+
+        if (index == 0 && total - done >= bitMask->numBits)
+        {
+            //the whole channel in one go
+            putBits(data, dataBit + done, extractField(bitMask, sample) ^ invert, bitMask->numBits);
+            done += bitMask->numBits;
+        }
+        else
+        {
+            putBits(data, dataBit + done, !((sample >> bitMask->positions[index]) & 1), 1);
+            done++;
+        }
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: readScanlineSamples
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readScanlineSamples(const unsigned char *line, int width, PixelFormat format,
+**                                   unsigned short *samples)
+**              const unsigned char *line -- Scanline
+**              int width -- Number of pixels in the scanline
+**              PixelFormat format -- Layout of the scanline
+**              unsigned short *samples -- Receives the channel values
+**
+**
+** Returns:
+**			long -- Number of channel values read
+**
+** Notes:
+** Copies the channels that hold the secret out of a scanline in slot
+** order, so they can be tested against many bit masks without going
+** back to the image.
+**********************************************************************/
+long readScanlineSamples(const unsigned char *line, int width, PixelFormat format, unsigned short *samples)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    long count = 0;
+    for (int pixel = 0; pixel < width; pixel++)
+    {
+        for (int channel = 0; channel < layout.numChannels; channel++)
+        {
+            samples[count++] = (unsigned short) readSample(line, &layout, pixel, channel);
+        }
+    }
+
+    return count;
+}
+
+
+
+/*****************************************************************
+** Function: readTextureLine
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void readTextureLine(const unsigned char *line, int width, PixelFormat format,
+**                               const BitMask *bitMask, unsigned short *texture)
+**              const unsigned char *line -- Scanline
+**              int width -- Number of pixels in the scanline
+**              PixelFormat format -- Layout of the scanline
+**              const BitMask *bitMask -- Positions to leave out
+**              unsigned short *texture -- Receives one value per pixel
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Sums the channels of each pixel, scaled to 8 bits, with the enabled
+** positions cleared. Single channel pixels count three times so the
+** same threshold suits colour and grayscale carriers (0 to 765).
+**********************************************************************/
+void readTextureLine(const unsigned char *line, int width, PixelFormat format,
+                     const BitMask *bitMask, unsigned short *texture)
+{
+    SampleLayout layout;
+    getLayout(format, &layout);
+
+    unsigned int keep = ~bitMask->mask;
+
+    if (format == FORMAT_RGB32)
+    {
+        for (int pixel = 0; pixel < width; pixel++)
+        {
+            const unsigned char *samples = line + (long) pixel * 4;
+            texture[pixel] = (unsigned short) ((samples[rgb32Offsets[0]] & keep) + (samples[rgb32Offsets[1]] & keep)
+                                               + (samples[rgb32Offsets[2]] & keep));
+        }
+        return;
+    }
+
+    int shift = layout.wide ? NUM_BITS : 0;
+    int scale = NUM_CHANNELS / layout.numChannels;
+    for (int pixel = 0; pixel < width; pixel++)
+    {
+        unsigned int sum = 0;
+        for (int channel = 0; channel < layout.numChannels; channel++)
+        {
+            sum += (readSample(line, &layout, pixel, channel) & keep) >> shift;
+        }
+        texture[pixel] = (unsigned short) (sum * scale);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: sobelCost
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int sobelCost(const unsigned short *above, const unsigned short *line,
+**                                 const unsigned short *below, int width, int x)
+**              const unsigned short *above -- Texture of the row above
+**              const unsigned short *line -- Texture of the row
+**              const unsigned short *below -- Texture of the row below
+**              int width -- Number of pixels in a row
+**              int x -- Pixel to work out
+**
+**
+** Returns:
+**			unsigned int -- |Gx| + |Gy| of the pixel
+**
+** Notes:
+** Used for the pixels the vector loop does not cover.
+**********************************************************************/
+static inline unsigned int sobelCost(const unsigned short *above, const unsigned short *line,
+                                     const unsigned short *below, int width, int x)
+{
+    int left = (x > 0) ? x - 1 : 0;
+    int right = (x < width - 1) ? x + 1 : width - 1;
+
+    int gx = (above[right] + 2 * line[right] + below[right]) - (above[left] + 2 * line[left] + below[left]);
+    int gy = (below[left] + 2 * below[x] + below[right]) - (above[left] + 2 * above[x] + above[right]);
+
+    return (unsigned int) ((gx < 0 ? -gx : gx) + (gy < 0 ? -gy : gy));
+}
+
+
+
+/*****************************************************************
+** Function: markTexturedPixels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void markTexturedPixels(const unsigned short *above, const unsigned short *line,
+**                                  const unsigned short *below, int width, int threshold,
+**                                  unsigned char *marks)
+**              const unsigned short *above -- Texture of the row above
+**              const unsigned short *line -- Texture of the row
+**              const unsigned short *below -- Texture of the row below
+**              int width -- Number of pixels in a row
+**              int threshold -- Lowest cost that is marked
+**              unsigned char *marks -- Set to 1 for each pixel marked, 0 otherwise
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** The cost of a pixel is |Gx| + |Gy| of the 3x3 Sobel filter, with
+** the edges of the image repeated. The inside of the row is done eight
+** pixels at a time with SSE2 where it is available; the largest cost
+** (2 * 4 * 765) still fits in a signed 16 bit lane.
+**********************************************************************/
+void markTexturedPixels(const unsigned short *above, const unsigned short *line,
+                        const unsigned short *below, int width, int threshold, unsigned char *marks)
+{
+    int x = 0;
+    if (width > 0)
+    {
+        marks[0] = sobelCost(above, line, below, width, 0) >= (unsigned int) threshold;
+        x = 1;
+    }
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i limit = _mm_set1_epi16((short) (threshold - 1));
+    __m128i one = _mm_set1_epi8(1);
+
+    for (; x + 9 <= width; x += 8)
+    {
+        __m128i aLeft = _mm_loadu_si128((const __m128i *) (above + x - 1));
+        __m128i aMid = _mm_loadu_si128((const __m128i *) (above + x));
+        __m128i aRight = _mm_loadu_si128((const __m128i *) (above + x + 1));
+        __m128i lLeft = _mm_loadu_si128((const __m128i *) (line + x - 1));
+        __m128i lRight = _mm_loadu_si128((const __m128i *) (line + x + 1));
+        __m128i bLeft = _mm_loadu_si128((const __m128i *) (below + x - 1));
+        __m128i bMid = _mm_loadu_si128((const __m128i *) (below + x));
+        __m128i bRight = _mm_loadu_si128((const __m128i *) (below + x + 1));
+
+        //right column minus left column, bottom row minus top row
+        __m128i gx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(aRight, bRight), _mm_add_epi16(lRight, lRight)),
+                                   _mm_add_epi16(_mm_add_epi16(aLeft, bLeft), _mm_add_epi16(lLeft, lLeft)));
+        __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(bLeft, bRight), _mm_add_epi16(bMid, bMid)),
+                                   _mm_add_epi16(_mm_add_epi16(aLeft, aRight), _mm_add_epi16(aMid, aMid)));
+
+        __m128i cost = _mm_add_epi16(_mm_max_epi16(gx, _mm_sub_epi16(zero, gx)),
+                                     _mm_max_epi16(gy, _mm_sub_epi16(zero, gy)));
+        __m128i marked = _mm_packs_epi16(_mm_cmpgt_epi16(cost, limit), zero);
+        _mm_storel_epi64((__m128i *) (marks + x), _mm_and_si128(marked, one));
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        marks[x] = sobelCost(above, line, below, width, x) >= (unsigned int) threshold;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: buildSyndromeTable
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool buildSyndromeTable()
+**
+**
+** Returns:
+**			bool -- Always true, the table is built when the program loads
+**********************************************************************/
+static bool buildSyndromeTable()
+{
+    for (int value = 0; value < 256; value++)
+    {
+        unsigned char syndrome = 0;
+        unsigned char parity = 0;
+        for (int pos = 0; pos < 8; pos++)
+        {
+            if (value & (0x80 >> pos))
+            {
+                syndrome ^= (unsigned char) pos;
+                parity ^= 1;
+            }
+        }
+        syndromeTable[value] = (unsigned char) (syndrome | (parity << 3));
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: blockSyndrome
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int blockSyndrome(const unsigned char *cover, long block, int k)
+**              const unsigned char *cover -- Bits of the slots, most significant first
+**              long block -- Block to work out
+**              int k -- Bits of the secret per block
+**
+**
+** Returns:
+**			unsigned int -- XOR of the positions of the set bits in the block
+**
+** Notes:
+** A byte at offset o of the block adds 8o for each of its set bits,
+** which comes down to 8o when its parity is odd.
+**********************************************************************/
+static inline unsigned int blockSyndrome(const unsigned char *cover, long block, int k)
+{
+    //two blocks of 4 bits share each byte
+    if (k == 2)
+    {
+        unsigned char value = cover[block >> 1];
+        value = (block & 1) ? (unsigned char) (value << 4) : (unsigned char) (value & 0xF0);
+        return syndromeTable[value] & 7;
+    }
+
+    int blockBytes = 1 << (k - 3);
+    const unsigned char *bytes = cover + block * blockBytes;
+    unsigned int syndrome = 0;
+    for (int o = 0; o < blockBytes; o++)
+    {
+        unsigned int entry = syndromeTable[bytes[o]];
+        syndrome ^= (entry & 7) ^ ((entry >> 3) ? (unsigned int) (o << 3) : 0);
+    }
+
+    return syndrome;
+}
+
+
+
+/*****************************************************************
+** Function: matrixEncode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void matrixEncode(unsigned char *cover, const unsigned char *message, long length, int k)
+**              unsigned char *cover -- Bits of the slots, changed to carry the message
+**              const unsigned char *message -- Bytes of the secret
+**              long length -- Number of bytes
+**              int k -- Bits of the secret per block (2 to 8)
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** The cover needs (8 * length + k - 1) / k blocks of 2^k bits. The
+** last block is padded with zero bits. Flips at most one bit per
+** block.
+**********************************************************************/
+void matrixEncode(unsigned char *cover, const unsigned char *message, long length, int k)
+{
+    long numBlocks = (length * 8 + k - 1) / k;
+    unsigned int symbolMask = (1u << k) - 1;
+    unsigned int pending = 0;
+    int numPending = 0;
+    long next = 0;
+
+    for (long block = 0; block < numBlocks; block++)
+    {
+        //the next k bits of the secret, most significant first
+        while (numPending < k)
+        {
+            pending = (pending << 8) | ((next < length) ? message[next] : 0);
+            next++;
+            numPending += 8;
+        }
+        numPending -= k;
+        unsigned int symbol = (pending >> numPending) & symbolMask;
+
+        unsigned int flip = blockSyndrome(cover, block, k) ^ symbol;
+        if (flip != 0)
+        {
+            long bitPos = (block << k) + flip;
+            cover[bitPos >> 3] ^= (unsigned char) (0x80 >> (bitPos & 7));
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: matrixDecode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void matrixDecode(const unsigned char *cover, unsigned char *message, long length, int k)
+**              const unsigned char *cover -- Bits of the slots
+**              unsigned char *message -- Receives the bytes of the secret
+**              long length -- Number of bytes
+**              int k -- Bits of the secret per block (2 to 8)
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+void matrixDecode(const unsigned char *cover, unsigned char *message, long length, int k)
+{
+    unsigned int pending = 0;
+    int numPending = 0;
+    long next = 0;
+
+    for (long block = 0; next < length; block++)
+    {
+        pending = (pending << k) | blockSyndrome(cover, block, k);
+        numPending += k;
+
+        while (numPending >= 8 && next < length)
+        {
+            numPending -= 8;
+            message[next++] = (unsigned char) (pending >> numPending);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: bitPlaneSamples
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void bitPlaneSamples(const unsigned short *samples, long count, int bit, unsigned char *plane)
+**              const unsigned short *samples -- Channel values (see readScanlineSamples)
+**              long count -- Number of channel values
+**              int bit -- Bit position to show (0 to 15)
+**              unsigned char *plane -- Receives 255 where the bit is set, 0 otherwise
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Amplifies one bit plane so it can be looked at, 16 samples at a time
+** with SSE2 where it is available.
+**********************************************************************/
+void bitPlaneSamples(const unsigned short *samples, long count, int bit, unsigned char *plane)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i shift = _mm_cvtsi32_si128(bit);
+    __m128i one = _mm_set1_epi16(1);
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i low = _mm_loadu_si128((const __m128i *) (samples + i));
+        __m128i high = _mm_loadu_si128((const __m128i *) (samples + i + 8));
+
+        //a set bit becomes an all ones lane, which packs to 255
+        low = _mm_cmpeq_epi16(_mm_and_si128(_mm_srl_epi16(low, shift), one), one);
+        high = _mm_cmpeq_epi16(_mm_and_si128(_mm_srl_epi16(high, shift), one), one);
+        _mm_storeu_si128((__m128i *) (plane + i), _mm_packs_epi16(low, high));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        plane[i] = ((samples[i] >> bit) & 1) ? 255 : 0;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: differenceSamples
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void differenceSamples(const unsigned short *first, const unsigned short *second, long count,
+**                                 unsigned int gain, unsigned char *difference)
+**              const unsigned short *first -- Channel values of one image
+**              const unsigned short *second -- Channel values of the other image
+**              long count -- Number of channel values
+**              unsigned int gain -- Amplification of the difference (1 to 255)
+**              unsigned char *difference -- Receives |first - second| * gain, at most 255
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Differences are capped at 255 before they are amplified so the
+** product always fits in an unsigned 16 bit lane. Done 16 samples at
+** a time with SSE2 where it is available.
+**********************************************************************/
+void differenceSamples(const unsigned short *first, const unsigned short *second, long count,
+                       unsigned int gain, unsigned char *difference)
+{
+    long i = 0;
+
+#ifdef __SSE2__
+    __m128i factor = _mm_set1_epi16((short) gain);
+    __m128i cap = _mm_set1_epi16(255);
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i lanes[2];
+
+        for (int half = 0; half < 2; half++)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *) (first + i + half * 8));
+            __m128i b = _mm_loadu_si128((const __m128i *) (second + i + half * 8));
+
+            //|a - b| from the two saturating differences, then min(d, 255) as d - max(d - 255, 0)
+            __m128i d = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+            d = _mm_sub_epi16(d, _mm_subs_epu16(d, cap));
+            d = _mm_mullo_epi16(d, factor);
+            lanes[half] = _mm_sub_epi16(d, _mm_subs_epu16(d, cap));
+        }
+
+        _mm_storeu_si128((__m128i *) (difference + i), _mm_packus_epi16(lanes[0], lanes[1]));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        unsigned int d = (first[i] > second[i]) ? first[i] - second[i] : second[i] - first[i];
+        d = (d < 255 ? d : 255) * gain;
+        difference[i] = (unsigned char) (d < 255 ? d : 255);
     }
 }
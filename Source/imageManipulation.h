@@ -1,12 +1,57 @@
 #ifndef IMAGEMANIPULATION_H
 #define IMAGEMANIPULATION_H
 
-#include <QRgb>
-#include <bitset>
 #define NUM_BITS 8
+#define MAX_NUM_BITS 16
+#define NUM_CHANNELS 3
+#define MIN_MATRIX_BITS 2
+#define MAX_MATRIX_BITS 8
 
-int embedBitsInPixel(QRgb *, std::queue<int> *, bool *, int, int);
-void retrieveBitsFromPixel(std::queue<int> *, QRgb *, bool *);
+//layout of the samples in a scanline
+enum PixelFormat
+{
+    FORMAT_RGB32,       //8 bits per channel, stored as a native QRgb (0xAARRGGBB)
+    FORMAT_RGBA64,      //16 bits per channel, stored as R, G, B, A
+    FORMAT_GRAY8,       //one 8 bit channel
+    FORMAT_GRAY16,      //one 16 bit channel
+    FORMAT_INDEXED8     //one 8 bit palette index
+};
 
-#endif // IMAGEMANIPULATION_H
+//enabled bit positions of a channel with lookup tables to move the bits
+//of the secret in and out of them. 16 bit channels use one table per byte.
+struct BitMask
+{
+    int depth;                              //bits per channel (8 or 16)
+    int numBits;                            //enabled positions per channel
+    int numLowBits;                         //enabled positions in the low byte
+    unsigned int mask;                      //enabled positions as a mask
+    int positions[MAX_NUM_BITS];            //enabled positions, highest first
+    unsigned char depositLow[256];
+    unsigned char depositHigh[256];
+    unsigned char extractLow[256];
+    unsigned char extractHigh[256];
+};
+
+//two xorshift128+ generators that pick the direction of each LSB matching step
+struct MatchingRandom
+{
+    unsigned long long state[4];            //first halves of both generators, then second halves
+};
 
+void buildBitMask(BitMask *, const bool *, int);
+int channelsInFormat(PixelFormat);
+int depthInFormat(PixelFormat);
+int pixelSizeInFormat(PixelFormat);
+void seedMatchingRandom(MatchingRandom *, unsigned long long);
+long embedBitsInScanline(unsigned char *, int, PixelFormat, const BitMask *, long, const unsigned char *, long, long,
+                         MatchingRandom *);
+long readScanlineSamples(const unsigned char *, int, PixelFormat, unsigned short *);
+long retrieveBitsFromScanline(const unsigned char *, int, PixelFormat, const BitMask *, long, unsigned char *, long, long);
+void readTextureLine(const unsigned char *, int, PixelFormat, const BitMask *, unsigned short *);
+void markTexturedPixels(const unsigned short *, const unsigned short *, const unsigned short *, int, int, unsigned char *);
+void matrixEncode(unsigned char *, const unsigned char *, long, int);
+void matrixDecode(const unsigned char *, unsigned char *, long, int);
+void bitPlaneSamples(const unsigned short *, long, int, unsigned char *);
+void differenceSamples(const unsigned short *, const unsigned short *, long, unsigned int, unsigned char *);
+
+#endif // IMAGEMANIPULATION_H
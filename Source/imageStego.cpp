@@ -4,10 +4,35 @@
 **	PROGRAM:	Steganography
 **
 **	FUNCTIONS:
-** int embedSecret(QImage *, std::ifstream *, std::string, int, bool *, int)
-** string retrieveSecret(QImage *embedImage, bool *)
-** bool getNextPixelEmbed(QRgb *)
-** bool getNextPixelRetrieve(QRgb *)
+** int embedSecret(QImage *, std::ifstream *, std::string, int, bool *, const StegoOptions *)
+** string retrieveSecret(QImage *embedImage, bool *, const string &)
+** int embedSecretData(QImage *, const string &, const char *, long long, bool *, const StegoOptions *)
+** int embedSecretStream(QImage *, const string &, StegoReader, void *, bool *, const StegoOptions *, long long *)
+** int embedSecretFiles(QImage *, const string &, const vector<ArchiveFile> &, bool *, const StegoOptions *)
+** int appendSecretData(QImage *, const char *, long long, bool *, const StegoOptions *)
+** int appendSecretFiles(QImage *, const vector<ArchiveFile> &, bool *, const StegoOptions *)
+** int updateSecretData(QImage *, const char *, long long, bool *, const StegoOptions *, long long *)
+** int retrieveSecretData(QImage *, bool *, string *, vector<char> *)
+** int listSecretFiles(QImage *, bool *, SecretHeader *, vector<ArchiveEntry> *)
+** int retrieveSecretFile(QImage *, bool *, const SecretHeader *, const ArchiveEntry *, vector<char> *)
+** int retrieveSecretRange(QImage *, bool *, const SecretHeader *, long long, long long, StegoWriter, void *)
+** int readSecretHeader(QImage *, bool *, SecretHeader *)
+** bool getModifiedRows(int *, int *)
+** int detectBitMask(QImage *, bool *)
+** void clearCapacityCache(CapacityCache *)
+** long long carrierCapacity(const QImage *, bool *, const StegoOptions *, CapacityCache *)
+** int carrierBitDepth(QImage::Format)
+** int carrierChannels(QImage::Format)
+** PixelFormat carrierLayout(QImage *)
+** string outputFileName(const QImage *)
+** bool saveCarrier(const QImage *, const QString &)
+** PixelFormat prepareCarrier(QImage *, bool)
+** PixelFormat convertCarrier(QImage *, bool)
+** void sortPalette(QImage *)
+** PixelBuffer wrapCarrier(QImage *, PixelFormat, bool)
+** long readSecretFile(void *, char *, long)
+** bool writeSecretFile(void *, const char *, long)
+** bool writeSecretData(void *, const char *, long)
 **
 **
 **	DATE:       September 23rd, 2016
@@ -20,33 +45,63 @@
 **
 **	NOTES:
 ** Contains main stegonography functions of embedding and retrieving
-** a secret in an image.
+** a secret in an image. The codec itself lives in stegoCore; these
+** functions get a QImage into a layout it works on and connect it
+** to the secret's files.
+**
+** Carriers with 16 bits per
+** channel (16 bit PNG and TIFF) are kept at full depth, so all 16 bit
+** positions of each channel can be used. Grayscale carriers are worked
+** on as their single channel and palette carriers through the bits of
+** their palette indices, without converting either to 32 bit colour.
+**
+** Several files can be embedded as one archive (see stegoArchive),
+** which can be listed and have single files retrieved from it. Any
+** byte range of a secret can be retrieved on its own as well.
+**
+** A secret can also be embedded from a stream whose size is not known
+** until it ends, such as a pipe.
+**
+** A secret already embedded can be grown in place, by more bytes for
+** a single file or more files for an archive, without embedding what
+** is already there again, or replaced by a new version of it by
+** embedding only the blocks that changed.
 *************************************************************************/
 
 #include <iostream>
-#include <QRgb>
-#include <queue>
-#include <sstream>
-#include <stdexcept>
-#include <cstdio>
+#include <algorithm>
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
 #include "imageStego.h"
-#include "imageManipulation.h"
+#include "stegoTrace.h"
+#include "reedSolomon.h"
 
 using namespace std;
 
-int width = 0;
-int height = 0;
-QImage *carrier;
-QRgb *line;
-bool firstPixelSet = false;
+int firstModifiedRow = -1;
+int lastModifiedRow = -1;
+
+static PixelFormat prepareCarrier(QImage *, bool);
+static PixelFormat convertCarrier(QImage *, bool);
+static void sortPalette(QImage *);
+static PixelBuffer wrapCarrier(QImage *, PixelFormat, bool);
+static long readSecretFile(void *, char *, long);
+static bool writeSecretFile(void *, const char *, long);
+static bool writeSecretData(void *, const char *, long);
 
 
 /*****************************************************************
-** Function: embedBitsInPixel
+** Function: embedSecret
 **
 ** Date: September 24rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Embeds whole scanlines at a time and keeps
+**                      16 bit carriers at full depth
+** October 19th, 2026 - Grayscale and palette carriers in their own format
+** October 19th, 2026 - Embeds through stegoCore
+** October 19th, 2026 - Takes the embedding options
 **
 **
 ** Designer: Rhea Lauzon
@@ -55,147 +110,197 @@ bool firstPixelSet = false;
 **
 ** Interface:
 **          int embedSecret(QImage *c, ifstream *secret,
-**          string secretName, int fileSize, bool *enabledBits, int numBitsPerChannel)
+**          string secretName, int fileSize, bool *enabledBits,
+**          const StegoOptions *options)
 **             QImage *c -- Carrier image to embed the secret in
 **             ifstream *secret -- File pointer to the secret
 **             string secretName -- name of the secret's file
 **             int fileSize -- size of the secret
 **             bool *enabledBits -- pointer of positions that are available
-**             int numBitsPerChannel -- Number of bits avail. per channel
+**             const StegoOptions *options -- How to embed, or NULL for the defaults
 **
 **
 ** Returns:
 **			int -- 0 on success, -1 on failure
 **
 ** Notes:
-** Loops through an image pixel by pixel and embeds the secret file
-** via bits nto the specified bit positions in the RGB channels.
+** Embeds the header and then the secret file, a chunk at a time, via
+** bits into the specified bit positions in the RGB channels (or the
+** grayscale/palette channel). The carrier is only saved if the whole
+** secret made it in.
 **********************************************************************/
-int embedSecret(QImage *c, ifstream *secret, string secretName, int fileSize, bool *enabledBits, int numBitsPerChannel)
+int embedSecret(QImage *c, ifstream *secret, string secretName, int fileSize, bool *enabledBits,
+                const StegoOptions *options)
 {
     //reset data
-    width = 0;
-    height = 0;
-    firstPixelSet = false;
+    firstModifiedRow = -1;
+    lastModifiedRow = -1;
+
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    RowRange modified;
+    int result = stegoEmbedStream(&carrier, &bitMask, options, secretName, fileSize, readSecretFile, secret, &modified);
 
+    //close the secret
+    secret->close();
 
-    //set our global carrier to the carrier from the GUI
-    carrier = c;
+    firstModifiedRow = modified.first;
+    lastModifiedRow = modified.last;
+
+    if (result == STEGO_TOO_BIG)
+    {
+        cout << "FILE WAS TOO BIG" << endl;
+        cout.flush();
+    }
+    if (result != STEGO_OK)
+    {
+        return -1;
+    }
 
-    //initialize our pixel
-    QRgb *pixel = new QRgb();
+    //save the file
+    saveCarrier(c, QString::fromStdString(outputFileName(c)));
 
-    //set our initial component to the file name since we want to write it first
-    SecretComponent component = FILE_NAME;
+    return 0;
+}
 
 
-    //set the line to the first line
-    line = (QRgb *) carrier->scanLine(height);
 
+/*****************************************************************
+** Function: retrieveSecret
+**
+** Date: October 3rd, 2016
+**
+** Revisions:
+** October 19th, 2026 - Retrieves whole scanlines at a time and stops
+**                      at the end of the image when no secret is found
+** October 19th, 2026 - Retrieves through stegoCore
+** October 19th, 2026 - Retrieves the files of an archive, or one of them
+** October 19th, 2026 - Removes a single file that fails too, and keeps it in
+**                      the working directory
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string retrieveSecret(QImage *embedImage, bool *enabledBits, const string &fileName)
+**              QImage *embedImage -- image that has a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              const string &fileName -- File of an archive to retrieve, empty for all
+**
+**
+** Returns:
+**			string -- name of the file, or the first file of an archive,
+**                    or empty if no secret found
+**
+** Notes:
+** Retrieves a secret image from an image based off the bit positions
+** specified in each colour channel (RGB). An archive has each of its
+** files written under its own file name. A file that fails its
+** checksum or can not be written whole is removed.
+**********************************************************************/
+string retrieveSecret(QImage *embedImage, bool *enabledBits, const string &fileName)
+{
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
 
-    int numBitsRemainingInPixel = 0;
-    int namePos = 0;
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
 
-    //convert the file size to a string
-    stringstream ss;
-    ss << fileSize;
-    string fileSizeStr = ss.str();
+    //the header has to check out before any file is created
+    SecretHeader header;
+    if (stegoReadHeader(&carrier, &bitMask, &header) != STEGO_OK)
+    {
+        return "";
+    }
 
-    char character;
-    while (*secret)
+    //only the file names of an archive are used, so its index can not write elsewhere
+    if (header.options.archiveIndex > 0)
     {
-        switch (component)
+        vector<ArchiveEntry> entries;
+        if (archiveReadIndex(&carrier, &bitMask, &header, &entries) != STEGO_OK)
+        {
+            return "";
+        }
+
+        string firstName;
+        for (size_t i = 0; i < entries.size(); i++)
         {
-            case FILE_NAME:
+            if (!fileName.empty() && entries[i].name != fileName)
             {
-                //if we've placed all of the file name in the file set the next byte as nulls as a delmeter
-                if (namePos == secretName.length())
-                {
-                    character = '\0';
-                    component = FILE_SIZE;
-                    namePos = 0;
-                }
-                else
-                {
-                    character = secretName[namePos];
-                    namePos++;
-                }
+                continue;
             }
-            break;
 
-            case FILE_SIZE:
+            string name = QFileInfo(QString::fromStdString(entries[i].name)).fileName().toStdString();
+            ofstream secret(name, ios_base::binary);
+            if (!secret.is_open())
             {
-                //if we've placed all of the file name in the file set the next byte as nulls as a delmeter
-                if (namePos == fileSizeStr.length())
-                {
-                    character = '\0';
-                    component = RAW_DATA;
-                    namePos = 0;
-                }
-                else
-                {
-                    character = fileSizeStr[namePos];
-                    namePos++;
-                }
-
+                return "";
             }
-            break;
 
-            case RAW_DATA:
+            int result = archiveExtractFile(&carrier, &bitMask, &header, &entries[i], writeSecretFile, &secret);
+            secret.close();
+            if (result != STEGO_OK || !secret)
             {
-                secret->read(&character, 1);
+                QFile::remove(QString::fromStdString(name));
+                return "";
             }
-            break;
-        }
-
-        //convert the character to bits
-        queue<int> bits;
-        for (int i = 0; i < NUM_BITS; i++)
-        {
-            bits.push(GET_BIT_VALUE(character, NUM_BITS -i - 1));
-        }
 
-        //keep going until we've embedded all 8 bits of the byte
-        while (!bits.empty())
-        {
-            if (numBitsRemainingInPixel == 0)
+            if (firstName.empty())
             {
-                if (getNextPixelEmbed(pixel))
-                {
-                    numBitsRemainingInPixel = 3 * numBitsPerChannel;
-                }
-                else
-                {
-                    cout << "FILE WAS TOO BIG" << endl;
-                    cout.flush();
-                    return -1;
-                }
+                firstName = name;
             }
-            //keep track of how many bits remain in this pixel
-            numBitsRemainingInPixel -= embedBitsInPixel(pixel, &bits, enabledBits, numBitsPerChannel, numBitsRemainingInPixel);
         }
+
+        return firstName;
     }
 
-    //do one last final embed incase of partially filled pixels
-    getNextPixelEmbed(pixel);
+    if (!fileName.empty() && fileName != header.name)
+    {
+        return "";
+    }
 
-    //save the file
-    c->save("secret.bmp");
+    //the name comes from the carrier, so only its file name is used
+    string name = QFileInfo(QString::fromStdString(header.name)).fileName().toStdString();
+    ofstream secret(name, ios_base::binary);
+    if (!secret.is_open())
+    {
+        return "";
+    }
 
-    //close the secret
-    secret->close();
+    int result = stegoExtractStream(&carrier, &bitMask, &header, writeSecretFile, &secret);
 
-    return 0;
+    //close the file, which writes out what is still buffered
+    secret.close();
+    if (result == STEGO_OK && !secret)
+    {
+        result = STEGO_WRITE_FAILED;
+    }
+
+    //the blocks streamed before the data failed are not left behind
+    if (result != STEGO_OK)
+    {
+        QFile::remove(QString::fromStdString(name));
+        return "";
+    }
+
+    return name;
 }
 
 
 
 /*****************************************************************
-** Function: retrieveSecret
+** Function: embedSecretData
 **
-** Date: October 3rd, 2016
+** Date: October 19th, 2026
 **
 ** Revisions:
+** October 19th, 2026 - Takes the embedding options
 **
 **
 ** Designer: Rhea Lauzon
@@ -203,149 +308,190 @@ int embedSecret(QImage *c, ifstream *secret, string secretName, int fileSize, bo
 ** Programmer: Rhea Lauzon
 **
 ** Interface:
-**          string retrieveSecret(QImage *embedImage, bool *enabledBits)
-**              QImage *embedImage -- image that has a secret embedded
-**              bool *enabledBits -- bit positions that have embedded data
+**          int embedSecretData(QImage *c, const string &secretName, const char *data,
+**                              long long size, bool *enabledBits, const StegoOptions *options)
+**             QImage *c -- Carrier image to embed the secret in
+**             const string &secretName -- name of the secret's file
+**             const char *data -- The secret
+**             long long size -- size of the secret
+**             bool *enabledBits -- pointer of positions that are available
+**             const StegoOptions *options -- How to embed, or NULL for the defaults
 **
 **
 ** Returns:
-**			string -- name of the file or empty if no secret found
+**			int -- STEGO_OK, or one of the STEGO_ errors
 **
 ** Notes:
-** Retrieves a secret image from an image based off the bit positions
-** specified in each colour channel (RGB).
+** Embeds a secret held in memory and leaves saving the carrier to the
+** caller. Unlike embedSecret it keeps no global state, so it can run
+** on several carriers at once.
 **********************************************************************/
-string retrieveSecret(QImage *embedImage, bool *enabledBits)
+int embedSecretData(QImage *c, const string &secretName, const char *data, long long size, bool *enabledBits,
+                    const StegoOptions *options)
 {
-    //reset data in case of last attempts
-    width = 0;
-    height = 0;
-    firstPixelSet = false;
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
 
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
 
-    //get the crarier image
-    carrier = embedImage;
+    return stegoEmbed(&carrier, &bitMask, options, secretName, data, size, NULL);
+}
 
-    //initialize a pixel
-    QRgb *pixel = new QRgb();
 
-    queue<int> *bitsRetrieved = new queue<int>();
-    bitset<NUM_BITS> byteData;
 
-    //start by finding the file name
-    SecretComponent component = FILE_NAME;
+/*****************************************************************
+** Function: embedSecretStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int embedSecretStream(QImage *c, const string &secretName, StegoReader reader, void *context,
+**                                bool *enabledBits, const StegoOptions *options, long long *size)
+**             QImage *c -- Carrier image to embed the secret in
+**             const string &secretName -- name of the secret's file
+**             StegoReader reader -- Called for the secret until it runs out
+**             void *context -- Passed to the reader
+**             bool *enabledBits -- pointer of positions that are available
+**             const StegoOptions *options -- How to embed, or NULL for the defaults
+**             long long *size -- Set to the size of the secret embedded
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Embeds a secret as it is read, without knowing its size, and like
+** embedSecretData leaves saving the carrier to the caller. A secret
+** too big for the carrier leaves it part written (see
+** stegoEmbedUnsized).
+**********************************************************************/
+int embedSecretStream(QImage *c, const string &secretName, StegoReader reader, void *context, bool *enabledBits,
+                      const StegoOptions *options, long long *size)
+{
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
 
-    string fileName;
-    string fileSizeStr;
-    int fileSize = 999999999;
-    bool delimeterFound = false;
-    ofstream secret;
-    int byteCounter = 0;
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
 
-    while(byteCounter < fileSize)
-    {
-        //get the next pixel
-        getNextPixelRetrieve(pixel);
+    return stegoEmbedUnsized(&carrier, &bitMask, options, secretName, reader, context, size, NULL);
+}
 
-        //fetch all the bits hidden in the RGB channel
-        retrieveBitsFromPixel(bitsRetrieved, pixel, enabledBits);
 
-        while (bitsRetrieved->size() >= 8)
-        {
-            for (int i = 0; i < NUM_BITS; i++)
-            {
-                byteData.set(NUM_BITS - i - 1, bitsRetrieved->front());
-                bitsRetrieved->pop();
-            }
 
-            //turn the raw bits into a byte (character)
-            char character = static_cast<unsigned char>(byteData.to_ulong());
+/*****************************************************************
+** Function: embedSecretFiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int embedSecretFiles(QImage *c, const string &archiveName, const vector<ArchiveFile> &files,
+**                               bool *enabledBits, const StegoOptions *options)
+**             QImage *c -- Carrier image to embed the files in
+**             const string &archiveName -- name of the archive
+**             const vector<ArchiveFile> &files -- The files, held in memory
+**             bool *enabledBits -- pointer of positions that are available
+**             const StegoOptions *options -- How to embed, or NULL for the defaults
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Embeds the files as one archive with an index in front, and like
+** embedSecretData leaves saving the carrier to the caller.
+**********************************************************************/
+int embedSecretFiles(QImage *c, const string &archiveName, const vector<ArchiveFile> &files, bool *enabledBits,
+                     const StegoOptions *options)
+{
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
 
-            //look for our delimeter for data that isnt the raw data
-            if (character == '\0' && component != RAW_DATA)
-            {
-                delimeterFound = true;
-            }
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
 
-            switch (component)
-            {
-                //first we need the file name to open a stream to it
-                case FILE_NAME:
-                {
-                    if (delimeterFound)
-                    {
-                        secret = ofstream(fileName, ios_base::binary);
-                        component = FILE_SIZE;
-                        delimeterFound = false;
-                        break;
-                    }
-
-                    //add a character to the file name
-                    fileName += character;
-                }
-                break;
-
-                //next we need the file size to know how much data to read
-                case FILE_SIZE:
-                {
-                    if (delimeterFound)
-                    {
-                        //try converting what we found into a file size, if it fails we know there is no secret
-                        try
-                        {
-                            fileSize = stoi(fileSizeStr);
-                        }
-                        catch (const std::invalid_argument& i)
-                        {
-                            remove(fileName.c_str());
-                            return "";
-                        }
-
-                        //make sure we got a proper file size before continuing
-                        if (fileSize <= 0)
-                        {
-                            remove(fileName.c_str());
-                            return "";
-                        }
-
-                        component = RAW_DATA;
-                        delimeterFound = false;
-                        break;
-                    }
-                    //add a character to the file size string
-                    fileSizeStr += character;
-                }
-                break;
-
-                //read the raw data now that we know the name + size
-                case RAW_DATA:
-                {
-                    //only write if the file size has not been met
-                    if (byteCounter < fileSize)
-                    {
-                        //write the byte into the file
-                        secret << character;
-                        byteCounter++;
-                    }
-                }
-                break;
-            }
+    return archiveEmbed(&carrier, &bitMask, options, archiveName, files, NULL);
+}
 
-        }
-    }
 
-    //close the file
-    secret.close();
 
-    return fileName;
+/*****************************************************************
+** Function: appendSecretData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int appendSecretData(QImage *c, const char *data, long long size, bool *enabledBits,
+**                               const StegoOptions *options)
+**             QImage *c -- Carrier image with a secret embedded
+**             const char *data -- Bytes to add to the end of the secret
+**             long long size -- Number of bytes
+**             bool *enabledBits -- bit positions that have embedded data
+**             const StegoOptions *options -- Only whether to embed by LSB matching, may be NULL
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the secret is an archive, or one
+**                 of the other STEGO_ errors
+**
+** Notes:
+** Embeds only the new bytes behind the secret and writes its header
+** again with the new size. The rest of the options are the secret's
+** own, from its header.
+**********************************************************************/
+int appendSecretData(QImage *c, const char *data, long long size, bool *enabledBits, const StegoOptions *options)
+{
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    SecretHeader header;
+    int result = stegoReadHeader(&carrier, &bitMask, &header);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+    if (header.options.archiveIndex > 0)
+    {
+        return STEGO_ERROR;
+    }
+
+    StegoOptions appendOptions = header.options;
+    appendOptions.matching = (options != NULL) ? options->matching : 0;
 
+    return stegoAppend(&carrier, &bitMask, &header, &appendOptions, data, size, NULL);
 }
 
 
+
 /*****************************************************************
-** Function: getNextPixelEmbed
+** Function: appendSecretFiles
 **
-** Date: September 30th, 2016
+** Date: October 19th, 2026
 **
 ** Revisions:
 **
@@ -355,53 +501,105 @@ string retrieveSecret(QImage *embedImage, bool *enabledBits)
 ** Programmer: Rhea Lauzon
 **
 ** Interface:
-**          bool getNextPixelEmbed(QRgb * pix)
-**              Qrgb *pix -- The current pixel pointer
+**          int appendSecretFiles(QImage *c, const vector<ArchiveFile> &files, bool *enabledBits,
+**                                const StegoOptions *options)
+**             QImage *c -- Carrier image with an archive embedded
+**             const vector<ArchiveFile> &files -- The files to add, held in memory
+**             bool *enabledBits -- bit positions that have embedded data
+**             const StegoOptions *options -- Only whether to embed by LSB matching, may be NULL
 **
 **
 ** Returns:
-**			bool -- True when a pixel can be retrieved
-**                  False if there is no next pixel.
+**			int -- STEGO_OK, STEGO_ERROR if the secret is not an archive or a
+**                 name is already in it, or one of the other STEGO_ errors
 **
 ** Notes:
-** Fetches the next pixel in the image and updates the data of the
-** previous pixel with the manipulated data.
+** Adds the files to the archive (see archiveAppend) without moving
+** the files already in it.
 **********************************************************************/
-bool getNextPixelEmbed(QRgb * pix)
+int appendSecretFiles(QImage *c, const vector<ArchiveFile> &files, bool *enabledBits, const StegoOptions *options)
 {
-    if (firstPixelSet)
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    SecretHeader header;
+    int result = stegoReadHeader(&carrier, &bitMask, &header);
+    if (result != STEGO_OK)
     {
-        //set the previous pixel with the updated pixel (manipulated with data)
-        line[width] = *pix;
+        return result;
+    }
 
-        //increment the pixel position
-        width++;
-        if (width == carrier->width())
-        {
-            width = 0;
-            height++;
-            line = (QRgb *) carrier->scanLine(height);
-        }
+    return archiveAppend(&carrier, &bitMask, &header, options, files, NULL);
+}
 
-        if (height > carrier->height())
-        {
-            return false;
-        }
 
+
+/*****************************************************************
+** Function: updateSecretData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int updateSecretData(QImage *c, const char *data, long long size, bool *enabledBits,
+**                               const StegoOptions *options, long long *changed)
+**             QImage *c -- Carrier image with a secret embedded
+**             const char *data -- New version of the secret
+**             long long size -- size of the new version
+**             bool *enabledBits -- pointer of positions that have embedded data
+**             const StegoOptions *options -- Only LSB matching is taken from these, may be NULL
+**             long long *changed -- Set to the bytes of the secret embedded again
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Replaces the secret with its new version, rewriting only the blocks
+** that differ (see stegoUpdate). The secret keeps its name and the
+** rest of its options. Archives are not updated this way.
+**********************************************************************/
+int updateSecretData(QImage *c, const char *data, long long size, bool *enabledBits, const StegoOptions *options,
+                     long long *changed)
+{
+    PixelFormat format = prepareCarrier(c, true);
+    PixelBuffer carrier = wrapCarrier(c, format, true);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    SecretHeader header;
+    int result = stegoReadHeader(&carrier, &bitMask, &header);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+    if (header.options.archiveIndex > 0)
+    {
+        return STEGO_ERROR;
     }
 
-    //fetch the RGB channels of the pixel
-    *pix = carrier->pixel(width, height);
+    StegoOptions updateOptions = header.options;
+    updateOptions.matching = (options != NULL) ? options->matching : 0;
 
-    firstPixelSet = true;
-    return true;
+    return stegoUpdate(&carrier, &bitMask, &header, &updateOptions, data, size, changed, NULL);
 }
 
 
+
 /*****************************************************************
-** Function: getNextPixelRetrieve
+** Function: retrieveSecretData
 **
-** Date: October 3rd, 2016
+** Date: October 19th, 2026
 **
 ** Revisions:
 **
@@ -411,38 +609,953 @@ bool getNextPixelEmbed(QRgb * pix)
 ** Programmer: Rhea Lauzon
 **
 ** Interface:
-**          bool getNextPixelEmbed(QRgb * pix)
-**              Qrgb *pix -- The current pixel pointer
+**          int retrieveSecretData(QImage *embedImage, bool *enabledBits,
+**                                 string *secretName, vector<char> *data)
+**              QImage *embedImage -- image that has a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              string *secretName -- Set to the name of the secret's file
+**              vector<char> *data -- Set to the secret
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Retrieves a secret into memory without creating any file.
+**********************************************************************/
+int retrieveSecretData(QImage *embedImage, bool *enabledBits, string *secretName, vector<char> *data)
+{
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    return stegoExtract(&carrier, &bitMask, secretName, data);
+}
+
+
+
+/*****************************************************************
+** Function: listSecretFiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int listSecretFiles(QImage *embedImage, bool *enabledBits, SecretHeader *header,
+**                              vector<ArchiveEntry> *entries)
+**              QImage *embedImage -- image that may have a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              SecretHeader *header -- Filled in with the header found
+**              vector<ArchiveEntry> *entries -- Set to the files of the secret
 **
 **
 ** Returns:
-**			bool -- True when a pixel can be retrieved
-**                  False if there is no next pixel.
+**			int -- STEGO_OK, or one of the STEGO_ errors
 **
 ** Notes:
-** Fetches the next pixel in the image.
+** Only the header and the index are retrieved. A secret that is not
+** an archive is listed as its one file, with no checksum.
 **********************************************************************/
-bool getNextPixelRetrieve(QRgb *pix)
+int listSecretFiles(QImage *embedImage, bool *enabledBits, SecretHeader *header, vector<ArchiveEntry> *entries)
 {
-    if (firstPixelSet)
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    int result = stegoReadHeader(&carrier, &bitMask, header);
+    if (result != STEGO_OK)
     {
-        //increment the pixel position
-        width++;
-        if (width == carrier->width())
-        {
-            width = 0;
-            height++;
-        }
+        return result;
+    }
 
-        if (height > carrier->height())
-        {
-            return false;
-        }
+    if (header->options.archiveIndex > 0)
+    {
+        return archiveReadIndex(&carrier, &bitMask, header, entries);
     }
 
-    //fetch the RGB channels of the pixel
-    *pix = carrier->pixel(width, height);
+    ArchiveEntry entry = {header->name, 0, header->size, 0};
+    entries->assign(1, entry);
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveSecretFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int retrieveSecretFile(QImage *embedImage, bool *enabledBits, const SecretHeader *header,
+**                                 const ArchiveEntry *entry, vector<char> *data)
+**              QImage *embedImage -- image that has a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              const SecretHeader *header -- Header from listSecretFiles
+**              const ArchiveEntry *entry -- File from listSecretFiles
+**              vector<char> *data -- Set to the file
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Retrieves only the pixels holding the file.
+**********************************************************************/
+int retrieveSecretFile(QImage *embedImage, bool *enabledBits, const SecretHeader *header,
+                       const ArchiveEntry *entry, vector<char> *data)
+{
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    data->clear();
+    data->reserve((size_t) entry->size);
+    if (header->options.archiveIndex == 0)
+    {
+        return stegoExtractRange(&carrier, &bitMask, header, 0, header->size, writeSecretData, data);
+    }
+
+    return archiveExtractFile(&carrier, &bitMask, header, entry, writeSecretData, data);
+}
+
+
+
+/*****************************************************************
+** Function: retrieveSecretRange
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int retrieveSecretRange(QImage *embedImage, bool *enabledBits, const SecretHeader *header,
+**                                  long long offset, long long length, StegoWriter writer, void *output)
+**              QImage *embedImage -- image that has a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              const SecretHeader *header -- Header from readSecretHeader
+**              long long offset -- First byte of the range
+**              long long length -- Bytes in the range
+**              StegoWriter writer -- Called with the range as it is retrieved
+**              void *output -- Passed on to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the range is not in the secret,
+**                 or one of the other STEGO_ errors
+**
+** Notes:
+** Retrieves only the pixels holding the range. The offset of an
+** archive counts from its first file, after the index, and the range
+** ends before any index at the end.
+**********************************************************************/
+int retrieveSecretRange(QImage *embedImage, bool *enabledBits, const SecretHeader *header,
+                        long long offset, long long length, StegoWriter writer, void *output)
+{
+    long long index = header->options.archiveIndex;
+    if (offset < 0 || length < 0 || offset + length > header->size - index - header->options.archiveTail)
+    {
+        return STEGO_ERROR;
+    }
+
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    return stegoExtractRange(&carrier, &bitMask, header, index + offset, length, writer, output);
+}
+
+
+
+/*****************************************************************
+** Function: readSecretHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int readSecretHeader(QImage *embedImage, bool *enabledBits, SecretHeader *header)
+**              QImage *embedImage -- image that may have a secret embedded
+**              bool *enabledBits -- bit positions that have embedded data
+**              SecretHeader *header -- Filled in with the header found
+**
+**
+** Returns:
+**			int -- STEGO_OK, or STEGO_NO_SECRET if there is no secret
+**
+** Notes:
+** Reads only the name and size of a secret.
+**********************************************************************/
+int readSecretHeader(QImage *embedImage, bool *enabledBits, SecretHeader *header)
+{
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+    return stegoReadHeader(&carrier, &bitMask, header);
+}
+
+
+
+/*****************************************************************
+** Function: getModifiedRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool getModifiedRows(int *firstRow, int *lastRow)
+**              int *firstRow -- Set to the first row written by the last embed
+**              int *lastRow -- Set to the last row written by the last embed
+**
+**
+** Returns:
+**			bool -- True if the last embed changed any rows
+**
+** Notes:
+** Reports the range of rows the last call to embedSecret wrote to,
+** so only that part of the display has to be refreshed.
+**********************************************************************/
+bool getModifiedRows(int *firstRow, int *lastRow)
+{
+    if (firstModifiedRow == -1)
+    {
+        return false;
+    }
+
+    *firstRow = firstModifiedRow;
+    *lastRow = lastModifiedRow;
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: detectBitMask
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int detectBitMask(QImage *embedImage, bool *enabledBits)
+**              QImage *embedImage -- image that may have a secret embedded
+**              bool *enabledBits -- Set to the bit positions that were found
+**
+**
+** Returns:
+**			int -- Number of bit positions found, 0 if no mask or several equally
+**                 good ones gave a header
+**
+** Notes:
+** Finds the bit positions a secret was embedded with when they are not
+** known (see stegoDetectBitMask).
+**********************************************************************/
+int detectBitMask(QImage *embedImage, bool *enabledBits)
+{
+    PixelFormat format = prepareCarrier(embedImage, false);
+    PixelBuffer carrier = wrapCarrier(embedImage, format, false);
+
+    return stegoDetectBitMask(&carrier, enabledBits);
+}
+
+
+
+/*****************************************************************
+** Function: clearCapacityCache
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void clearCapacityCache(CapacityCache *cache)
+**              CapacityCache *cache -- Cache to empty
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Lets go of the prepared carrier, e.g. once the carrier is cleared.
+**********************************************************************/
+void clearCapacityCache(CapacityCache *cache)
+{
+    cache->carrierKey = 0;
+    cache->prepared = QImage();
+    cache->format = FORMAT_RGB32;
+    cache->texturedSlots.clear();
+}
+
+
+
+/*****************************************************************
+** Function: carrierCapacity
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Prepares the carrier and counts its textured pixels once
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long carrierCapacity(const QImage *c, bool *enabledBits,
+**                                    const StegoOptions *options, CapacityCache *cache)
+**              const QImage *c -- Carrier image
+**              bool *enabledBits -- bit positions that are available
+**              const StegoOptions *options -- How to embed, or NULL for the defaults
+**              CapacityCache *cache -- What was worked out for the carrier before
+**
+**
+** Returns:
+**			long long -- Bytes the carrier can hold, header included
+**
+** Notes:
+** Works on a copy of the carrier prepared the way an embed would
+** prepare it, so adaptive embedding counts the same pixels it will
+** later pick. The copy (with its palette sorted) is made once per
+** carrier, and the textured pixels are only counted, through the cost
+** map, once for each bit mask and threshold; matrix embedding and error
+** correction are worked out from that count. A carrier that changed,
+** e.g. by an embed, has a new cacheKey and is prepared again.
+**********************************************************************/
+long long carrierCapacity(const QImage *c, bool *enabledBits, const StegoOptions *options, CapacityCache *cache)
+{
+    if (cache->prepared.isNull() || cache->carrierKey != c->cacheKey())
+    {
+        clearCapacityCache(cache);
+        cache->prepared = *c;
+        cache->format = prepareCarrier(&cache->prepared, true);
+        cache->carrierKey = c->cacheKey();
+    }
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(cache->format));
+
+    StegoOptions textured;
+    stegoDefaultOptions(&textured);
+    textured.adaptiveThreshold = (options != NULL) ? options->adaptiveThreshold : 0;
+
+    quint64 key = 0;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        key |= (quint64) enabledBits[i] << i;
+    }
+    key |= (quint64) textured.adaptiveThreshold << MAX_NUM_BITS;
+
+    QHash<quint64, long long>::iterator found = cache->texturedSlots.find(key);
+    if (found == cache->texturedSlots.end())
+    {
+        PixelBuffer carrier = wrapCarrier(&cache->prepared, cache->format, false);
+        found = cache->texturedSlots.insert(key, stegoCapacity(&carrier, &bitMask, &textured));
+    }
+
+    long long numSlots = *found;
+    if (options != NULL && options->matrixBits > 0)
+    {
+        numSlots = (numSlots >> options->matrixBits) * options->matrixBits;
+    }
+    if (options != NULL && options->fecParity > 0)
+    {
+        numSlots = numSlots / RS_CODEWORD_LENGTH * (RS_CODEWORD_LENGTH - options->fecParity);
+    }
+
+    return numSlots / 8;
+}
+
+
+
+/*****************************************************************
+** Function: carrierBitDepth
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int carrierBitDepth(QImage::Format format)
+**              QImage::Format format -- Format of the carrier image
+**
+**
+** Returns:
+**			int -- Bits per channel the carrier is embedded at (8 or 16)
+**********************************************************************/
+int carrierBitDepth(QImage::Format format)
+{
+    switch (format)
+    {
+        case QImage::Format_RGBX64:
+        case QImage::Format_RGBA64:
+        case QImage::Format_RGBA64_Premultiplied:
+        case QImage::Format_Grayscale16:
+            return 16;
+
+        default:
+            return NUM_BITS;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: carrierChannels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int carrierChannels(QImage::Format format)
+**              QImage::Format format -- Format of the carrier image
+**
+**
+** Returns:
+**			int -- Number of channels per pixel the secret is spread over
+**********************************************************************/
+int carrierChannels(QImage::Format format)
+{
+    switch (format)
+    {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Grayscale16:
+        case QImage::Format_Indexed8:
+        case QImage::Format_Mono:
+        case QImage::Format_MonoLSB:
+            return 1;
+
+        default:
+            return 3;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: carrierLayout
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          PixelFormat carrierLayout(QImage *c)
+**              QImage *c -- Image to convert
+**
+**
+** Returns:
+**			PixelFormat -- Layout of the image's scanlines
+**
+** Notes:
+** Converts the image to the layout the secret is read from, so its
+** channel values match what the scanline functions see. Palettes are
+** left in their order.
+**********************************************************************/
+PixelFormat carrierLayout(QImage *c)
+{
+    return convertCarrier(c, false);
+}
+
+
+
+/*****************************************************************
+** Function: outputFileName
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string outputFileName(const QImage *c)
+**              const QImage *c -- Carrier image with the secret embedded
+**
+**
+** Returns:
+**			string -- Name of the file the carrier is saved as
+**
+** Notes:
+** Bitmaps can not hold 16 bits per channel or real grayscale, so
+** those carriers are saved as PNG instead.
+**********************************************************************/
+string outputFileName(const QImage *c)
+{
+    if (carrierBitDepth(c->format()) == 16 || c->format() == QImage::Format_Grayscale8)
+    {
+        return "secret.png";
+    }
+
+    return "secret.bmp";
+}
+
+
+
+/*****************************************************************
+** Function: saveCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool saveCarrier(const QImage *c, const QString &path)
+**              const QImage *c -- Carrier image with the secret embedded
+**              const QString &path -- File to save it as, the extension picks the format
+**
+**
+** Returns:
+**			bool -- False if the carrier could not be saved
+**
+** Notes:
+** Encodes the carrier in memory and then writes it out, so the two
+** can be timed apart.
+**********************************************************************/
+bool saveCarrier(const QImage *c, const QString &path)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_ENCODE);
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::WriteOnly);
+    bool saved = c->save(&buffer, QFileInfo(path).suffix().toLatin1().constData());
+
+    traceEnd(&span, (long long) c->width() * c->height(), encoded.size());
+    if (!saved)
+    {
+        return false;
+    }
+
+    traceBegin(&span, STAGE_FILE_WRITE);
+
+    QFile file(path);
+    saved = file.open(QIODevice::WriteOnly) && file.write(encoded) == encoded.size();
+    file.close();
+
+    traceEnd(&span, 0, encoded.size());
+    return saved;
+}
+
+
+
+/*****************************************************************
+** Function: prepareCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          PixelFormat prepareCarrier(QImage *c, bool embedding)
+**              QImage *c -- Carrier image
+**              bool embedding -- True if a secret is about to be embedded
+**
+**
+** Returns:
+**			PixelFormat -- Layout of the carrier's scanlines
+**
+** Notes:
+** Gets the carrier ready for the scanline functions and times it.
+**********************************************************************/
+static PixelFormat prepareCarrier(QImage *c, bool embedding)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_PREPARE);
+
+    PixelFormat format = convertCarrier(c, embedding);
+
+    traceEnd(&span, (long long) c->width() * c->height(), 0);
+    return format;
+}
+
+
+
+/*****************************************************************
+** Function: convertCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          PixelFormat convertCarrier(QImage *c, bool embedding)
+**              QImage *c -- Carrier image
+**              bool embedding -- True if a secret is about to be embedded
+**
+**
+** Returns:
+**			PixelFormat -- Layout of the carrier's scanlines
+**
+** Notes:
+** Converts the carrier to one of the layouts the scanline functions
+** work on, if it is not in one already. 16 bit carriers become
+** RGBA64 so no bits are lost, grayscale carriers stay grayscale and
+** 1 bit carriers become 8 bit palette images. Before embedding, the
+** palette of a palette image is sorted (see sortPalette).
+**********************************************************************/
+static PixelFormat convertCarrier(QImage *c, bool embedding)
+{
+    switch (c->format())
+    {
+        case QImage::Format_Grayscale8:
+            return FORMAT_GRAY8;
+
+        case QImage::Format_Grayscale16:
+            return FORMAT_GRAY16;
+
+        case QImage::Format_Mono:
+        case QImage::Format_MonoLSB:
+        case QImage::Format_Indexed8:
+        {
+            if (c->format() != QImage::Format_Indexed8)
+            {
+                *c = c->convertToFormat(QImage::Format_Indexed8);
+            }
+
+            if (embedding)
+            {
+                sortPalette(c);
+            }
+            return FORMAT_INDEXED8;
+        }
+
+        default:
+            break;
+    }
+
+    if (carrierBitDepth(c->format()) == 16)
+    {
+        if (c->format() != QImage::Format_RGBA64)
+        {
+            *c = c->convertToFormat(QImage::Format_RGBA64);
+        }
+        return FORMAT_RGBA64;
+    }
+
+    if (c->format() != QImage::Format_RGB32 && c->format() != QImage::Format_ARGB32)
+    {
+        *c = c->convertToFormat(c->hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    }
+    return FORMAT_RGB32;
+}
+
+
+
+/*****************************************************************
+** Function: sortPalette
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void sortPalette(QImage *c)
+**              QImage *c -- Palette carrier image
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Reorders the palette from darkest to brightest and remaps the pixels
+** to match, so the image looks exactly the same. With a sorted palette,
+** changing the low bits of an index moves the pixel to a colour of
+** similar brightness instead of an arbitrary one. The palette is also
+** padded to 256 entries with its brightest colour so that every index
+** the secret can produce is valid. Sorting a palette that is already
+** sorted changes nothing.
+**********************************************************************/
+static void sortPalette(QImage *c)
+{
+    QVector<QRgb> table = c->colorTable();
+    int numColors = table.size();
+    if (numColors == 0 || numColors > 256)
+    {
+        return;
+    }
+
+    vector<int> order(numColors);
+    for (int i = 0; i < numColors; i++)
+    {
+        order[i] = i;
+    }
+
+    stable_sort(order.begin(), order.end(), [&table](int a, int b)
+    {
+        return qGray(table[a]) < qGray(table[b]);
+    });
+
+    QVector<QRgb> sorted(256);
+    unsigned char remap[256];
+    bool changed = (numColors != 256);
+
+    for (int i = 0; i < 256; i++)
+    {
+        remap[i] = (unsigned char) i;
+    }
+
+    for (int i = 0; i < numColors; i++)
+    {
+        sorted[i] = table[order[i]];
+        remap[order[i]] = (unsigned char) i;
+
+        if (order[i] != i)
+        {
+            changed = true;
+        }
+    }
+
+    //pad with the brightest colour
+    for (int i = numColors; i < 256; i++)
+    {
+        sorted[i] = sorted[numColors - 1];
+    }
+
+    if (!changed)
+    {
+        return;
+    }
+
+    for (int row = 0; row < c->height(); row++)
+    {
+        unsigned char *line = c->scanLine(row);
+        for (int x = 0; x < c->width(); x++)
+        {
+            line[x] = remap[line[x]];
+        }
+    }
+
+    c->setColorTable(sorted);
+}
+
+
+
+/*****************************************************************
+** Function: wrapCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          PixelBuffer wrapCarrier(QImage *c, PixelFormat format, bool writable)
+**              QImage *c -- Carrier image, already prepared
+**              PixelFormat format -- Layout of the carrier's scanlines
+**              bool writable -- True if the pixels are about to be changed
+**
+**
+** Returns:
+**			PixelBuffer -- The carrier's pixels, in place
+**
+** Notes:
+** Pixels that are only read are not detached from other copies of
+** the image.
+**********************************************************************/
+static PixelBuffer wrapCarrier(QImage *c, PixelFormat format, bool writable)
+{
+    PixelBuffer carrier;
+    carrier.data = writable ? c->bits() : (unsigned char *) c->constBits();
+    carrier.width = c->width();
+    carrier.height = c->height();
+    carrier.stride = (long) c->bytesPerLine();
+    carrier.format = format;
+
+    return carrier;
+}
+
+
+
+/*****************************************************************
+** Function: readSecretFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readSecretFile(void *context, char *buffer, long length)
+**              void *context -- ifstream of the secret
+**              char *buffer -- Receives the next bytes of the secret
+**              long length -- Most bytes to read
+**
+**
+** Returns:
+**			long -- Number of bytes read
+**********************************************************************/
+static long readSecretFile(void *context, char *buffer, long length)
+{
+    ifstream *secret = (ifstream *) context;
+    if (!*secret)
+    {
+        return 0;
+    }
+
+    secret->read(buffer, length);
+    return (long) secret->gcount();
+}
+
+
+
+/*****************************************************************
+** Function: writeSecretFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeSecretFile(void *context, const char *buffer, long length)
+**              void *context -- ofstream of the retrieved secret
+**              const char *buffer -- Next bytes of the secret
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			bool -- False if the file could not be written
+**********************************************************************/
+static bool writeSecretFile(void *context, const char *buffer, long length)
+{
+    ofstream *secret = (ofstream *) context;
+    secret->write(buffer, length);
+
+    return (bool) *secret;
+}
+
+
+
+/*****************************************************************
+** Function: writeSecretData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeSecretData(void *context, const char *buffer, long length)
+**              void *context -- vector<char> the secret is retrieved into
+**              const char *buffer -- Next bytes of the secret
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			bool -- Always true
+**********************************************************************/
+static bool writeSecretData(void *context, const char *buffer, long length)
+{
+    vector<char> *data = (vector<char> *) context;
+    data->insert(data->end(), buffer, buffer + length);
 
-    firstPixelSet = true;
     return true;
 }
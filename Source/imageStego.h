@@ -2,21 +2,44 @@
 #define IMAGESTEGO_H
 
 #include <QImage>
+#include <QString>
+#include <QHash>
 #include <fstream>
 #include <vector>
+#include "stegoCore.h"
+#include "stegoArchive.h"
 
-enum SecretComponent
+//a carrier prepared once for working out its capacity under any bit
+//positions and options, with the textured slots counted so far
+struct CapacityCache
 {
-    FILE_NAME,
-    FILE_SIZE,
-    RAW_DATA
+    qint64 carrierKey;                          //cacheKey of the carrier it was prepared from
+    QImage prepared;
+    PixelFormat format;
+    QHash<quint64, long long> texturedSlots;    //by bit mask and adaptive threshold
 };
 
-int embedSecret(QImage *, std::ifstream *, std::string, int, bool *, int);
-std::string retrieveSecret(QImage *embedImage, bool *);
-bool getNextPixelEmbed(QRgb *);
-bool getNextPixelRetrieve(QRgb *);
-
-#define GET_BIT_VALUE(where, bit_number) (((where) & (1 << (bit_number))) >> bit_number) //this will return 0 or 1
+int embedSecret(QImage *, std::ifstream *, std::string, int, bool *, const StegoOptions *);
+std::string retrieveSecret(QImage *embedImage, bool *, const std::string & = "");
+int embedSecretData(QImage *, const std::string &, const char *, long long, bool *, const StegoOptions *);
+int embedSecretStream(QImage *, const std::string &, StegoReader, void *, bool *, const StegoOptions *, long long *);
+int embedSecretFiles(QImage *, const std::string &, const std::vector<ArchiveFile> &, bool *, const StegoOptions *);
+int appendSecretData(QImage *, const char *, long long, bool *, const StegoOptions *);
+int appendSecretFiles(QImage *, const std::vector<ArchiveFile> &, bool *, const StegoOptions *);
+int updateSecretData(QImage *, const char *, long long, bool *, const StegoOptions *, long long *);
+int retrieveSecretData(QImage *, bool *, std::string *, std::vector<char> *);
+int listSecretFiles(QImage *, bool *, SecretHeader *, std::vector<ArchiveEntry> *);
+int retrieveSecretFile(QImage *, bool *, const SecretHeader *, const ArchiveEntry *, std::vector<char> *);
+int retrieveSecretRange(QImage *, bool *, const SecretHeader *, long long, long long, StegoWriter, void *);
+int readSecretHeader(QImage *, bool *, SecretHeader *);
+bool getModifiedRows(int *, int *);
+int detectBitMask(QImage *, bool *);
+void clearCapacityCache(CapacityCache *);
+long long carrierCapacity(const QImage *, bool *, const StegoOptions *, CapacityCache *);
+int carrierBitDepth(QImage::Format);
+int carrierChannels(QImage::Format);
+PixelFormat carrierLayout(QImage *);
+std::string outputFileName(const QImage *);
+bool saveCarrier(const QImage *, const QString &);
 
 #endif // IMAGESTEGO_H
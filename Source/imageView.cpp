@@ -10,6 +10,12 @@
 **    void dragMoveEvent(QDragMoveEvent *event)
 **    ImageView(QWidget *parent = 0)
 **    void setWindow(MainWindow *)
+**    void setImage(const QImage *)
+**    void clearImage()
+**    void refreshRows(int, int)
+**    void setView(const ViewSettings &)
+**    void setReference(const QImage *)
+**    void wheelEvent(QWheelEvent *)
 **
 **
 **	DATE:        September 23rd, 2016
@@ -22,12 +28,18 @@
 **
 **	NOTES:
 ** Custom class of the QGraphicsView to allow drag and drops.
+** Images are displayed through a tiled item so that only the visible
+** part of very large carriers is turned into pixmaps. The view can
+** also show bit planes of the image or how it differs from the carrier
+** before the secret went in.
 *************************************************************************/
 #include <iostream>
 #include <QDropEvent>
 #include <QUrl>
 #include <QErrorMessage>
 #include <QMimeData>
+#include <QFileInfo>
+#include <QWheelEvent>
 #include <QDebug>
 #include "imageView.h"
 
@@ -41,6 +53,8 @@ using namespace std;
 ** Date: September 23rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Starts with no image item
+** October 19th, 2026 - Starts out showing the image itself
 **
 **
 ** Designer: Rhea Lauzon
@@ -59,6 +73,13 @@ using namespace std;
 ImageView::ImageView(QWidget *parent) : QGraphicsView(parent)
 {
     setAcceptDrops(true);
+    imageItem = 0;
+
+    view.mode = VIEW_IMAGE;
+    view.channel = VIEW_ALL_CHANNELS;
+    view.bit = 0;
+    view.gain = 255;
+    reference = 0;
 }
 
 
@@ -128,6 +149,7 @@ void ImageView::dragMoveEvent(QDragMoveEvent *event)
 ** Date: September 23rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Several files dropped at once become embed jobs
 **
 **
 ** Designer: Rhea Lauzon
@@ -141,19 +163,32 @@ void ImageView::dragMoveEvent(QDragMoveEvent *event)
 ** Returns: void
 **
 ** Notes:
-** Handles items that are dropped onto the image view.
+** Handles items that are dropped onto the image view. A single file
+** is a carrier or a secret as before, several files are handed to
+** the job queue.
 **********************************************************************/
 void ImageView::dropEvent(QDropEvent *event)
 {
     QList<QUrl> urls = event->mimeData()->urls();    
 
-    QString fileName = urls[0].fileName();
-
-    //update the image
-    window->updateImage(urls[0].toLocalFile(), fileName);
-
-
+    QStringList filePaths;
+    for (int i = 0; i < urls.size(); i++)
+    {
+        if (urls[i].isLocalFile())
+        {
+            filePaths.append(urls[i].toLocalFile());
+        }
+    }
 
+    if (filePaths.size() > 1)
+    {
+        window->queueJobs(filePaths);
+    }
+    else if (filePaths.size() == 1)
+    {
+        //update the image
+        window->updateImage(filePaths[0], QFileInfo(filePaths[0]).fileName());
+    }
 }
 
 
@@ -183,3 +218,220 @@ void ImageView::setWindow(MainWindow *parent)
 {
     this->window = parent;
 }
+
+
+
+/*****************************************************************
+** Function: setImage
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Shows the new image in the current view
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setImage(const QImage *image)
+**             const QImage *image -- Image to display (not copied)
+**
+**
+** Returns: void
+**
+** Notes:
+** Replaces the displayed image. Images larger than the view are
+** zoomed out to fit so the coarse levels of the tile pyramid are used.
+**********************************************************************/
+void ImageView::setImage(const QImage *image)
+{
+    clearImage();
+
+    imageItem = new TiledImageItem(image);
+    imageItem->setView(view);
+    imageItem->setReference(reference);
+    scene()->addItem(imageItem);
+    scene()->setSceneRect(image->rect());
+
+    resetTransform();
+    if (image->width() > viewport()->width() || image->height() > viewport()->height())
+    {
+        fitInView(imageItem, Qt::KeepAspectRatio);
+    }
+}
+
+
+/*****************************************************************
+** Function: clearImage
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void clearImage()
+**
+**
+** Returns: void
+**
+** Notes:
+** Removes the displayed image and frees all of its tiles.
+**********************************************************************/
+void ImageView::clearImage()
+{
+    if (imageItem != 0)
+    {
+        scene()->removeItem(imageItem);
+        delete imageItem;
+        imageItem = 0;
+    }
+
+    resetTransform();
+}
+
+
+/*****************************************************************
+** Function: refreshRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void refreshRows(int firstRow, int lastRow)
+**             int firstRow -- First row of the image that changed
+**             int lastRow -- Last row of the image that changed
+**
+**
+** Returns: void
+**
+** Notes:
+** Redraws only the part of the displayed image that was changed.
+**********************************************************************/
+void ImageView::refreshRows(int firstRow, int lastRow)
+{
+    if (imageItem != 0)
+    {
+        imageItem->refreshRows(firstRow, lastRow);
+    }
+}
+
+
+/*****************************************************************
+** Function: setView
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setView(const ViewSettings &settings)
+**             const ViewSettings &settings -- What to show of the image
+**
+**
+** Returns: void
+**
+** Notes:
+** Switches between the image, one of its bit planes, its difference
+** from the reference and a heatmap of the changes.
+**********************************************************************/
+void ImageView::setView(const ViewSettings &settings)
+{
+    view = settings;
+
+    if (imageItem != 0)
+    {
+        imageItem->setView(view);
+    }
+}
+
+
+/*****************************************************************
+** Function: setReference
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setReference(const QImage *image)
+**             const QImage *image -- Image to compare to (not copied), or 0
+**
+**
+** Returns: void
+**
+** Notes:
+** Sets the image the difference and heatmap views compare against.
+**********************************************************************/
+void ImageView::setReference(const QImage *image)
+{
+    reference = image;
+
+    if (imageItem != 0)
+    {
+        imageItem->setReference(reference);
+    }
+}
+
+
+/*****************************************************************
+** Function: wheelEvent
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void wheelEvent(QWheelEvent *event)
+**             QWheelEvent *event -- Event containing the scroll amount
+**
+**
+** Returns: void
+**
+** Notes:
+** Zooms the view in and out around the mouse.
+**********************************************************************/
+void ImageView::wheelEvent(QWheelEvent *event)
+{
+    if (imageItem == 0 || event->angleDelta().y() == 0)
+    {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+
+    qreal factor = (event->angleDelta().y() > 0) ? 1.25 : 0.8;
+
+    ViewportAnchor anchor = transformationAnchor();
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    scale(factor, factor);
+    setTransformationAnchor(anchor);
+
+    event->accept();
+}
@@ -3,6 +3,7 @@
 
 #include <QGraphicsView>
 #include "mainWindow.h"
+#include "tiledImageItem.h"
 
 
 class ImageView : public QGraphicsView
@@ -11,15 +12,26 @@ class ImageView : public QGraphicsView
 public:
     ImageView(QWidget *parent = 0);
     void setWindow(MainWindow *);
+    void setImage(const QImage *);
+    void clearImage();
+    void refreshRows(int, int);
+    void setView(const ViewSettings &);
+    void setReference(const QImage *);
 
 protected:
     void dragEnterEvent(QDragEnterEvent *);
     void dropEvent(QDropEvent *);
     void dragMoveEvent(QDragMoveEvent *event);
+    void wheelEvent(QWheelEvent *);
 
 
 private:
     MainWindow * window;
+    TiledImageItem *imageItem;
+
+    //carried over to every image displayed
+    ViewSettings view;
+    const QImage *reference;
 };
 
 #endif // IMAGEVIEW_H
@@ -0,0 +1,426 @@
+/**********************************************************************
+**	SOURCE FILE:	jobQueue.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    JobQueue(QObject *parent = 0)
+**    ~JobQueue()
+**    int add(EmbedJob)
+**    void runJob(JobQueue *, EmbedJob)
+**    bool embedJob(EmbedJob *, JobBuffers *, QString *, qint64 *)
+**    bool embedJpegJob(EmbedJob *, JobBuffers *, QString *, qint64 *)
+**    bool retrieveJpegJob(EmbedJob *, JobBuffers *, QString *, qint64 *)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Runs the embeds of a multi-file drop on a pool of worker threads,
+** one thread per core, and reports each job as it starts and ends.
+** Every job writes its own output file, so any number of them can
+** run at once, as long as they fit in the memory budget. A job told to
+** keep a JPEG carrier as a JPEG embeds in its DCT coefficients and
+** never decodes its pixels. Retrieving from the coefficients reads
+** the whole file too, so the window hands that to the queue as well.
+*************************************************************************/
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include "jobQueue.h"
+#include "imageStego.h"
+#include "jpegStego.h"
+#include "stegoTrace.h"
+#include "bufferPool.h"
+#include "carrierCache.h"
+
+using namespace std;
+
+
+/*****************************************************************
+** Function: JobQueue
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          JobQueue(QObject *parent)
+**            QObject *parent -- Owner of the queue
+**
+** Returns: N/A (Constructor)
+**********************************************************************/
+JobQueue::JobQueue(QObject *parent) : QObject(parent)
+{
+    nextJob = 0;
+}
+
+
+
+/*****************************************************************
+** Function: ~JobQueue
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          ~JobQueue()
+**
+** Returns: N/A (Destructor)
+**
+** Notes:
+** Drops the jobs that have not started and waits for the rest.
+**********************************************************************/
+JobQueue::~JobQueue()
+{
+    pool.clear();
+    pool.waitForDone();
+}
+
+
+
+/*****************************************************************
+** Function: add
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int add(EmbedJob job)
+**            EmbedJob job -- Job to run, its number is filled in
+**
+** Returns:
+**          int -- Number of the job, counting up from 0
+**
+** Notes:
+** Queues the job and returns right away.
+**********************************************************************/
+int JobQueue::add(EmbedJob job)
+{
+    job.number = nextJob++;
+    QtConcurrent::run(&pool, runJob, this, job);
+
+    return job.number;
+}
+
+
+
+/*****************************************************************
+** Function: runJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Reserves memory and pooled buffers for the job
+** October 19th, 2026 - Runs retrieves from JPEG carriers
+** October 19th, 2026 - Fails jobs larger than the memory budget
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void runJob(JobQueue *queue, EmbedJob job)
+**            JobQueue *queue -- Queue to report through
+**            EmbedJob job -- Job to run
+**
+** Returns: void
+**
+** Notes:
+** Runs on a worker thread, and traces the job. Waits for the memory
+** the job needs before it starts on it, and fails it if it needs more
+** than the whole budget.
+**********************************************************************/
+void JobQueue::runJob(JobQueue *queue, EmbedJob job)
+{
+    //a carrier handed over decoded is copied once the secret goes in, unless
+    //it is kept as a JPEG, which reads its coefficients from the file instead
+    long long secretSize = job.retrieve ? 0 : QFileInfo(job.secretPath).size();
+    long long needed = (job.carrier.isNull() || job.keepJpeg || job.retrieve) ? estimateJobMemory(job.carrierPath, secretSize)
+                                                              : job.carrier.sizeInBytes() * 2 + secretSize;
+    long long reserved = reserveMemory(needed);
+    if (reserved < 0)
+    {
+        emit queue->jobFinished(job.number, false, "The job needs more memory than the memory budget.", 0, 0, QString());
+        return;
+    }
+    JobBuffers *buffers = acquireBuffers();
+    emit queue->jobStarted(job.number);
+
+    QElapsedTimer timer;
+    timer.start();
+    QString message;
+    qint64 bytes = 0;
+    bool ok;
+    if (job.retrieve)
+    {
+        traceStartJob("retrieve " + QFileInfo(job.carrierPath).fileName().toStdString());
+        ok = retrieveJpegJob(&job, buffers, &message, &bytes);
+    }
+    else
+    {
+        traceStartJob("embed " + QFileInfo(job.secretPath).fileName().toStdString());
+        ok = embedJob(&job, buffers, &message, &bytes);
+    }
+
+    QString summary = QString::fromStdString(traceFinishJob());
+    releaseBuffers(buffers);
+    releaseMemory(reserved);
+    emit queue->jobFinished(job.number, ok, message, bytes, timer.nsecsElapsed(), summary);
+}
+
+
+
+/*****************************************************************
+** Function: embedJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Works in pooled buffers
+** October 19th, 2026 - Embeds with the job's options
+** October 19th, 2026 - Hands JPEG carriers kept as JPEG to embedJpegJob
+** October 19th, 2026 - Writes into the pooled pixels
+** October 19th, 2026 - Takes the carrier from the carrier cache
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool embedJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+**            EmbedJob *job -- Job to run
+**            JobBuffers *buffers -- Buffers to decode the carrier and read the secret into
+**            QString *message -- Set to the output file, or what went wrong
+**            qint64 *bytes -- Set to the size of the secret embedded
+**
+** Returns:
+**          bool -- True if the secret was embedded and saved
+**
+** Notes:
+** A carrier that was handed over already decoded is shared with the
+** other jobs until this job embeds into it, at which point it gets
+** its own copy. Otherwise the carrier comes from the carrier cache,
+** shared with the cache the same way, so embedding several secrets
+** into one carrier decodes it once.
+**********************************************************************/
+bool JobQueue::embedJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+{
+    if (job->keepJpeg && jpegIsCarrier(job->carrierPath.toStdString()))
+    {
+        return embedJpegJob(job, buffers, message, bytes);
+    }
+
+    TraceSpan span;
+
+    if (job->carrier.isNull())
+    {
+        traceBegin(&span, STAGE_DECODE);
+        QString error;
+        bool decoded = readCachedCarrier(job->carrierPath, &buffers->carrier, &error);
+        traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+        if (!decoded)
+        {
+            *message = "Unable to open the carrier.";
+            return false;
+        }
+    }
+    else
+    {
+        buffers->carrier = job->carrier;
+        job->carrier = QImage();
+    }
+    detachCarrier(buffers);
+
+    traceBegin(&span, STAGE_SECRET_READ);
+    QFile secretFile(job->secretPath);
+    bool opened = secretFile.open(QIODevice::ReadOnly);
+    buffers->secret.resize(opened ? (size_t) secretFile.size() : 0);
+    bool read = opened && secretFile.read(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size();
+    traceEnd(&span, 0, (long long) buffers->secret.size());
+
+    if (!read)
+    {
+        *message = "Unable to open the secret file.";
+        return false;
+    }
+
+    int result = embedSecretData(&buffers->carrier, QFileInfo(job->secretPath).fileName().toStdString(),
+                                 buffers->secret.data(), (long long) buffers->secret.size(), job->enabledBits,
+                                 &job->options);
+    if (result != STEGO_OK)
+    {
+        *message = (result == STEGO_TOO_BIG) ? "Secret file is too large to embed." : "Unable to embed the secret.";
+        return false;
+    }
+
+    //the carrier decides between a bitmap and a PNG, the same as a single embed
+    QString outputPath = job->outputPath + "." + QFileInfo(QString::fromStdString(outputFileName(&buffers->carrier))).suffix();
+    if (!saveCarrier(&buffers->carrier, outputPath))
+    {
+        *message = "Unable to save " + outputPath + ".";
+        return false;
+    }
+
+    *message = outputPath;
+    *bytes = (qint64) buffers->secret.size();
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: embedJpegJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool embedJpegJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+**            EmbedJob *job -- Job with a JPEG carrier
+**            JobBuffers *buffers -- Buffers to read the secret into
+**            QString *message -- Set to the output file, or what went wrong
+**            qint64 *bytes -- Set to the size of the secret embedded
+**
+** Returns:
+**          bool -- True if the secret was embedded and saved
+**
+** Notes:
+** Reads the carrier from its file even if it was handed over decoded,
+** as the coefficients are not kept in the image. The output is always
+** a JPEG.
+**********************************************************************/
+bool JobQueue::embedJpegJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+{
+    job->carrier = QImage();
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_SECRET_READ);
+    QFile secretFile(job->secretPath);
+    bool opened = secretFile.open(QIODevice::ReadOnly);
+    buffers->secret.resize(opened ? (size_t) secretFile.size() : 0);
+    bool read = opened && secretFile.read(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size();
+    traceEnd(&span, 0, (long long) buffers->secret.size());
+
+    if (!read)
+    {
+        *message = "Unable to open the secret file.";
+        return false;
+    }
+
+    QString outputPath = job->outputPath + ".jpg";
+    int result = jpegEmbed(job->carrierPath.toStdString(), outputPath.toStdString(),
+                           QFileInfo(job->secretPath).fileName().toStdString(),
+                           buffers->secret.data(), (long long) buffers->secret.size());
+    if (result == STEGO_TOO_BIG)
+    {
+        *message = "Secret file is too large to embed.";
+        return false;
+    }
+    if (result == STEGO_WRITE_FAILED)
+    {
+        *message = "Unable to save " + outputPath + ".";
+        return false;
+    }
+    if (result != STEGO_OK)
+    {
+        *message = "Unable to open the carrier.";
+        return false;
+    }
+
+    *message = outputPath;
+    *bytes = (qint64) buffers->secret.size();
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveJpegJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool retrieveJpegJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+**            EmbedJob *job -- Job with a JPEG carrier
+**            JobBuffers *buffers -- Buffers to retrieve the secret into
+**            QString *message -- Set to the secret's file, or what went wrong
+**            qint64 *bytes -- Set to the size of the secret retrieved
+**
+** Returns:
+**          bool -- True if the secret was retrieved and written
+**
+** Notes:
+** Only the file name of the secret is used, so a crafted header can
+** not write elsewhere. A file that can not be written whole is removed.
+**********************************************************************/
+bool JobQueue::retrieveJpegJob(EmbedJob *job, JobBuffers *buffers, QString *message, qint64 *bytes)
+{
+    string name;
+    if (jpegExtract(job->carrierPath.toStdString(), &name, &buffers->secret) != STEGO_OK)
+    {
+        *message = "No secret found.";
+        return false;
+    }
+
+    QString fileName = QFileInfo(QString::fromStdString(name)).fileName();
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_SECRET_WRITE);
+    QFile secretFile(fileName);
+    bool written = secretFile.open(QIODevice::WriteOnly)
+                   && secretFile.write(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size();
+    secretFile.close();
+    traceEnd(&span, 0, (long long) buffers->secret.size());
+
+    if (!written || secretFile.error() != QFileDevice::NoError)
+    {
+        secretFile.remove();
+        *message = "Unable to write the secret file.";
+        return false;
+    }
+
+    *message = fileName;
+    *bytes = (qint64) buffers->secret.size();
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef JOBQUEUE_H
+#define JOBQUEUE_H
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+#include <QThreadPool>
+#include "imageManipulation.h"
+#include "stegoCore.h"
+#include "bufferPool.h"
+
+//one secret to embed into one carrier, or the secret of a JPEG carrier to retrieve
+struct EmbedJob
+{
+    int number;
+    QString carrierPath;
+    QImage carrier;                 //already decoded carrier, or null to read carrierPath
+    QString secretPath;
+    QString outputPath;             //without the extension, which depends on the carrier
+    bool enabledBits[MAX_NUM_BITS];
+    StegoOptions options;
+    bool keepJpeg;                  //embed a JPEG carrier in its DCT coefficients and save a JPEG
+    bool retrieve;                  //retrieve from the DCT coefficients of the carrier instead
+};
+
+class JobQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    JobQueue(QObject *parent = 0);
+    ~JobQueue();
+    int add(EmbedJob);
+
+signals:
+    void jobStarted(int);
+    void jobFinished(int, bool, QString, qint64, qint64, QString);
+
+private:
+    static void runJob(JobQueue *, EmbedJob);
+    static bool embedJob(EmbedJob *, JobBuffers *, QString *, qint64 *);
+    static bool embedJpegJob(EmbedJob *, JobBuffers *, QString *, qint64 *);
+    static bool retrieveJpegJob(EmbedJob *, JobBuffers *, QString *, qint64 *);
+
+    QThreadPool pool;
+    int nextJob;
+};
+
+#endif // JOBQUEUE_H
@@ -0,0 +1,1198 @@
+/**********************************************************************
+**	SOURCE FILE:	jpegStego.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** bool jpegIsCarrier(const string &)
+** long long jpegCapacity(const string &)
+** long long jpegJobMemory(const string &)
+** int jpegEmbed(const string &, const string &, const string &, const char *, long long)
+** int jpegReadHeader(const string &, SecretHeader *)
+** int jpegExtract(const string &, string *, vector<char> *)
+** void jpegErrorExit(j_common_ptr)
+** bool openCarrier(JpegCarrier *, const string &, bool)
+** void closeCarrier(JpegCarrier *)
+** bool writeCarrier(JpegCarrier *, const string &)
+** void copyMarkers(JpegCarrier *, j_compress_ptr)
+** int readHeader(JpegCarrier *, SecretHeader *)
+** bool countSlots(JpegCarrier *)
+** void countRows(JpegCarrier *, const JpegBand *, int, int)
+** bool fetchBand(JpegCarrier *, int, int, bool, JpegBand *)
+** bool transferBits(JpegCarrier *, long long, long long, const unsigned char *, unsigned char *)
+** void transferSlots(const JpegCarrier *, const JpegBand *, long long, long long, long long,
+**                    const unsigned char *, unsigned char *)
+** int threadsForSlots(long long)
+**
+**
+**	DATE:       October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Embeds a secret into a JPEG carrier without decoding it to pixels.
+** libjpeg reads the quantized DCT coefficients of the file, the secret
+** goes into them, and they are written straight back out, so there is
+** no IDCT or FDCT and no second round of quantization. The output is
+** a JPEG about the size of the carrier rather than a bitmap.
+**
+** Each AC coefficient whose magnitude is at least JPEG_MIN_MAGNITUDE
+** holds one bit in the lowest bit of its magnitude, the sign is kept.
+** Zeros and ones are skipped, as changing them could turn a zero into
+** a one or the other way round and the retriever would lose its
+** place. The slots are taken MCU row by MCU row, and within a row
+** component by component, block by block, in coefficient order.
+**
+** The header is the same name and size as stegoCore writes. None of
+** the pixel options apply, so none are written.
+**
+** The pixels are never decoded, but all the coefficients of the file
+** are held in memory at once: libjpeg reads them into its coefficient
+** arrays, 128 bytes for each 8x8 block of each component, and has no
+** backing store to move them out to. Jobs reserve that much against the
+** memory budget before they open the carrier (see jpegJobMemory).
+**
+** The coefficients are worked on JPEG_BAND_ROWS MCU rows at a time,
+** which only sets how the work is shared out, not how much memory is
+** used. The slots of each MCU row are counted on all the cores. An
+** embed then shares the MCU rows of the band out between the cores,
+** and a retrieve shares out whole bytes of the secret, so no two
+** threads ever touch the same byte or coefficient.
+*************************************************************************/
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <jpeglib.h>
+#include "jpegStego.h"
+#include "stegoTrace.h"
+
+using namespace std;
+
+//libjpeg reports errors by jumping back out of it
+struct JpegError
+{
+    struct jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+//quantized coefficients of a JPEG carrier
+struct JpegCarrier
+{
+    struct jpeg_decompress_struct info;
+    JpegError error;
+    FILE *file;
+    jvirt_barray_ptr *coefficients;
+    vector<long long> before;               //slots before each MCU row, one more than there are rows
+};
+
+//block rows of a band of MCU rows
+struct JpegBand
+{
+    int firstRow;
+    int lastRow;                            //MCU row after the band
+    int rowsPerComponent;                   //largest vertical sampling factor
+    vector<JBLOCKROW> blockRows;            //per MCU row and component, NULL past the bottom
+};
+
+static void jpegErrorExit(j_common_ptr);
+static bool openCarrier(JpegCarrier *, const string &, bool);
+static void closeCarrier(JpegCarrier *);
+static bool writeCarrier(JpegCarrier *, const string &);
+static void copyMarkers(JpegCarrier *, j_compress_ptr);
+static int readHeader(JpegCarrier *, SecretHeader *);
+static bool countSlots(JpegCarrier *);
+static void countRows(JpegCarrier *, const JpegBand *, int, int);
+static bool fetchBand(JpegCarrier *, int, int, bool, JpegBand *);
+static bool transferBits(JpegCarrier *, long long, long long, const unsigned char *, unsigned char *);
+static void transferSlots(const JpegCarrier *, const JpegBand *, long long, long long, long long,
+                          const unsigned char *, unsigned char *);
+static int threadsForSlots(long long);
+
+
+/*****************************************************************
+** Function: jpegIsCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool jpegIsCarrier(const string &path)
+**              const string &path -- File to check
+**
+**
+** Returns:
+**			bool -- True if the file starts like a JPEG
+**
+** Notes:
+** Only reads the start of image marker, whatever the extension says.
+**********************************************************************/
+bool jpegIsCarrier(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    unsigned char start[3];
+    bool jpeg = fread(start, 1, 3, file) == 3 && start[0] == 0xFF && start[1] == 0xD8 && start[2] == 0xFF;
+    fclose(file);
+
+    return jpeg;
+}
+
+
+
+/*****************************************************************
+** Function: jpegCapacity
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long jpegCapacity(const string &path)
+**              const string &path -- JPEG carrier
+**
+**
+** Returns:
+**			long long -- Number of bits the carrier can hold, header included,
+**                       or -1 if it can not be read
+**********************************************************************/
+long long jpegCapacity(const string &path)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+
+    JpegCarrier carrier;
+    long long capacity = openCarrier(&carrier, path, false) ? carrier.before.back() : -1;
+
+    traceEnd(&span, (long long) carrier.info.image_width * carrier.info.image_height, 0);
+    closeCarrier(&carrier);
+
+    return capacity;
+}
+
+
+
+/*****************************************************************
+** Function: jpegJobMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long jpegJobMemory(const string &path)
+**              const string &path -- JPEG carrier
+**
+**
+** Returns:
+**			long long -- Memory the coefficients of the carrier take once read,
+**                       or -1 if it is not a readable JPEG
+**
+** Notes:
+** Only reads the header. Each component's blocks are padded out to
+** whole MCUs, the same as libjpeg allocates them.
+**********************************************************************/
+long long jpegJobMemory(const string &path)
+{
+    struct jpeg_decompress_struct info;
+    JpegError error;
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    jpeg_create_decompress(&info);
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+    {
+        jpeg_destroy_decompress(&info);
+        return -1;
+    }
+
+    volatile long long bytes = -1;
+    if (setjmp(error.jump) == 0)
+    {
+        jpeg_stdio_src(&info, file);
+        jpeg_read_header(&info, TRUE);
+
+        long long total = (long long) (info.total_iMCU_rows + 1) * sizeof(long long);
+        for (int c = 0; c < info.num_components; c++)
+        {
+            const jpeg_component_info *component = &info.comp_info[c];
+            long long width = (component->width_in_blocks + component->h_samp_factor - 1) / component->h_samp_factor;
+            long long height = (component->height_in_blocks + component->v_samp_factor - 1) / component->v_samp_factor;
+            total += width * component->h_samp_factor * height * component->v_samp_factor * (long long) sizeof(JBLOCK);
+        }
+        bytes = total;
+    }
+
+    jpeg_destroy_decompress(&info);
+    fclose(file);
+
+    return bytes;
+}
+
+
+
+/*****************************************************************
+** Function: jpegEmbed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int jpegEmbed(const string &carrierPath, const string &outputPath, const string &name,
+**                        const char *data, long long size)
+**              const string &carrierPath -- JPEG carrier
+**              const string &outputPath -- JPEG to write, not the carrier itself
+**              const string &name -- Name of the secret's file
+**              const char *data -- The secret
+**              long long size -- Size of the secret
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Nothing is written if the secret does not fit. The markers of the
+** carrier (EXIF, ICC profile, comments) are copied to the output.
+**********************************************************************/
+int jpegEmbed(const string &carrierPath, const string &outputPath, const string &name,
+              const char *data, long long size)
+{
+    if (name.empty() || size < 0 || (data == NULL && size > 0))
+    {
+        return STEGO_ERROR;
+    }
+
+    //the file name and the file size are each followed by a null as a delimeter
+    stringstream ss;
+    ss << name << '\0' << size << '\0';
+    string header = ss.str();
+    long long headerBits = (long long) header.length() * 8;
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    JpegCarrier carrier;
+    bool opened = openCarrier(&carrier, carrierPath, true);
+    long long numPixels = (long long) carrier.info.image_width * carrier.info.image_height;
+    traceEnd(&span, numPixels, 0);
+
+    if (!opened)
+    {
+        closeCarrier(&carrier);
+        return STEGO_ERROR;
+    }
+
+    long long capacity = carrier.before.back();
+    if (headerBits > capacity || size > (capacity - headerBits) / 8)
+    {
+        closeCarrier(&carrier);
+        return STEGO_TOO_BIG;
+    }
+
+    traceBegin(&span, STAGE_HEADER_ENCODE);
+    bool embedded = transferBits(&carrier, 0, headerBits, (const unsigned char *) header.data(), NULL);
+    traceEnd(&span, 0, (long long) header.length());
+
+    traceBegin(&span, STAGE_EMBED);
+    embedded = embedded && transferBits(&carrier, headerBits, size * 8, (const unsigned char *) data, NULL);
+    traceEnd(&span, numPixels, size);
+
+    if (!embedded)
+    {
+        closeCarrier(&carrier);
+        return STEGO_ERROR;
+    }
+
+    traceBegin(&span, STAGE_ENCODE);
+    bool written = writeCarrier(&carrier, outputPath);
+    traceEnd(&span, numPixels, 0);
+
+    closeCarrier(&carrier);
+    return written ? STEGO_OK : STEGO_WRITE_FAILED;
+}
+
+
+
+/*****************************************************************
+** Function: jpegReadHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int jpegReadHeader(const string &path, SecretHeader *header)
+**              const string &path -- JPEG that may have a secret embedded
+**              SecretHeader *header -- Filled in with the header found
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_NO_SECRET if there is no believable header,
+**                 or STEGO_ERROR if the file is not a readable JPEG
+**********************************************************************/
+int jpegReadHeader(const string &path, SecretHeader *header)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    JpegCarrier carrier;
+    bool opened = openCarrier(&carrier, path, false);
+    traceEnd(&span, (long long) carrier.info.image_width * carrier.info.image_height, 0);
+
+    int result = opened ? readHeader(&carrier, header) : STEGO_ERROR;
+    closeCarrier(&carrier);
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: jpegExtract
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int jpegExtract(const string &path, string *name, vector<char> *data)
+**              const string &path -- JPEG that may have a secret embedded
+**              string *name -- Set to the name of the secret's file
+**              vector<char> *data -- Set to the secret
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Retrieves the whole secret into memory.
+**********************************************************************/
+int jpegExtract(const string &path, string *name, vector<char> *data)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    JpegCarrier carrier;
+    bool opened = openCarrier(&carrier, path, false);
+    long long numPixels = (long long) carrier.info.image_width * carrier.info.image_height;
+    traceEnd(&span, numPixels, 0);
+
+    SecretHeader header;
+    int result = opened ? readHeader(&carrier, &header) : STEGO_ERROR;
+    if (result != STEGO_OK)
+    {
+        closeCarrier(&carrier);
+        return result;
+    }
+
+    traceBegin(&span, STAGE_EXTRACT);
+    data->resize((size_t) header.size);
+    bool retrieved = transferBits(&carrier, header.dataSlot, header.size * 8, NULL, (unsigned char *) data->data());
+    traceEnd(&span, numPixels, header.size);
+
+    closeCarrier(&carrier);
+    if (!retrieved)
+    {
+        return STEGO_ERROR;
+    }
+
+    *name = header.name;
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: jpegErrorExit
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void jpegErrorExit(j_common_ptr info)
+**              j_common_ptr info -- Codec that failed
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Replaces libjpeg's handler, which would end the program. Jumps
+** back to the function that last called setjmp on the codec's error.
+**********************************************************************/
+static void jpegErrorExit(j_common_ptr info)
+{
+    longjmp(((JpegError *) info->err)->jump, 1);
+}
+
+
+
+/*****************************************************************
+** Function: openCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool openCarrier(JpegCarrier *carrier, const string &path, bool keepMarkers)
+**              JpegCarrier *carrier -- Set up with the coefficients of the file
+**              const string &path -- JPEG to read
+**              bool keepMarkers -- True to keep the markers to copy to an output
+**
+**
+** Returns:
+**			bool -- False if the file is not a readable JPEG
+**
+** Notes:
+** Reads the coefficients and counts the slots of each MCU row. The
+** carrier has to be closed even when this fails.
+**********************************************************************/
+static bool openCarrier(JpegCarrier *carrier, const string &path, bool keepMarkers)
+{
+    carrier->coefficients = NULL;
+    carrier->info.err = jpeg_std_error(&carrier->error.manager);
+    carrier->error.manager.error_exit = jpegErrorExit;
+    jpeg_create_decompress(&carrier->info);
+
+    carrier->file = fopen(path.c_str(), "rb");
+    if (carrier->file == NULL)
+    {
+        return false;
+    }
+
+    if (setjmp(carrier->error.jump))
+    {
+        return false;
+    }
+
+    jpeg_stdio_src(&carrier->info, carrier->file);
+    if (keepMarkers)
+    {
+        jpeg_save_markers(&carrier->info, JPEG_COM, 0xFFFF);
+        for (int i = 0; i < 16; i++)
+        {
+            jpeg_save_markers(&carrier->info, JPEG_APP0 + i, 0xFFFF);
+        }
+    }
+
+    jpeg_read_header(&carrier->info, TRUE);
+    carrier->coefficients = jpeg_read_coefficients(&carrier->info);
+
+    return countSlots(carrier);
+}
+
+
+
+/*****************************************************************
+** Function: closeCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void closeCarrier(JpegCarrier *carrier)
+**              JpegCarrier *carrier -- Carrier from openCarrier
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+static void closeCarrier(JpegCarrier *carrier)
+{
+    jpeg_destroy_decompress(&carrier->info);
+
+    if (carrier->file != NULL)
+    {
+        fclose(carrier->file);
+        carrier->file = NULL;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: writeCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeCarrier(JpegCarrier *carrier, const string &path)
+**              JpegCarrier *carrier -- Carrier with the secret embedded
+**              const string &path -- JPEG to write
+**
+**
+** Returns:
+**			bool -- False if the file could not be written
+**
+** Notes:
+** Writes the coefficients as they are, with the carrier's quantization
+** tables and sampling. The Huffman tables are built for the new
+** coefficients so the file does not grow, and a progressive carrier
+** stays progressive. A file that fails part way is removed.
+**********************************************************************/
+static bool writeCarrier(JpegCarrier *carrier, const string &path)
+{
+    struct jpeg_compress_struct output;
+    JpegError error;
+    output.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    jpeg_create_compress(&output);
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+    {
+        jpeg_destroy_compress(&output);
+        return false;
+    }
+
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_compress(&output);
+        fclose(file);
+        remove(path.c_str());
+        return false;
+    }
+
+    jpeg_copy_critical_parameters(&carrier->info, &output);
+    output.optimize_coding = TRUE;
+    if (carrier->info.progressive_mode)
+    {
+        jpeg_simple_progression(&output);
+    }
+
+    jpeg_stdio_dest(&output, file);
+    jpeg_write_coefficients(&output, carrier->coefficients);
+    copyMarkers(carrier, &output);
+    jpeg_finish_compress(&output);
+    jpeg_destroy_compress(&output);
+
+    if (fclose(file) != 0)
+    {
+        remove(path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: copyMarkers
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void copyMarkers(JpegCarrier *carrier, j_compress_ptr output)
+**              JpegCarrier *carrier -- Carrier whose markers were kept
+**              j_compress_ptr output -- Encoder that has just started the file
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Leaves out the JFIF and Adobe markers when the encoder writes its
+** own, so the output does not get two of them.
+**********************************************************************/
+static void copyMarkers(JpegCarrier *carrier, j_compress_ptr output)
+{
+    for (jpeg_saved_marker_ptr marker = carrier->info.marker_list; marker != NULL; marker = marker->next)
+    {
+        if (output->write_JFIF_header && marker->marker == JPEG_APP0
+            && marker->data_length >= 5 && memcmp(marker->data, "JFIF", 5) == 0)
+        {
+            continue;
+        }
+        if (output->write_Adobe_marker && marker->marker == JPEG_APP0 + 14
+            && marker->data_length >= 5 && memcmp(marker->data, "Adobe", 5) == 0)
+        {
+            continue;
+        }
+
+        jpeg_write_marker(output, marker->marker, marker->data, marker->data_length);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: readHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int readHeader(JpegCarrier *carrier, SecretHeader *header)
+**              JpegCarrier *carrier -- Carrier that may have a secret embedded
+**              SecretHeader *header -- Filled in with the header found
+**
+**
+** Returns:
+**			int -- STEGO_OK, or STEGO_NO_SECRET if there is no believable header
+**
+** Notes:
+** Reads the longest header there can be in one go and checks that a
+** secret of the size found could fit behind it.
+**********************************************************************/
+static int readHeader(JpegCarrier *carrier, SecretHeader *header)
+{
+    long long capacity = carrier->before.back();
+    long long length = min((long long) MAX_NAME_LENGTH + MAX_SIZE_LENGTH + 2, capacity / 8);
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_HEADER_DECODE);
+    vector<char> bytes((size_t) length + 1, '\0');
+    bool retrieved = transferBits(carrier, 0, length * 8, NULL, (unsigned char *) bytes.data());
+    traceEnd(&span, 0, length);
+
+    if (!retrieved)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    //first we need the file name, then the file size
+    const char *text = bytes.data();
+    const char *nameEnd = (const char *) memchr(text, '\0', (size_t) length);
+    if (nameEnd == NULL || nameEnd == text || nameEnd - text > MAX_NAME_LENGTH)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    const char *sizeStart = nameEnd + 1;
+    const char *sizeEnd = (const char *) memchr(sizeStart, '\0', (size_t) (text + length - sizeStart));
+    string fileSizeStr(sizeStart, (sizeEnd == NULL) ? sizeStart : sizeEnd);
+
+    //no options are written into a JPEG, and a size this long could not fit anyway
+    if (sizeEnd == NULL || fileSizeStr.empty() || fileSizeStr.length() > 18
+        || fileSizeStr.find_first_not_of("0123456789") != string::npos)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    long long fileSize = atoll(fileSizeStr.c_str());
+    long long dataSlot = (long long) (sizeEnd + 1 - text) * 8;
+    if (fileSize <= 0 || fileSize > (capacity - dataSlot) / 8)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    header->name = string(text, nameEnd);
+    header->size = fileSize;
+    header->dataSlot = dataSlot;
+    stegoDefaultOptions(&header->options);
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: countSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool countSlots(JpegCarrier *carrier)
+**              JpegCarrier *carrier -- Carrier to count the slots of
+**
+**
+** Returns:
+**			bool -- False if the coefficients could not be read
+**
+** Notes:
+** Counts the slots of each MCU row, a band at a time with the rows of
+** the band shared out between the cores, and then adds them up.
+**********************************************************************/
+static bool countSlots(JpegCarrier *carrier)
+{
+    int numRows = (int) carrier->info.total_iMCU_rows;
+    carrier->before.assign((size_t) numRows + 1, 0);
+
+    JpegBand band;
+    for (int first = 0; first < numRows; first += JPEG_BAND_ROWS)
+    {
+        int last = min(first + JPEG_BAND_ROWS, numRows);
+        if (!fetchBand(carrier, first, last, false, &band))
+        {
+            return false;
+        }
+
+        int numThreads = min((int) thread::hardware_concurrency(), last - first);
+        if (numThreads < 1)
+        {
+            numThreads = 1;
+        }
+
+        int rowsPerThread = (last - first + numThreads - 1) / numThreads;
+        vector<thread> workers;
+        for (int row = first; row < last; row += rowsPerThread)
+        {
+            workers.push_back(thread(countRows, carrier, &band, row, min(row + rowsPerThread, last)));
+        }
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+    }
+
+    //each row holds its own count until now
+    for (int row = 0; row < numRows; row++)
+    {
+        carrier->before[row + 1] += carrier->before[row];
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: countRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void countRows(JpegCarrier *carrier, const JpegBand *band, int firstRow, int lastRow)
+**              JpegCarrier *carrier -- Receives the count of each row
+**              const JpegBand *band -- Band holding the rows
+**              int firstRow -- First MCU row to count
+**              int lastRow -- MCU row after the last to count
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own.
+**********************************************************************/
+static void countRows(JpegCarrier *carrier, const JpegBand *band, int firstRow, int lastRow)
+{
+    int numComponents = carrier->info.num_components;
+
+    for (int row = firstRow; row < lastRow; row++)
+    {
+        long long count = 0;
+        const JBLOCKROW *blockRows = band->blockRows.data()
+                                     + (size_t) (row - band->firstRow) * numComponents * band->rowsPerComponent;
+
+        for (int c = 0; c < numComponents; c++)
+        {
+            int width = (int) carrier->info.comp_info[c].width_in_blocks;
+            for (int i = 0; i < band->rowsPerComponent; i++, blockRows++)
+            {
+                if (*blockRows == NULL)
+                {
+                    continue;
+                }
+
+                for (int b = 0; b < width; b++)
+                {
+                    const JCOEF *coefficients = (*blockRows)[b];
+                    for (int k = 1; k < DCTSIZE2; k++)
+                    {
+                        count += (coefficients[k] >= JPEG_MIN_MAGNITUDE || coefficients[k] <= -JPEG_MIN_MAGNITUDE);
+                    }
+                }
+            }
+        }
+
+        carrier->before[row + 1] = count;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: fetchBand
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool fetchBand(JpegCarrier *carrier, int firstRow, int lastRow, bool writable, JpegBand *band)
+**              JpegCarrier *carrier -- Carrier to fetch the rows from
+**              int firstRow -- First MCU row of the band
+**              int lastRow -- MCU row after the band
+**              bool writable -- True if the coefficients will be changed
+**              JpegBand *band -- Set to the block rows of the band
+**
+**
+** Returns:
+**			bool -- False if libjpeg could not give the rows
+**
+** Notes:
+** libjpeg's virtual arrays are not safe to call from several threads,
+** so the block rows are all fetched here before the threads start.
+** The coefficients are realized in memory, so the rows fetched first
+** stay where they are while the rest of the band is fetched.
+**********************************************************************/
+static bool fetchBand(JpegCarrier *carrier, int firstRow, int lastRow, bool writable, JpegBand *band)
+{
+    j_decompress_ptr info = &carrier->info;
+    band->firstRow = firstRow;
+    band->lastRow = lastRow;
+    band->rowsPerComponent = info->max_v_samp_factor;
+    band->blockRows.assign((size_t) (lastRow - firstRow) * info->num_components * band->rowsPerComponent, NULL);
+
+    if (setjmp(carrier->error.jump))
+    {
+        return false;
+    }
+
+    JBLOCKROW *blockRows = band->blockRows.data();
+    for (int row = firstRow; row < lastRow; row++)
+    {
+        for (int c = 0; c < info->num_components; c++, blockRows += band->rowsPerComponent)
+        {
+            jpeg_component_info *component = info->comp_info + c;
+            JDIMENSION firstBlock = (JDIMENSION) row * component->v_samp_factor;
+            if (firstBlock >= component->height_in_blocks)
+            {
+                continue;
+            }
+
+            JBLOCKARRAY blocks = (*info->mem->access_virt_barray)((j_common_ptr) info, carrier->coefficients[c],
+                                                                  firstBlock, (JDIMENSION) component->v_samp_factor,
+                                                                  writable ? TRUE : FALSE);
+
+            //the array is padded to whole MCUs, the padding holds nothing
+            for (int i = 0; i < component->v_samp_factor && firstBlock + i < component->height_in_blocks; i++)
+            {
+                blockRows[i] = blocks[i];
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: transferBits
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool transferBits(JpegCarrier *carrier, long long firstSlot, long long numBits,
+**                            const unsigned char *source, unsigned char *target)
+**              JpegCarrier *carrier -- Carrier to embed in or retrieve from
+**              long long firstSlot -- Slot of the first bit
+**              long long numBits -- Number of bits
+**              const unsigned char *source -- Bits to embed, NULL to retrieve
+**              unsigned char *target -- Receives the bits retrieved when not embedding
+**
+**
+** Returns:
+**			bool -- False if libjpeg could not give the rows
+**
+** Notes:
+** Works through the bands that hold the slots, sharing each band out
+** between the cores.
+**********************************************************************/
+static bool transferBits(JpegCarrier *carrier, long long firstSlot, long long numBits,
+                         const unsigned char *source, unsigned char *target)
+{
+    int numRows = (int) carrier->before.size() - 1;
+    long long lastSlot = firstSlot + numBits;
+
+    //the last row whose slots start at or before the first one
+    int row = (int) (upper_bound(carrier->before.begin(), carrier->before.end(), firstSlot) - carrier->before.begin()) - 1;
+
+    JpegBand band;
+    while (row < numRows && carrier->before[row] < lastSlot)
+    {
+        int last = min(row + JPEG_BAND_ROWS, numRows);
+        if (!fetchBand(carrier, row, last, source != NULL, &band))
+        {
+            return false;
+        }
+
+        long long from = max(carrier->before[row], firstSlot);
+        long long to = min(carrier->before[last], lastSlot);
+        int numThreads = threadsForSlots(to - from);
+
+        //embedding threads own whole MCU rows, so none reads a coefficient another
+        //is writing. Retrieving only reads them, so its threads meet on byte
+        //boundaries of the bits instead, and none writes a byte another writes.
+        vector<thread> workers;
+        if (source != NULL)
+        {
+            int rowsPerThread = (last - row + numThreads - 1) / numThreads;
+            for (int first = row; first < last; first += rowsPerThread)
+            {
+                long long next = min(carrier->before[min(first + rowsPerThread, last)], to);
+                if (from < next)
+                {
+                    workers.push_back(thread(transferSlots, carrier, &band, from, next, firstSlot, source, target));
+                    from = next;
+                }
+            }
+        }
+        else
+        {
+            long long share = (to - from + numThreads - 1) / numThreads + 8;
+            while (from < to)
+            {
+                long long next = min(firstSlot + (from - firstSlot + share) / 8 * 8, to);
+                workers.push_back(thread(transferSlots, carrier, &band, from, next, firstSlot, source, target));
+                from = next;
+            }
+        }
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+
+        row = last;
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: transferSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void transferSlots(const JpegCarrier *carrier, const JpegBand *band, long long fromSlot,
+**                             long long toSlot, long long firstSlot, const unsigned char *source,
+**                             unsigned char *target)
+**              const JpegCarrier *carrier -- Carrier to embed in or retrieve from
+**              const JpegBand *band -- Band holding the slots
+**              long long fromSlot -- First slot to work on
+**              long long toSlot -- Slot after the last to work on
+**              long long firstSlot -- Slot of bit 0 of the bits
+**              const unsigned char *source -- Bits to embed, NULL to retrieve
+**              unsigned char *target -- Receives the bits retrieved when not embedding
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own. Bits go into the lowest bit of the
+** coefficient's magnitude, highest bit of each byte first, which
+** keeps the magnitude at JPEG_MIN_MAGNITUDE or more.
+**********************************************************************/
+static void transferSlots(const JpegCarrier *carrier, const JpegBand *band, long long fromSlot,
+                          long long toSlot, long long firstSlot, const unsigned char *source,
+                          unsigned char *target)
+{
+    int numComponents = carrier->info.num_components;
+    const long long *before = carrier->before.data();
+    int row = (int) (upper_bound(before + band->firstRow, before + band->lastRow + 1, fromSlot) - before) - 1;
+    long long slot = before[row];
+
+    for (; row < band->lastRow && slot < toSlot; row++)
+    {
+        JBLOCKROW const *blockRows = band->blockRows.data()
+                                     + (size_t) (row - band->firstRow) * numComponents * band->rowsPerComponent;
+
+        for (int c = 0; c < numComponents; c++)
+        {
+            int width = (int) carrier->info.comp_info[c].width_in_blocks;
+            for (int i = 0; i < band->rowsPerComponent; i++, blockRows++)
+            {
+                if (*blockRows == NULL)
+                {
+                    continue;
+                }
+
+                for (int b = 0; b < width; b++)
+                {
+                    JCOEF *coefficients = (*blockRows)[b];
+                    for (int k = 1; k < DCTSIZE2; k++)
+                    {
+                        int value = coefficients[k];
+                        int magnitude = (value < 0) ? -value : value;
+                        if (magnitude < JPEG_MIN_MAGNITUDE)
+                        {
+                            continue;
+                        }
+
+                        if (slot >= fromSlot)
+                        {
+                            long long bit = slot - firstSlot;
+                            unsigned char mask = (unsigned char) (0x80 >> (bit & 7));
+                            if (source != NULL)
+                            {
+                                magnitude = (magnitude & ~1) | ((source[bit >> 3] & mask) != 0);
+                                coefficients[k] = (JCOEF) ((value < 0) ? -magnitude : magnitude);
+                            }
+                            else if (magnitude & 1)
+                            {
+                                target[bit >> 3] |= mask;
+                            }
+                            else
+                            {
+                                target[bit >> 3] &= (unsigned char) ~mask;
+                            }
+                        }
+
+                        if (++slot >= toSlot)
+                        {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: threadsForSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int threadsForSlots(long long numSlots)
+**              long long numSlots -- Slots to work on
+**
+**
+** Returns:
+**			int -- Number of threads to share them between
+**
+** Notes:
+** Small runs of slots, like the header, are not worth a thread each.
+**********************************************************************/
+static int threadsForSlots(long long numSlots)
+{
+    long long numThreads = (long long) thread::hardware_concurrency();
+    if (numThreads > numSlots / JPEG_MIN_THREAD_SLOTS)
+    {
+        numThreads = numSlots / JPEG_MIN_THREAD_SLOTS;
+    }
+
+    return (numThreads < 1) ? 1 : (int) numThreads;
+}
@@ -0,0 +1,19 @@
+#ifndef JPEGSTEGO_H
+#define JPEGSTEGO_H
+
+#include <string>
+#include <vector>
+#include "stegoCore.h"
+
+#define JPEG_BAND_ROWS 16           //MCU rows shared out between the cores at once
+#define JPEG_MIN_MAGNITUDE 2        //smallest AC coefficient that holds a bit
+#define JPEG_MIN_THREAD_SLOTS 65536 //fewest slots worth a thread of their own
+
+bool jpegIsCarrier(const std::string &);
+long long jpegCapacity(const std::string &);
+long long jpegJobMemory(const std::string &);
+int jpegEmbed(const std::string &, const std::string &, const std::string &, const char *, long long);
+int jpegReadHeader(const std::string &, SecretHeader *);
+int jpegExtract(const std::string &, std::string *, std::vector<char> *);
+
+#endif // JPEGSTEGO_H
@@ -5,6 +5,15 @@
 **
 **	FUNCTIONS:
 **             int main(int argc, char *argv[])
+**             int runDaemon(int argc, char *argv[])
+**             int runExtract(int argc, char *argv[])
+**             int runEmbed(int argc, char *argv[])
+**             int runIndex(int argc, char *argv[])
+**             int runFit(int argc, char *argv[])
+**             bool parseRange(const char *, long long *, long long *)
+**             bool writeOutput(void *, const char *, long)
+**             long readInput(void *, char *, long)
+**             int finishTrace(int, const char *)
 **
 **	DATE: 		September 22nd, 2016
 **
@@ -15,10 +24,41 @@
 **	PROGRAMMER: Rhea Lauzon A00881688
 **
 **	NOTES:
-** Main runner of the GUI application.
+** Main runner of the GUI application. Started with --daemon it runs
+** without a window as a job server instead (see stegoDaemon), and
+** started with --extract it retrieves a secret, or a byte range of
+** it, to a file or standard output. --embed embeds a secret read from
+** standard input or a pipe as it arrives. --index and --fit keep an index of
+** a folder of carriers and pick the smallest one a secret fits in (see
+** carrierIndex). --extract and --embed print the time of each stage
+** to standard error, and --trace <file> saves them as a Chrome trace.
 *************************************************************************/
 #include "mainWindow.h"
+#include "stegoDaemon.h"
+#include "bufferPool.h"
+#include "carrierCache.h"
+#include "imageStego.h"
+#include "carrierIndex.h"
+#include "stegoTrace.h"
 #include <QApplication>
+#include <QCoreApplication>
+#include <QImageReader>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+int runDaemon(int argc, char *argv[]);
+int runExtract(int argc, char *argv[]);
+int runEmbed(int argc, char *argv[]);
+int runIndex(int argc, char *argv[]);
+int runFit(int argc, char *argv[]);
+static bool parseRange(const char *, long long *, long long *);
+static bool writeOutput(void *, const char *, long);
+static long readInput(void *, char *, long);
+static int finishTrace(int, const char *);
 
 
 /*****************************************************************
@@ -27,7 +67,13 @@
 ** Date: September 22nd, 2016
 **
 ** Revisions:
-**
+** October 19th, 2026 - Can start the daemon instead of the GUI
+** October 19th, 2026 - Sets the memory budget of jobs
+** October 19th, 2026 - Can extract a secret without the GUI
+** October 19th, 2026 - Can index a folder of carriers and pick one that fits
+** October 19th, 2026 - Sets the size of the carrier cache
+** October 19th, 2026 - Can embed a secret streamed in without the GUI
+** October 19th, 2026 - Lifts the image allocation limit for every reader
 **
 ** Designer: Rhea Lauzon
 **
@@ -42,13 +88,741 @@
 **			int -- Status of success or failure
 **
 ** Notes:
-** Runner of the application. Sets up the GUI
+** Runner of the application. Sets up the GUI, or the daemon or an
+** extraction when asked for one. --memory-budget sets how many megabytes the queued
+** or daemon jobs may hold at once, and --carrier-cache how many the
+** decoded carriers kept for the next job on them may hold (0 for none).
 *******************************************************************/
 int main(int argc, char *argv[])
 {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    //carriers can be far bigger than Qt's default allocation limit, in the
+    //window, the queued jobs and the daemon alike
+    QImageReader::setAllocationLimit(0);
+#endif
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--memory-budget") == 0 && atoi(argv[i + 1]) > 0)
+        {
+            setMemoryBudget((long long) atoi(argv[i + 1]) * 1024 * 1024);
+        }
+        if (strcmp(argv[i], "--carrier-cache") == 0 && atoi(argv[i + 1]) >= 0)
+        {
+            setCarrierCacheBudget((long long) atoi(argv[i + 1]) * 1024 * 1024);
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--daemon") == 0)
+        {
+            return runDaemon(argc, argv);
+        }
+        if (strcmp(argv[i], "--extract") == 0)
+        {
+            return runExtract(argc, argv);
+        }
+        if (strcmp(argv[i], "--embed") == 0)
+        {
+            return runEmbed(argc, argv);
+        }
+        if (strcmp(argv[i], "--index") == 0)
+        {
+            return runIndex(argc, argv);
+        }
+        if (strcmp(argv[i], "--fit") == 0)
+        {
+            return runFit(argc, argv);
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
 
     return a.exec();
 }
+
+
+
+/*****************************************************************
+** Function: runDaemon
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int runDaemon(int argc, char *argv[])
+**              int argc -- Number of arguments
+**              char *argv[] -- Array of command line arguments
+**
+** Returns:
+**			int -- Status of success or failure
+**
+** Notes:
+** Runs the job server until it is killed. The socket name, the number
+** of worker threads and the most jobs that may wait can be set with
+** --socket, --threads and --max-pending.
+*******************************************************************/
+int runDaemon(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QString socketName = DEFAULT_SOCKET_NAME;
+    int numThreads = 0;
+    int maxPending = 0;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--socket") == 0)
+        {
+            socketName = QString::fromLocal8Bit(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-pending") == 0)
+        {
+            maxPending = atoi(argv[++i]);
+        }
+    }
+
+    StegoDaemon daemon;
+    if (!daemon.listen(socketName, numThreads, maxPending))
+    {
+        fprintf(stderr, "Could not listen on %s\n", socketName.toLocal8Bit().constData());
+        return 1;
+    }
+
+    return a.exec();
+}
+
+
+
+/*****************************************************************
+** Function: runExtract
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Removes the output when the retrieve fails
+** October 19th, 2026 - Traces the retrieve
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int runExtract(int argc, char *argv[])
+**              int argc -- Number of arguments
+**              char *argv[] -- Array of command line arguments
+**
+** Returns:
+**			int -- Status of success or failure
+**
+** Notes:
+** Takes --extract <carrier> <bits> <output>, where the bits are
+** listed as for the daemon and an output of - is standard output.
+** With --range offset:length only that range of the secret is
+** retrieved, reading just the pixels that hold it. An output file is
+** removed again if the secret could not be written to it whole. The
+** retrieve is traced like a job of the window, see finishTrace.
+*******************************************************************/
+int runExtract(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const char *paths[3];
+    int numPaths = 0;
+    bool ranged = false;
+    long long offset = 0;
+    long long length = 0;
+    const char *traceFile = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            traceFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc)
+        {
+            ranged = true;
+            if (!parseRange(argv[++i], &offset, &length))
+            {
+                fprintf(stderr, "Bad range %s, expected offset:length\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--extract") == 0)
+        {
+            for (; numPaths < 3 && i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0; numPaths++)
+            {
+                paths[numPaths] = argv[++i];
+            }
+        }
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (numPaths < 3 || !StegoDaemon::parseBits(QString::fromLocal8Bit(paths[1]), enabledBits, &detect))
+    {
+        fprintf(stderr, "Usage: --extract <carrier> <bits|auto> <output|-> [--range offset:length] [--trace <file>]\n");
+        return 1;
+    }
+
+    traceStartJob("extract " + QFileInfo(QString::fromLocal8Bit(paths[0])).fileName().toStdString());
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QImage carrier;
+    QImageReader reader(QString::fromLocal8Bit(paths[0]));
+    bool decoded = reader.read(&carrier);
+    traceEnd(&span, (long long) carrier.width() * carrier.height(), carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        fprintf(stderr, "Could not read carrier: %s\n", reader.errorString().toLocal8Bit().constData());
+        return finishTrace(1, traceFile);
+    }
+
+    SecretHeader header;
+    if ((detect && detectBitMask(&carrier, enabledBits) == 0)
+        || readSecretHeader(&carrier, enabledBits, &header) != STEGO_OK)
+    {
+        fprintf(stderr, "No secret found\n");
+        return finishTrace(1, traceFile);
+    }
+
+    if (!ranged)
+    {
+        length = header.size - header.options.archiveIndex - header.options.archiveTail;
+    }
+
+    bool toFile = (strcmp(paths[2], "-") != 0);
+    FILE *output = toFile ? fopen(paths[2], "wb") : stdout;
+    if (output == NULL)
+    {
+        fprintf(stderr, "Could not open %s\n", paths[2]);
+        return finishTrace(1, traceFile);
+    }
+
+    int result = retrieveSecretRange(&carrier, enabledBits, &header, offset, length, writeOutput, output);
+    bool closed = (fflush(output) == 0) && (!toFile || fclose(output) == 0);
+
+    if (result == STEGO_ERROR)
+    {
+        fprintf(stderr, "The range is not in the secret of %lld bytes\n",
+                header.size - header.options.archiveIndex - header.options.archiveTail);
+    }
+    else if (result == STEGO_CORRUPT)
+    {
+        fprintf(stderr, "The secret is too damaged\n");
+    }
+    else if (result == STEGO_WRITE_FAILED || !closed)
+    {
+        fprintf(stderr, "Could not write the secret\n");
+    }
+    else if (result != STEGO_OK)
+    {
+        fprintf(stderr, "No secret found\n");
+    }
+
+    //a partly written secret is not left behind
+    if (toFile && (result != STEGO_OK || !closed))
+    {
+        remove(paths[2]);
+    }
+
+    return finishTrace((result == STEGO_OK && closed) ? 0 : 1, traceFile);
+}
+
+
+
+/*****************************************************************
+** Function: runEmbed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Traces the embed
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int runEmbed(int argc, char *argv[])
+**              int argc -- Number of arguments
+**              char *argv[] -- Array of command line arguments
+**
+** Returns:
+**			int -- Status of success or failure
+**
+** Notes:
+** Takes --embed <carrier> <secret|-> <output> <bits> [options], where
+** a secret of - is standard input. The secret is embedded as it is
+** read, so it can be a pipe whose size is not known until it closes,
+** and is never staged on disk. --name sets the name it is stored
+** under, by default the name of its file or "stdin". The embed is
+** traced like a job of the window, see finishTrace.
+*******************************************************************/
+int runEmbed(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const char *args[5];
+    int numArgs = 0;
+    QString name;
+    const char *traceFile = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            traceFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc)
+        {
+            name = QString::fromLocal8Bit(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--embed") == 0)
+        {
+            for (; numArgs < 5 && i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0; numArgs++)
+            {
+                args[numArgs] = argv[++i];
+            }
+        }
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect = false;
+    StegoOptions options;
+    stegoDefaultOptions(&options);
+
+    if (numArgs < 4 || !StegoDaemon::parseBits(QString::fromLocal8Bit(args[3]), enabledBits, &detect) || detect
+        || (numArgs == 5 && !stegoParseOptions(args[4], &options))
+        || options.archiveIndex != 0 || options.archiveTail != 0)
+    {
+        fprintf(stderr, "Usage: --embed <carrier> <secret|-> <output> <bits> [options] [--name <name>] [--trace <file>]\n");
+        return 1;
+    }
+
+    bool fromStdin = (strcmp(args[1], "-") == 0);
+    if (name.isEmpty())
+    {
+        name = fromStdin ? QString("stdin") : QFileInfo(QString::fromLocal8Bit(args[1])).fileName();
+    }
+
+    traceStartJob("embed " + name.toStdString());
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QImage carrier;
+    QImageReader reader(QString::fromLocal8Bit(args[0]));
+    bool decoded = reader.read(&carrier);
+    traceEnd(&span, (long long) carrier.width() * carrier.height(), carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        fprintf(stderr, "Could not read carrier: %s\n", reader.errorString().toLocal8Bit().constData());
+        return finishTrace(1, traceFile);
+    }
+
+    FILE *input = fromStdin ? stdin : fopen(args[1], "rb");
+    if (input == NULL)
+    {
+        fprintf(stderr, "Could not open %s\n", args[1]);
+        return finishTrace(1, traceFile);
+    }
+
+    long long size;
+    int result = embedSecretStream(&carrier, name.toStdString(), readInput, input, enabledBits, &options, &size);
+    bool readFailed = (ferror(input) != 0);
+    if (!fromStdin)
+    {
+        fclose(input);
+    }
+
+    if (readFailed)
+    {
+        fprintf(stderr, "Could not read the secret\n");
+        return finishTrace(1, traceFile);
+    }
+    if (result == STEGO_TOO_BIG)
+    {
+        fprintf(stderr, "The secret is too big for the carrier\n");
+        return finishTrace(1, traceFile);
+    }
+    if (result == STEGO_READ_FAILED)
+    {
+        fprintf(stderr, "The secret is empty\n");
+        return finishTrace(1, traceFile);
+    }
+    if (result != STEGO_OK)
+    {
+        fprintf(stderr, "Could not embed the secret\n");
+        return finishTrace(1, traceFile);
+    }
+
+    if (!saveCarrier(&carrier, QString::fromLocal8Bit(args[2])))
+    {
+        fprintf(stderr, "Could not save %s\n", args[2]);
+        return finishTrace(1, traceFile);
+    }
+
+    printf("Embedded %lld bytes\n", size);
+    return finishTrace(0, traceFile);
+}
+
+
+
+/*****************************************************************
+** Function: runIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int runIndex(int argc, char *argv[])
+**              int argc -- Number of arguments
+**              char *argv[] -- Array of command line arguments
+**
+** Returns:
+**			int -- Status of success or failure
+**
+** Notes:
+** Takes --index <folder> and brings the index of the carriers in it
+** up to date, reading only the headers of new or changed files.
+** --index-file puts the index somewhere other than the folder and
+** --threads sets how many headers are read at once.
+*******************************************************************/
+int runIndex(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QString folder;
+    QString indexFile;
+    int numThreads = 0;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--index") == 0)
+        {
+            folder = QString::fromLocal8Bit(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--index-file") == 0)
+        {
+            indexFile = QString::fromLocal8Bit(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            numThreads = atoi(argv[++i]);
+        }
+    }
+
+    if (folder.isEmpty())
+    {
+        fprintf(stderr, "Usage: --index <folder> [--index-file <file>] [--threads N]\n");
+        return 1;
+    }
+    if (indexFile.isEmpty())
+    {
+        indexFile = QDir(folder).filePath(CARRIER_INDEX_NAME);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    CarrierIndexStats stats;
+    if (!updateCarrierIndex(folder, indexFile, numThreads, &stats))
+    {
+        fprintf(stderr, "Could not index %s\n", folder.toLocal8Bit().constData());
+        return 1;
+    }
+
+    printf("Indexed %d carriers (%d read, %d unchanged, %d removed, %d not images) in %lld ms\n",
+           stats.carriers, stats.read, stats.kept, stats.removed, stats.unreadable, (long long) timer.elapsed());
+    return 0;
+}
+
+
+
+/*****************************************************************
+** Function: runFit
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int runFit(int argc, char *argv[])
+**              int argc -- Number of arguments
+**              char *argv[] -- Array of command line arguments
+**
+** Returns:
+**			int -- Status of success or failure
+**
+** Notes:
+** Takes --fit <folder> <secret|bytes> <bits> [options] and prints the
+** smallest indexed carrier the secret fits in. Given a number of
+** bytes instead of a file, room is left for the longest name. Only the
+** index is read, so the folder should be indexed first; adaptive
+** options depend on the pixels and can not be answered from it.
+*******************************************************************/
+int runFit(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const char *args[4];
+    int numArgs = 0;
+    QString indexFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--index-file") == 0 && i + 1 < argc)
+        {
+            indexFile = QString::fromLocal8Bit(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--fit") == 0)
+        {
+            for (; numArgs < 4 && i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0; numArgs++)
+            {
+                args[numArgs] = argv[++i];
+            }
+        }
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect = false;
+    StegoOptions options;
+    stegoDefaultOptions(&options);
+
+    if (numArgs < 3 || !StegoDaemon::parseBits(QString::fromLocal8Bit(args[2]), enabledBits, &detect) || detect
+        || (numArgs == 4 && !stegoParseOptions(args[3], &options)) || options.adaptiveThreshold != 0)
+    {
+        fprintf(stderr, "Usage: --fit <folder> <secret|bytes> <bits> [options] [--index-file <file>]\n");
+        return 1;
+    }
+
+    QString folder = QString::fromLocal8Bit(args[0]);
+    if (indexFile.isEmpty())
+    {
+        indexFile = QDir(folder).filePath(CARRIER_INDEX_NAME);
+    }
+
+    std::string name;
+    long long size;
+    QFileInfo secret(QString::fromLocal8Bit(args[1]));
+    if (secret.isFile())
+    {
+        name = secret.fileName().toStdString();
+        size = secret.size();
+    }
+    else
+    {
+        char *end;
+        size = strtoll(args[1], &end, 10);
+        if (end == args[1] || *end != '\0' || size < 0)
+        {
+            fprintf(stderr, "No secret %s\n", args[1]);
+            return 1;
+        }
+        name.assign(MAX_NAME_LENGTH, 'x');
+    }
+
+    QVector<CarrierEntry> entries;
+    if (!loadCarrierIndex(indexFile, &entries))
+    {
+        fprintf(stderr, "No index of %s, run --index first\n", folder.toLocal8Bit().constData());
+        return 1;
+    }
+
+    int found = findSmallestCarrier(entries, name, size, enabledBits, &options);
+    if (found < 0)
+    {
+        fprintf(stderr, "No carrier fits %lld bytes\n", size);
+        return 1;
+    }
+
+    int numBits = 0;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        numBits += enabledBits[i] ? 1 : 0;
+    }
+
+    const CarrierEntry &entry = entries[found];
+    printf("%s\t%dx%d\t%lld bytes\n", QDir(folder).filePath(entry.path).toLocal8Bit().constData(),
+           entry.width, entry.height, (long long) entry.capacity[numBits - 1]);
+    return 0;
+}
+
+
+
+/*****************************************************************
+** Function: parseRange
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			bool parseRange(const char *text, long long *offset, long long *length)
+**              const char *text -- Range written as offset:length
+**              long long *offset -- Set to the first byte
+**              long long *length -- Set to the number of bytes
+**
+** Returns:
+**			bool -- False if the text is not a valid range
+*******************************************************************/
+static bool parseRange(const char *text, long long *offset, long long *length)
+{
+    char *end;
+    *offset = strtoll(text, &end, 10);
+    if (end == text || *end != ':' || *offset < 0)
+    {
+        return false;
+    }
+
+    const char *rest = end + 1;
+    *length = strtoll(rest, &end, 10);
+    return end != rest && *end == '\0' && *length >= 0;
+}
+
+
+
+/*****************************************************************
+** Function: writeOutput
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			bool writeOutput(void *output, const char *data, long length)
+**              void *output -- FILE the secret is written to
+**              const char *data -- Part of the secret
+**              long length -- Bytes in the part
+**
+** Returns:
+**			bool -- False if the part could not be written
+*******************************************************************/
+static bool writeOutput(void *output, const char *data, long length)
+{
+    return fwrite(data, 1, (size_t) length, (FILE *) output) == (size_t) length;
+}
+
+
+
+/*****************************************************************
+** Function: readInput
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			long readInput(void *input, char *buffer, long length)
+**              void *input -- FILE the secret is read from
+**              char *buffer -- Receives the next bytes of the secret
+**              long length -- Most bytes to read
+**
+** Returns:
+**			long -- Number of bytes read, 0 at the end or on an error
+*******************************************************************/
+static long readInput(void *input, char *buffer, long length)
+{
+    return (long) fread(buffer, 1, (size_t) length, (FILE *) input);
+}
+
+
+
+/*****************************************************************
+** Function: finishTrace
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**			int finishTrace(int status, const char *traceFile)
+**              int status -- Status the command ends with
+**              const char *traceFile -- Chrome trace to save, or NULL
+**
+** Returns:
+**			int -- The status, or 1 if the trace could not be saved
+**
+** Notes:
+** Ends the traced job of --extract or --embed and prints its one line
+** summary to standard error, which leaves standard output to the
+** secret.
+*******************************************************************/
+static int finishTrace(int status, const char *traceFile)
+{
+    std::string summary = traceFinishJob();
+    if (!summary.empty())
+    {
+        fprintf(stderr, "%s\n", summary.c_str());
+    }
+
+    if (traceFile != NULL && !traceWriteChrome(traceFile))
+    {
+        fprintf(stderr, "Could not write the trace to %s\n", traceFile);
+        return 1;
+    }
+
+    return status;
+}
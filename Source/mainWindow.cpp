@@ -9,10 +9,26 @@
 **   void determineSizeCapacity()
 **   int checkFileSize(ifstream *)
 **   void updateImage(QString, QString)
+**   void queueJobs(QStringList)
 **   void clearCarrierImage()
 **   void retrieveSecretImage()
 **   void updateBitPositions()
+**   void updateView()
 **   void displayHelp()
+**   void processPendingDrops()
+**   void setCarrierFormat(QImage::Format)
+**   void showBitPositions(const bool *)
+**   void carrierHeaderRead(int, QSize, int)
+**   void carrierPreviewReady(int, QImage)
+**   void carrierLoaded(int, QImage)
+**   void carrierJpegCapacityRead(int, qint64)
+**   void carrierLoadFailed(int, QString)
+**   int addJob(QString, QImage, QString, QString)
+**   void updateJobSummary()
+**   void jobStarted(int)
+**   void jobFinished(int, bool, QString, qint64, qint64, QString)
+**   void showTrace(QString)
+**   void exportTrace()
 
 **
 **
@@ -34,9 +50,16 @@
 #include <QUrl>
 #include <QDir>
 #include <QErrorMessage>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QFileDialog>
+#include <QStatusBar>
 #include "mainWindow.h"
 #include "ui_mainWindow.h"
 #include "imageStego.h"
+#include "jpegStego.h"
+#include "stegoTrace.h"
+#include "reedSolomon.h"
 
 using namespace std;
 
@@ -47,6 +70,16 @@ using namespace std;
 ** Date: September 23rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Sets up the background carrier loader
+** October 19th, 2026 - Connects the high bit positions
+** October 19th, 2026 - Shows the stage times of each job
+** October 19th, 2026 - Connects the adaptive embedding options
+** October 19th, 2026 - Connects the matrix embedding options
+** October 19th, 2026 - Connects LSB matching
+** October 19th, 2026 - Connects keeping JPEG carriers
+** October 19th, 2026 - Connects error correction
+** October 19th, 2026 - Connects the view of the carrier
+** October 19th, 2026 - Connects the coefficient count of JPEG carriers
 **
 **
 ** Designer: Rhea Lauzon
@@ -80,6 +113,7 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->actionClear_Image, SIGNAL(triggered(bool)), this, SLOT(clearCarrierImage()));
     connect(ui->actionRetrieve_Secret, SIGNAL(triggered(bool)), this, SLOT(retrieveSecretImage()));
     connect(ui->actionHow_to_Use, SIGNAL(triggered(bool)), this, SLOT(displayHelp()));
+    connect(ui->actionExport_Trace, SIGNAL(triggered(bool)), this, SLOT(exportTrace()));
 
     //setup the slot on the "Clear carrier" button onClick
     connect(ui->clearCarrierBtn, SIGNAL(clicked()), this, SLOT(clearCarrierImage()));
@@ -97,11 +131,80 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->bit6,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
     connect(ui->bit7,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
 
+    //the high bits can only be used by 16 bit carriers
+    connect(ui->bit8,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit9,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit10,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit11,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit12,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit13,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit14,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->bit15,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+
+    //adaptive embedding only uses the textured pixels, which changes the capacity
+    connect(ui->adaptiveBox,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->adaptiveThreshold,SIGNAL(valueChanged(int)),this, SLOT(updateBitPositions()));
+
+    //matrix embedding holds fewer bits in the same slots
+    connect(ui->matrixBox,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->matrixBits,SIGNAL(valueChanged(int)),this, SLOT(updateBitPositions()));
+    connect(ui->matchingBox,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+
+    //the parity of error correction takes room from the secret
+    connect(ui->fecBox,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    connect(ui->fecParity,SIGNAL(valueChanged(int)),this, SLOT(updateBitPositions()));
+
+    //a JPEG carrier kept as a JPEG holds its secret in the DCT coefficients
+    connect(ui->jpegBox,SIGNAL(toggled(bool)),this, SLOT(updateBitPositions()));
+    jpegCarrier = false;
+    jpegSecretSize = 0;
+    carrierDepth = NUM_BITS;
+    carrierNumChannels = NUM_CHANNELS;
+    stegoDefaultOptions(&options);
+    clearCapacityCache(&capacityCache);
+    ui->adaptiveThreshold->setEnabled(false);
+    ui->matrixBits->setEnabled(false);
+    ui->fecParity->setEnabled(false);
+
+    //the view can show bit planes and the changes made by the secret
+    connect(ui->viewModeBox,SIGNAL(currentIndexChanged(int)),this, SLOT(updateView()));
+    connect(ui->viewChannelBox,SIGNAL(currentIndexChanged(int)),this, SLOT(updateView()));
+    connect(ui->viewBitBox,SIGNAL(valueChanged(int)),this, SLOT(updateView()));
+    ui->viewChannelBox->setEnabled(false);
+    ui->viewBitBox->setEnabled(false);
+
+    //no bit positions are read until the first carrier is dropped
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        enabledBits[i] = false;
+    }
 
 
     //initialize the pointer to the carrier image
     carrierImage = new QImage();
 
+    //carriers are decoded in the background and reported in stages
+    loader = new CarrierLoader(this);
+    carrierTicket = -1;
+    connect(loader, SIGNAL(headerRead(int, QSize, int)), this, SLOT(carrierHeaderRead(int, QSize, int)));
+    connect(loader, SIGNAL(previewReady(int, QImage)), this, SLOT(carrierPreviewReady(int, QImage)));
+    connect(loader, SIGNAL(imageReady(int, QImage)), this, SLOT(carrierLoaded(int, QImage)));
+    connect(loader, SIGNAL(jpegCapacityRead(int, qint64)), this, SLOT(carrierJpegCapacityRead(int, qint64)));
+    connect(loader, SIGNAL(loadFailed(int, QString)), this, SLOT(carrierLoadFailed(int, QString)));
+    connect(loader, SIGNAL(traced(QString)), this, SLOT(showTrace(QString)));
+
+    //several files dropped at once are embedded on a pool of workers
+    jobs = new JobQueue(this);
+    jobsQueued = 0;
+    jobsFinished = 0;
+    jobsFailed = 0;
+    runBytes = 0;
+    jpegEmbedJob = -1;
+    jpegRetrieveJob = -1;
+    connect(jobs, SIGNAL(jobStarted(int)), this, SLOT(jobStarted(int)));
+    connect(jobs, SIGNAL(jobFinished(int, bool, QString, qint64, qint64, QString)),
+            this, SLOT(jobFinished(int, bool, QString, qint64, qint64, QString)));
+
     //initialize message boxes for displaying data
     stegoMsgBox.setText("Secret file has been embedded in the image.");
     stegoMsgBox.addButton("OK", QMessageBox::AcceptRole);
@@ -120,6 +223,8 @@ MainWindow::MainWindow(QWidget *parent) :
 ** Date: September 23rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Stops the carrier loader
+** October 19th, 2026 - Frees the carrier
 **
 **
 ** Designer: Rhea Lauzon
@@ -137,6 +242,11 @@ MainWindow::MainWindow(QWidget *parent) :
 *******************************************************************/
 MainWindow::~MainWindow()
 {
+    //stop any load or job in progress before the window goes away
+    delete loader;
+    delete jobs;
+
+    delete carrierImage;
     delete ui;
 }
 
@@ -147,6 +257,16 @@ MainWindow::~MainWindow()
 ** Date: September 24th, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Displays the carrier through the tiled image view
+** October 19th, 2026 - Refreshes only the rows changed by the embed
+** October 19th, 2026 - Loads the carrier in the background and queues drops
+** October 19th, 2026 - Reports failed embeds and names 16 bit output secret.png
+** October 19th, 2026 - Traces the embed
+** October 19th, 2026 - Closes the secret file after the embed
+** October 19th, 2026 - Embeds with the chosen options
+** October 19th, 2026 - Embeds JPEG carriers in their coefficients when kept as JPEG
+** October 19th, 2026 - Keeps the carrier as it was for the difference views
+** October 19th, 2026 - Embeds in JPEG carriers kept as JPEG on the job queue
 **
 **
 ** Designer: Rhea Lauzon
@@ -172,55 +292,71 @@ void MainWindow::updateImage(QString filePath, QString localName)
     //get the number of bits and their positions
     updateBitPositions();
 
+    //files dropped while the carrier is still loading wait their turn
+    if (carrierTicket != -1)
+    {
+        pendingDrops.enqueue(qMakePair(filePath, localName));
+        return;
+    }
+
     //check if we have a carrier (first file dropped)
     if (carrierImage->isNull())
     {
-        //load the new image into the view
-        if (carrierImage->load(filePath))
-        {
-            currPixmap = QPixmap::fromImage(*carrierImage);
-            scene->addPixmap(currPixmap);
-            scene->setSceneRect(carrierImage->rect());
-
-            //determine file size
-            determineSizeCapacity();
-
-            //update the GUI with the file path
-            ui->displayImgPath->setText(filePath);
-
-        }
-        else
-        {
-            error.showMessage("Unable to open the file.");
-        }
+        //load the new image in the background, the loader reports back as it goes
+        carrierTicket = loader->load(filePath);
+        carrierPath = filePath;
+        jpegCarrier = jpegIsCarrier(filePath.toStdString());
+        jpegSecretSize = 0;
+        ui->displayImgPath->setText(filePath + " (loading...)");
     }
 
     //second file dropped, so embed it since it is the secret
     else
     {
-        secret = new ifstream(filePath.toStdString(), ios_base::binary);
+        ifstream secret(filePath.toStdString(), ios_base::binary);
 
-        if (secret->is_open())
+        if (secret.is_open())
         {
             //check the file size first
-            int secretSize = checkFileSize(secret);
+            int secretSize = checkFileSize(&secret);
 
-            if (secretSize < maxSecretSize)
+            //the coefficients are read from the file, which a job does off the GUI thread;
+            //the decoded carrier is only shown
+            if (secretSize < maxSecretSize && ui->jpegBox->isChecked() && jpegCarrier)
             {
-                //embed the secret
-                embedSecret(carrierImage, secret, localName.toStdString(), secretSize, enabledBits, numBitsPerChannel);
+                jpegEmbedJob = addJob(carrierPath, QImage(), filePath, "secret");
+            }
+            else if (secretSize < maxSecretSize)
+            {
+                //keep the carrier from before its first secret to compare against
+                if (originalImage.isNull())
+                {
+                    originalImage = *carrierImage;
+                }
 
+                //embed the secret
+                traceStartJob("embed " + localName.toStdString());
+                int result = embedSecret(carrierImage, &secret, localName.toStdString(), secretSize, enabledBits, &options);
+                showTrace(QString::fromStdString(traceFinishJob()));
 
-                //clear the scene to reload the changes
-                scene->clear();
+                if (result != 0)
+                {
+                    error.showMessage("Secret file is too large to embed.");
+                    return;
+                }
 
-                //add the new image
-                currPixmap = QPixmap::fromImage(*carrierImage);
-                scene->addPixmap(currPixmap);
-                scene->setSceneRect(carrierImage->rect());
+                //only redraw the rows the secret was written into
+                int firstRow;
+                int lastRow;
+                if (getModifiedRows(&firstRow, &lastRow))
+                {
+                    ui->mainImage->refreshRows(firstRow, lastRow);
+                }
+                ui->mainImage->setReference(&originalImage);
 
                 //update the GUI since the file is now manipulated
-                ui->displayImgPath->setText("secret.bmp");
+                QString outputFile = QString::fromStdString(outputFileName(carrierImage));
+                ui->displayImgPath->setText(outputFile);
 
                 stegoMsgBox.exec();
 
@@ -228,7 +364,7 @@ void MainWindow::updateImage(QString filePath, QString localName)
                 if (stegoMsgBox.clickedButton() == openFile)
                 {
                     //open the file
-                    QDesktopServices::openUrl(QString::fromStdString("secret.bmp"));
+                    QDesktopServices::openUrl(outputFile);
 
                 }
 
@@ -252,6 +388,15 @@ void MainWindow::updateImage(QString filePath, QString localName)
 ** Date: September 24th, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Uses the carrier size read from the header
+** October 19th, 2026 - Counts capacity in 64 bits for very large carriers
+** October 19th, 2026 - Uses the number of channels of the carrier's format
+** October 19th, 2026 - Counts only the textured pixels when embedding adaptively
+** October 19th, 2026 - Counts k bits per block for matrix embedding
+** October 19th, 2026 - Counts the coefficients of a JPEG carrier kept as JPEG
+** October 19th, 2026 - Leaves out the parity of error correction
+** October 19th, 2026 - Uses the coefficients counted by the carrier loader
+** October 19th, 2026 - Keeps the carrier prepared for counting textured pixels
 **
 **
 ** Designer: Rhea Lauzon
@@ -267,13 +412,38 @@ void MainWindow::updateImage(QString filePath, QString localName)
 ** Notes:
 ** Determines the maximum amount of data that can be embedded
 ** into the carrier image based off the size and the number
-** of bits per channnel.
+** of bits per channnel. When embedding adaptively the textured
+** pixels are counted once the carrier is decoded; until then the
+** whole carrier is shown as an upper bound.
 **********************************************************************/
 void MainWindow::determineSizeCapacity()
 {
-    if (!carrierImage->isNull())
+    //a JPEG kept as a JPEG holds a bit in each of its larger AC coefficients
+    if (ui->jpegBox->isChecked() && jpegCarrier)
+    {
+        maxSecretSize = jpegSecretSize;
+        ui->fileSize->setText(QString::number(maxSecretSize));
+    }
+    else if (options.adaptiveThreshold != 0 && !carrierImage->isNull())
+    {
+        maxSecretSize = carrierCapacity(carrierImage, enabledBits, &options, &capacityCache);
+        ui->fileSize->setText(QString::number(maxSecretSize));
+    }
+
+    //the size is known from the header before the carrier is decoded
+    else if (carrierSize.isValid())
     {
-        maxSecretSize = (carrierImage->width() * carrierImage->height() * 3 * numBitsPerChannel) / 8;
+        long long numSlots = (long long) carrierSize.width() * carrierSize.height() * carrierNumChannels * numBitsPerChannel;
+        if (options.matrixBits != 0)
+        {
+            numSlots = (numSlots >> options.matrixBits) * options.matrixBits;
+        }
+        if (options.fecParity != 0)
+        {
+            numSlots = numSlots / RS_CODEWORD_LENGTH * (RS_CODEWORD_LENGTH - options.fecParity);
+        }
+
+        maxSecretSize = numSlots / 8;
         ui->fileSize->setText(QString::number(maxSecretSize));
     }
     else
@@ -289,6 +459,12 @@ void MainWindow::determineSizeCapacity()
 ** Date: October 3rd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Reads the high bit positions for 16 bit carriers
+** October 19th, 2026 - Reads the adaptive embedding threshold
+** October 19th, 2026 - Reads the matrix embedding block bits
+** October 19th, 2026 - Reads LSB matching, which rules out adaptive embedding
+** October 19th, 2026 - Reads the error correction parity
+** October 19th, 2026 - Updates the view for the depth and bits of the carrier
 **
 **
 ** Designer: Rhea Lauzon
@@ -304,7 +480,8 @@ void MainWindow::determineSizeCapacity()
 ** Notes:
 ** Updates the "enabled bits" which are the bits that are
 ** available in each color channel of the image for manipulation,
-** then recalculates the size capacity of the image.
+** and the embedding options, then recalculates the size capacity
+** of the image.
 **********************************************************************/
 void MainWindow::updateBitPositions()
 {
@@ -319,7 +496,18 @@ void MainWindow::updateBitPositions()
     enabledBits[6] = ui->bit6->isChecked();
     enabledBits[7] = ui->bit7->isChecked();
 
-    for (int i = 0; i < 8; i++)
+    //the high bits only exist in 16 bit carriers
+    bool highBits = (carrierDepth == 16);
+    enabledBits[8] = highBits && ui->bit8->isChecked();
+    enabledBits[9] = highBits && ui->bit9->isChecked();
+    enabledBits[10] = highBits && ui->bit10->isChecked();
+    enabledBits[11] = highBits && ui->bit11->isChecked();
+    enabledBits[12] = highBits && ui->bit12->isChecked();
+    enabledBits[13] = highBits && ui->bit13->isChecked();
+    enabledBits[14] = highBits && ui->bit14->isChecked();
+    enabledBits[15] = highBits && ui->bit15->isChecked();
+
+    for (int i = 0; i < MAX_NUM_BITS; i++)
     {
         if (enabledBits[i])
         {
@@ -327,8 +515,84 @@ void MainWindow::updateBitPositions()
         }
     }
 
+    //a threshold of 0 embeds in every pixel
+    stegoDefaultOptions(&options);
+    if (ui->adaptiveBox->isChecked())
+    {
+        options.adaptiveThreshold = ui->adaptiveThreshold->value();
+    }
+    ui->adaptiveThreshold->setEnabled(ui->adaptiveBox->isChecked());
+
+    if (ui->matrixBox->isChecked())
+    {
+        options.matrixBits = ui->matrixBits->value();
+    }
+    ui->matrixBits->setEnabled(ui->matrixBox->isChecked());
+
+    if (ui->fecBox->isChecked())
+    {
+        options.fecParity = ui->fecParity->value();
+    }
+    ui->fecParity->setEnabled(ui->fecBox->isChecked());
+
+    //a matching step can change the bits the texture is measured on
+    options.matching = ui->matchingBox->isChecked() ? 1 : 0;
+    ui->adaptiveBox->setEnabled(!ui->matchingBox->isChecked());
+    ui->matchingBox->setEnabled(!ui->adaptiveBox->isChecked());
+
     determineSizeCapacity();
+    updateView();
+
+}
+
+/*****************************************************************
+** Function: updateView
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void updateView()
+**
+** Returns:
+**			void
+**
+** Notes:
+** Shows the carrier, one of its bit planes, its difference from the
+** carrier before the secret went in or a heatmap of the changes. The
+** difference is amplified so the largest change the enabled bit
+** positions can make is shown at full brightness.
+**********************************************************************/
+void MainWindow::updateView()
+{
+    //only the bit positions the carrier has can be shown
+    ui->viewBitBox->setMaximum(carrierDepth - 1);
+
+    ViewSettings view;
+    view.mode = (ViewMode) ui->viewModeBox->currentIndex();
+    view.channel = ui->viewChannelBox->currentIndex() - 1;
+    view.bit = ui->viewBitBox->value();
+
+    unsigned int largest = 0;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        if (enabledBits[i])
+        {
+            largest |= 1u << i;
+        }
+    }
+    view.gain = 255 / qBound(1u, largest, 255u);
 
+    ui->viewBitBox->setEnabled(view.mode == VIEW_BIT_PLANE);
+    ui->viewChannelBox->setEnabled(view.mode != VIEW_IMAGE && carrierNumChannels > 1);
+
+    ui->mainImage->setView(view);
 }
 
 /*****************************************************************
@@ -371,6 +635,13 @@ int MainWindow::checkFileSize(ifstream *file)
 ** Date: October 2nd, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Clears the tiled image view
+** October 19th, 2026 - Cancels a carrier load in progress
+** October 19th, 2026 - Frees the carrier instead of leaking it
+** October 19th, 2026 - Forgets whether the carrier was a JPEG
+** October 19th, 2026 - Forgets the carrier from before the secret
+** October 19th, 2026 - Forgets the coefficients counted in a JPEG carrier
+** October 19th, 2026 - Lets go of the carrier prepared for its capacity
 **
 **
 ** Designer: Rhea Lauzon
@@ -388,11 +659,22 @@ int MainWindow::checkFileSize(ifstream *file)
 **********************************************************************/
 void MainWindow::clearCarrierImage()
 {
-    //set the carrier image back to null on the QImage and Pixmap
-    carrierImage = new QImage();
+    //clear the view before the image it displays goes away
+    ui->mainImage->clearImage();
 
-    //clear the scene
-    scene->clear();
+    //set the carrier image back to null and ignore any load in progress
+    ui->mainImage->setReference(0);
+    originalImage = QImage();
+    *carrierImage = QImage();
+    previewImage = QImage();
+    carrierSize = QSize();
+    carrierTicket = -1;
+    carrierPath.clear();
+    jpegCarrier = false;
+    jpegSecretSize = 0;
+    clearCapacityCache(&capacityCache);
+    pendingDrops.clear();
+    setCarrierFormat(QImage::Format_Invalid);
 
     //update the file size counter
     determineSizeCapacity();
@@ -408,7 +690,10 @@ void MainWindow::clearCarrierImage()
 ** Date: October 3rd, 2016
 **
 ** Revisions:
-**
+** October 19th, 2026 - Can detect the bit positions of the secret
+** October 19th, 2026 - Traces the retrieve
+** October 19th, 2026 - Retrieves from the coefficients of a JPEG kept as JPEG
+** October 19th, 2026 - Retrieves from JPEG carriers on the job queue
 **
 ** Designer: Rhea Lauzon
 **
@@ -423,18 +708,43 @@ void MainWindow::clearCarrierImage()
 ** Notes:
 ** A second file has been dropped into the view, so begin
 ** fetching the secret image out of the colour channels
-** based off the bit positions set.
+** based off the bit positions set. If detection is turned on,
+** the bit positions are found from the image first and shown
+** in the checkboxes.
 **********************************************************************/
 void MainWindow::retrieveSecretImage()
 {
     //only fetch a secret if there is a carrier image in the GUI
     if (!carrierImage->isNull())
     {
+        //the bit positions do not apply to the coefficients, which a job reads from the file
+        if (ui->jpegBox->isChecked() && jpegCarrier)
+        {
+            jpegRetrieveJob = addJob(carrierPath, QImage(), QString(), QString());
+            return;
+        }
+
+        traceStartJob("retrieve");
+
+        if (ui->detectBitsBox->isChecked())
+        {
+            bool detectedBits[MAX_NUM_BITS];
+            if (detectBitMask(carrierImage, detectedBits) == 0)
+            {
+                showTrace(QString::fromStdString(traceFinishJob()));
+                error.showMessage("No secret found.");
+                return;
+            }
+
+            showBitPositions(detectedBits);
+        }
+
         //get the number of bits and their positions in case they have changed
         updateBitPositions();
 
         //retrieve the secret from the image if it exists
         string fileName = retrieveSecret(carrierImage, enabledBits);
+        showTrace(QString::fromStdString(traceFinishJob()));
 
         if (fileName.empty())
         {
@@ -464,6 +774,10 @@ void MainWindow::retrieveSecretImage()
 ** Date: October 4th, 2016
 **
 ** Revisions:
+** October 19th, 2026 - Mentions 16 bit carriers
+** October 19th, 2026 - Mentions bit position detection
+** October 19th, 2026 - Mentions multi-file drops
+** October 19th, 2026 - Mentions stage times and trace export
 **
 **
 ** Designer: Rhea Lauzon
@@ -483,5 +797,700 @@ void MainWindow::displayHelp()
 {
     error.showMessage("This is a tool used for embedding secret files into images (bitmaps) via stegonographic methods. First, drop an image into the large rectangle below. Next\
                 set the bit positions you would like to use for the stegonographic alogrithms. If another file is dropped into the rectangle, it will be embedded into the \
-                carrier and the output will be saved as secret.bmp. If you wish to retrieve a secret, simply press the Retrieve Secret button.");
+                carrier and the output will be saved as secret.bmp (secret.png for 16 bit carriers, which can also use bit positions 8 to 15). If you wish to retrieve a secret, simply press the Retrieve Secret button (check Detect bit positions if you do not know which were used). Dropping several files at once queues one embed job per secret, shown in the job list. The time each stage of a job took is shown in the status bar, and File > Export Trace saves them all as a Chrome trace. Check Textured areas only to embed only in the busy parts of the carrier, where changes are hardest to see; a higher threshold picks fewer, busier pixels and leaves less room for the secret. Check Matrix embedding to change far fewer bits of the carrier for the same secret; each block of 2^k slots then holds k bits (k set by Block bits), so the carrier holds less. Check LSB matching to step the lowest checked bit up or down by one instead of overwriting it, which hides the secret better and is retrieved the same way (it can not be combined with Textured areas only). Check Keep JPEG carriers to embed into a JPEG carrier's DCT coefficients and save secret.jpg, without decoding it to pixels; the bit positions and the other options do not apply, and the secret is retrieved from the coefficients the same way.");
+}
+
+
+/*****************************************************************
+** Function: processPendingDrops
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void processPendingDrops()
+**
+** Returns:
+**			void
+**
+** Notes:
+** Handles the files that were dropped while a carrier was loading,
+** in the order they were dropped. Stops early if one of them starts
+** loading a new carrier.
+**********************************************************************/
+void MainWindow::processPendingDrops()
+{
+    while (!pendingDrops.isEmpty() && carrierTicket == -1)
+    {
+        QPair<QString, QString> drop = pendingDrops.dequeue();
+        updateImage(drop.first, drop.second);
+    }
+}
+
+
+/*****************************************************************
+** Function: setCarrierFormat
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setCarrierFormat(QImage::Format format)
+**              QImage::Format format -- Format of the carrier
+**
+** Returns:
+**			void
+**
+** Notes:
+** Turns the high bit positions on or off to match the depth of the
+** carrier and recalculates the capacity for its number of channels.
+**********************************************************************/
+void MainWindow::setCarrierFormat(QImage::Format format)
+{
+    carrierDepth = carrierBitDepth(format);
+    carrierNumChannels = carrierChannels(format);
+
+    bool highBits = (carrierDepth == 16);
+    ui->bit8->setEnabled(highBits);
+    ui->bit9->setEnabled(highBits);
+    ui->bit10->setEnabled(highBits);
+    ui->bit11->setEnabled(highBits);
+    ui->bit12->setEnabled(highBits);
+    ui->bit13->setEnabled(highBits);
+    ui->bit14->setEnabled(highBits);
+    ui->bit15->setEnabled(highBits);
+
+    updateBitPositions();
+}
+
+
+/*****************************************************************
+** Function: showBitPositions
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void showBitPositions(const bool *positions)
+**              const bool *positions -- Bit positions to check
+**
+** Returns:
+**			void
+**
+** Notes:
+** Checks exactly the given bit positions, which updates the
+** enabled bits and the capacity as well.
+**********************************************************************/
+void MainWindow::showBitPositions(const bool *positions)
+{
+    ui->bit0->setChecked(positions[0]);
+    ui->bit1->setChecked(positions[1]);
+    ui->bit2->setChecked(positions[2]);
+    ui->bit3->setChecked(positions[3]);
+    ui->bit4->setChecked(positions[4]);
+    ui->bit5->setChecked(positions[5]);
+    ui->bit6->setChecked(positions[6]);
+    ui->bit7->setChecked(positions[7]);
+    ui->bit8->setChecked(positions[8]);
+    ui->bit9->setChecked(positions[9]);
+    ui->bit10->setChecked(positions[10]);
+    ui->bit11->setChecked(positions[11]);
+    ui->bit12->setChecked(positions[12]);
+    ui->bit13->setChecked(positions[13]);
+    ui->bit14->setChecked(positions[14]);
+    ui->bit15->setChecked(positions[15]);
+}
+
+
+
+/*****************************************************************
+** Function: carrierHeaderRead
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void carrierHeaderRead(int ticket, QSize size, int format)
+**              int ticket -- Load the header belongs to
+**              QSize size -- Dimensions of the carrier
+**              int format -- QImage format the carrier will decode to
+**
+** Returns:
+**			void
+**
+** Notes:
+** Shows the capacity of the carrier as soon as its dimensions are
+** known, before any pixels are decoded.
+**********************************************************************/
+void MainWindow::carrierHeaderRead(int ticket, QSize size, int format)
+{
+    if (ticket != carrierTicket)
+    {
+        return;
+    }
+
+    carrierSize = size;
+    setCarrierFormat((QImage::Format) format);
+}
+
+
+/*****************************************************************
+** Function: carrierPreviewReady
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void carrierPreviewReady(int ticket, QImage preview)
+**              int ticket -- Load the preview belongs to
+**              QImage preview -- Scaled down carrier
+**
+** Returns:
+**			void
+**
+** Notes:
+** Displays the scaled preview until the full image is ready.
+**********************************************************************/
+void MainWindow::carrierPreviewReady(int ticket, QImage preview)
+{
+    if (ticket != carrierTicket)
+    {
+        return;
+    }
+
+    previewImage = preview;
+    ui->mainImage->setImage(&previewImage);
+}
+
+
+/*****************************************************************
+** Function: carrierLoaded
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void carrierLoaded(int ticket, QImage image)
+**              int ticket -- Load the image belongs to
+**              QImage image -- Fully decoded carrier
+**
+** Returns:
+**			void
+**
+** Notes:
+** Makes the decoded image the carrier, replaces the preview with it
+** and then handles any files that were dropped in the meantime.
+**********************************************************************/
+void MainWindow::carrierLoaded(int ticket, QImage image)
+{
+    if (ticket != carrierTicket)
+    {
+        return;
+    }
+
+    carrierTicket = -1;
+    *carrierImage = image;
+    carrierSize = carrierImage->size();
+
+    //the view lets go of the preview before it is freed
+    ui->mainImage->setImage(carrierImage);
+    previewImage = QImage();
+
+    setCarrierFormat(carrierImage->format());
+    ui->displayImgPath->setText(ui->displayImgPath->text().remove(" (loading...)"));
+
+    processPendingDrops();
+}
+
+
+/*****************************************************************
+** Function: carrierJpegCapacityRead
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void carrierJpegCapacityRead(int ticket, qint64 capacity)
+**              int ticket -- Load that counted the coefficients
+**              qint64 capacity -- Bits the coefficients of the carrier can hold
+**
+** Returns:
+**			void
+**
+** Notes:
+** Keeps the capacity of a JPEG carrier kept as JPEG, so toggling the
+** options never reads the file again. It arrives just before the
+** carrier itself, which shows it.
+**********************************************************************/
+void MainWindow::carrierJpegCapacityRead(int ticket, qint64 capacity)
+{
+    if (ticket != carrierTicket)
+    {
+        return;
+    }
+
+    jpegSecretSize = capacity / 8;
+}
+
+
+/*****************************************************************
+** Function: carrierLoadFailed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Forgets whether the carrier was a JPEG
+** October 19th, 2026 - Forgets the coefficients counted in a JPEG carrier
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void carrierLoadFailed(int ticket, QString reason)
+**              int ticket -- Load that failed
+**              QString reason -- Why the image could not be read
+**
+** Returns:
+**			void
+**
+** Notes:
+** Resets the window back to having no carrier. Files dropped while
+** loading are still handled, so the next one becomes the carrier.
+**********************************************************************/
+void MainWindow::carrierLoadFailed(int ticket, QString reason)
+{
+    if (ticket != carrierTicket)
+    {
+        return;
+    }
+
+    carrierTicket = -1;
+    carrierPath.clear();
+    jpegCarrier = false;
+    jpegSecretSize = 0;
+    ui->mainImage->clearImage();
+    previewImage = QImage();
+    carrierSize = QSize();
+    setCarrierFormat(QImage::Format_Invalid);
+    ui->displayImgPath->setText("");
+
+    error.showMessage("Unable to open the file: " + reason);
+
+    processPendingDrops();
+}
+
+
+
+/*****************************************************************
+** Function: queueJobs
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void queueJobs(QStringList filePaths)
+**              QStringList filePaths -- Files dropped together
+**
+** Returns:
+**			void
+**
+** Notes:
+** Turns a multi-file drop into embed jobs. With a carrier in the
+** window, every file is a secret for that carrier. Otherwise the
+** dropped images are the carriers and the other files are handed
+** out to them in turn; if only images were dropped, the first one
+** is the carrier for the rest. Each job saves its own
+** secret_<job>.bmp (or .png, or .jpg for a JPEG kept as JPEG).
+**********************************************************************/
+void MainWindow::queueJobs(QStringList filePaths)
+{
+    //get the number of bits and their positions
+    updateBitPositions();
+
+    if (numBitsPerChannel == 0)
+    {
+        error.showMessage("No bit positions are selected.");
+        return;
+    }
+
+    //one carrier with many secrets
+    if (!carrierPath.isEmpty())
+    {
+        for (int i = 0; i < filePaths.size(); i++)
+        {
+            //a carrier that is still loading is read again by each job
+            addJob(carrierPath, (carrierTicket == -1) ? *carrierImage : QImage(), filePaths[i], QString());
+        }
+        return;
+    }
+
+    QStringList carriers;
+    QStringList secrets;
+    for (int i = 0; i < filePaths.size(); i++)
+    {
+        if (QImageReader::imageFormat(filePaths[i]).isEmpty())
+        {
+            secrets.append(filePaths[i]);
+        }
+        else
+        {
+            carriers.append(filePaths[i]);
+        }
+    }
+
+    if (carriers.isEmpty())
+    {
+        error.showMessage("None of the dropped files is an image to embed in.");
+        return;
+    }
+
+    if (secrets.isEmpty())
+    {
+        secrets = carriers.mid(1);
+        carriers = carriers.mid(0, 1);
+    }
+
+    //many carriers, taking the secrets round-robin
+    for (int i = 0; i < secrets.size(); i++)
+    {
+        addJob(carriers[i % carriers.size()], QImage(), secrets[i], QString());
+    }
+}
+
+
+
+/*****************************************************************
+** Function: addJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Passes on the embedding options
+** October 19th, 2026 - Passes on whether JPEG carriers are kept as JPEG
+** October 19th, 2026 - Names the output and queues retrieves from JPEG carriers
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int addJob(QString carrierFile, QImage carrier, QString secretFile, QString outputPath)
+**              QString carrierFile -- Path of the carrier
+**              QImage carrier -- Decoded carrier, or null if the job reads it
+**              QString secretFile -- Path of the secret, or empty to retrieve from a JPEG carrier
+**              QString outputPath -- Output without its extension, or empty for secret_<job>
+**
+** Returns:
+**			int -- Number of the job, which is also its row
+**
+** Notes:
+** Adds a row for the job to the job list and queues it with the
+** bit positions and embedding options that are set now.
+**********************************************************************/
+int MainWindow::addJob(QString carrierFile, QImage carrier, QString secretFile, QString outputPath)
+{
+    //a new run starts when nothing is left from the last one
+    if (jobsFinished == jobsQueued)
+    {
+        runBytes = 0;
+        runClock.start();
+    }
+
+    int row = ui->jobTable->rowCount();
+
+    EmbedJob job;
+    job.carrierPath = carrierFile;
+    job.carrier = carrier;
+    job.secretPath = secretFile;
+    job.outputPath = outputPath.isEmpty() ? "secret_" + QString::number(row) : outputPath;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        job.enabledBits[i] = enabledBits[i];
+    }
+    job.options = options;
+    job.keepJpeg = ui->jpegBox->isChecked();
+    job.retrieve = secretFile.isEmpty();
+
+    ui->jobTable->insertRow(row);
+    ui->jobTable->setItem(row, 0, new QTableWidgetItem(QFileInfo(carrierFile).fileName()));
+    ui->jobTable->setItem(row, 1, new QTableWidgetItem(job.retrieve ? "(retrieve)" : QFileInfo(secretFile).fileName()));
+    ui->jobTable->setItem(row, 2, new QTableWidgetItem("Queued"));
+    ui->jobTable->setItem(row, 3, new QTableWidgetItem(""));
+
+    jobs->add(job);
+    jobsQueued++;
+    updateJobSummary();
+
+    return row;
+}
+
+
+
+/*****************************************************************
+** Function: updateJobSummary
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void updateJobSummary()
+**
+** Returns:
+**			void
+**
+** Notes:
+** Shows how far the jobs have got and the throughput of the
+** current run.
+**********************************************************************/
+void MainWindow::updateJobSummary()
+{
+    double seconds = runClock.isValid() ? runClock.nsecsElapsed() / 1e9 : 0;
+    double throughput = (seconds > 0) ? runBytes / seconds / (1024 * 1024) : 0;
+
+    ui->jobSummary->setText(QString("%1 of %2 done, %3 failed, %4 MB/s")
+                            .arg(jobsFinished).arg(jobsQueued).arg(jobsFailed)
+                            .arg(throughput, 0, 'f', 2));
+}
+
+
+
+/*****************************************************************
+** Function: jobStarted
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void jobStarted(int job)
+**              int job -- Number of the job, which is also its row
+**
+** Returns:
+**			void
+**********************************************************************/
+void MainWindow::jobStarted(int job)
+{
+    ui->jobTable->item(job, 2)->setText("Running");
+}
+
+
+
+/*****************************************************************
+** Function: jobFinished
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Shows the stage times of the job
+** October 19th, 2026 - Reports the JPEG embeds and retrieves of the window
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void jobFinished(int job, bool ok, QString message, qint64 bytes,
+**                           qint64 runTime, QString summary)
+**              int job -- Number of the job, which is also its row
+**              bool ok -- True if the secret was embedded and saved, or retrieved
+**              QString message -- Output or secret file, or what went wrong
+**              qint64 bytes -- Size of the secret embedded
+**              qint64 runTime -- How long the job ran, in nanoseconds
+**              QString summary -- Time of each stage of the job
+**
+** Returns:
+**			void
+**********************************************************************/
+void MainWindow::jobFinished(int job, bool ok, QString message, qint64 bytes, qint64 runTime, QString summary)
+{
+    jobsFinished++;
+    ui->jobTable->item(job, 3)->setToolTip(summary);
+    showTrace(summary);
+
+    if (ok)
+    {
+        double seconds = runTime / 1e9;
+        double throughput = (seconds > 0) ? bytes / seconds / (1024 * 1024) : 0;
+
+        ui->jobTable->item(job, 2)->setText("Done");
+        ui->jobTable->item(job, 2)->setToolTip(message);
+        ui->jobTable->item(job, 3)->setText(QString("%1 MB/s").arg(throughput, 0, 'f', 2));
+        runBytes += bytes;
+    }
+    else
+    {
+        jobsFailed++;
+        ui->jobTable->item(job, 2)->setText("Failed");
+        ui->jobTable->item(job, 2)->setToolTip(message);
+    }
+
+    updateJobSummary();
+
+    //a JPEG embed or retrieve started from the window is reported like one done in place
+    if (job == jpegEmbedJob)
+    {
+        jpegEmbedJob = -1;
+        if (!ok)
+        {
+            error.showMessage(message);
+            return;
+        }
+
+        ui->displayImgPath->setText(message);
+        stegoMsgBox.exec();
+        if (stegoMsgBox.clickedButton() == openFile)
+        {
+            QDesktopServices::openUrl(message);
+        }
+    }
+    else if (job == jpegRetrieveJob)
+    {
+        jpegRetrieveJob = -1;
+        if (!ok)
+        {
+            error.showMessage(message);
+            return;
+        }
+
+        retrieveBox.exec();
+        if (retrieveBox.clickedButton() == openSecretFile)
+        {
+            QDesktopServices::openUrl(message);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: showTrace
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void showTrace(QString summary)
+**              QString summary -- One line summary of a traced job
+**
+** Returns:
+**			void
+**
+** Notes:
+** Shows the summary in the status bar.
+**********************************************************************/
+void MainWindow::showTrace(QString summary)
+{
+    if (summary.isEmpty())
+    {
+        return;
+    }
+
+    statusBar()->showMessage(summary);
+}
+
+
+
+/*****************************************************************
+** Function: exportTrace
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void exportTrace()
+**
+** Returns:
+**			void
+**
+** Notes:
+** Saves the timeline of every traced stage so far as a Chrome
+** trace, which chrome://tracing or Perfetto can open.
+**********************************************************************/
+void MainWindow::exportTrace()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Trace", "trace.json", "Chrome trace (*.json)");
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    if (!traceWriteChrome(fileName.toStdString()))
+    {
+        error.showMessage("Unable to write the trace.");
+    }
 }
@@ -6,6 +6,13 @@
 #include <fstream>
 #include <QErrorMessage>
 #include <QMessageBox>
+#include <QQueue>
+#include <QPair>
+#include <QStringList>
+#include <QElapsedTimer>
+#include "carrierLoader.h"
+#include "jobQueue.h"
+#include "imageManipulation.h"
 
 namespace Ui
 {
@@ -20,6 +27,7 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
      void updateImage(QString, QString);
+     void queueJobs(QStringList);
 
 protected:
 
@@ -27,31 +35,72 @@ protected:
 private:
     void determineSizeCapacity();    
     int checkFileSize(std::ifstream *);
+    void processPendingDrops();
+    void setCarrierFormat(QImage::Format);
+    void showBitPositions(const bool *);
+    int addJob(QString, QImage, QString, QString);
+    void updateJobSummary();
 
     //display functionality
     Ui::MainWindow *ui;
     QGraphicsScene *scene;
-    QPixmap currPixmap;
-    QGraphicsItem * currItem;
-    int maxSecretSize;
+    long long maxSecretSize;
     QErrorMessage error;
     QMessageBox stegoMsgBox;
     QMessageBox retrieveBox;
     QPushButton *openFile;
     QPushButton *openSecretFile;
 
+    //loading of the carrier
+    CarrierLoader *loader;
+    int carrierTicket;
+    QSize carrierSize;
+    QImage previewImage;
+    QQueue<QPair<QString, QString> > pendingDrops;
+    QString carrierPath;
+    bool jpegCarrier;
+    long long jpegSecretSize;
+
+    //embed jobs of multi-file drops
+    JobQueue *jobs;
+    int jobsQueued;
+    int jobsFinished;
+    int jobsFailed;
+    qint64 runBytes;
+    QElapsedTimer runClock;
+
+    //jobs the window itself waits on, for JPEG carriers kept as JPEG
+    int jpegEmbedJob;
+    int jpegRetrieveJob;
+
     //stego properties
     QImage *carrierImage;
-    std::ifstream * secret;
+
+    //carrier before its first secret, for the difference views
+    QImage originalImage;
 
     int numBitsPerChannel;
-    bool enabledBits[8];
+    int carrierDepth;
+    int carrierNumChannels;
+    bool enabledBits[MAX_NUM_BITS];
+    StegoOptions options;
+    CapacityCache capacityCache;
 
 private slots:
     void clearCarrierImage();
     void retrieveSecretImage();
     void updateBitPositions();
+    void updateView();
     void displayHelp();
+    void carrierHeaderRead(int, QSize, int);
+    void carrierPreviewReady(int, QImage);
+    void carrierLoaded(int, QImage);
+    void carrierJpegCapacityRead(int, qint64);
+    void carrierLoadFailed(int, QString);
+    void jobStarted(int);
+    void jobFinished(int, bool, QString, qint64, qint64, QString);
+    void showTrace(QString);
+    void exportTrace();
 
 
 };
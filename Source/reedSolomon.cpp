@@ -0,0 +1,938 @@
+/**********************************************************************
+**	SOURCE FILE:	reedSolomon.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** long long fecEncodedSize(long long, int)
+** long fecDataLength(long, int)
+** void rsEncode(const unsigned char *, int, int, unsigned char *)
+** int rsDecode(unsigned char *, int, unsigned char *, int)
+** void fecEncode(const unsigned char *, long, int, unsigned char *)
+** long fecDecode(const unsigned char *, long, int, unsigned char *)
+** bool buildFieldTables()
+** unsigned char fieldMultiply(unsigned char, unsigned char)
+** void encodeCodewords(const unsigned char *, long, int, long, long, unsigned char *)
+** void decodeCodewords(const unsigned char *, long, int, long, long, unsigned char *, long *)
+** void encodeInterleaved(const unsigned char *const *, int, int, unsigned char *const *)
+** int codewordThreads(long)
+**
+**
+**	DATE:       October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Reed-Solomon error correction over GF(2^8), so a secret survives a
+** carrier that has been lightly damaged after the embed.
+**
+** Codewords are 255 bytes long: the data followed by the chosen
+** number of parity bytes, and up to half that many bytes of a
+** codeword can be wrong and still be put right. The last codeword of
+** a run is shortened to the data that is left, plus its parity.
+**
+** Parity is the remainder of the data divided by the generator
+** polynomial, worked out one data byte at a time in a shift register.
+** Each step multiplies the whole generator by one field element,
+** which with SSSE3 is two PSHUFB lookups per 16 coefficients, into
+** tables of that element times every low and every high nibble.
+** Checking a codeword is the same division; only a codeword whose
+** parity does not match goes through Berlekamp-Massey, a Chien
+** search and Forney's formula, one byte at a time. Runs of codewords
+** are split between the cores, and each core works on RS_INTERLEAVE
+** of them at once so the steps of one codeword are not all waiting on
+** the one before.
+*************************************************************************/
+
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "reedSolomon.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+using namespace std;
+
+#define FIELD_POLYNOMIAL 0x11D
+#define RS_INTERLEAVE 4
+
+//powers of the generator 2 twice over, so two logs can be added without a modulo
+static unsigned char fieldExp[2 * RS_CODEWORD_LENGTH];
+static unsigned char fieldLog[256];
+
+//each element times every low nibble, and times every high nibble
+static unsigned char multiplyLow[256][16];
+static unsigned char multiplyHigh[256][16];
+
+#ifndef __SSSE3__
+//each element times every element, for the shift register without PSHUFB
+static unsigned char multiplyTable[256][256];
+#endif
+
+//coefficients of the generator polynomial for each parity length, highest
+//degree first with the leading 1 left out, padded with zeros
+static unsigned char generators[MAX_FEC_PARITY + 1][MAX_FEC_PARITY];
+
+static bool buildFieldTables();
+static bool fieldTablesBuilt = buildFieldTables();
+
+static unsigned char fieldMultiply(unsigned char, unsigned char);
+static void encodeCodewords(const unsigned char *, long, int, long, long, unsigned char *);
+static void decodeCodewords(const unsigned char *, long, int, long, long, unsigned char *, long *);
+static void encodeInterleaved(const unsigned char *const *, int, int, unsigned char *const *);
+static int codewordThreads(long);
+
+
+/*****************************************************************
+** Function: fecEncodedSize
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long fecEncodedSize(long long size, int parity)
+**              long long size -- Bytes of data
+**              int parity -- Parity bytes per codeword
+**
+**
+** Returns:
+**			long long -- Bytes of the codewords that hold the data
+**********************************************************************/
+long long fecEncodedSize(long long size, int parity)
+{
+    long long dataLength = RS_CODEWORD_LENGTH - parity;
+    long long last = size % dataLength;
+
+    return (size / dataLength) * RS_CODEWORD_LENGTH + ((last > 0) ? last + parity : 0);
+}
+
+
+
+/*****************************************************************
+** Function: fecDataLength
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long fecDataLength(long encodedLength, int parity)
+**              long encodedLength -- Bytes of codewords, the last one may be shortened
+**              int parity -- Parity bytes per codeword
+**
+**
+** Returns:
+**			long -- Bytes of data the codewords hold
+**********************************************************************/
+long fecDataLength(long encodedLength, int parity)
+{
+    long last = encodedLength % RS_CODEWORD_LENGTH;
+
+    return (encodedLength / RS_CODEWORD_LENGTH) * (RS_CODEWORD_LENGTH - parity) + ((last > parity) ? last - parity : 0);
+}
+
+
+
+/*****************************************************************
+** Function: rsEncode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void rsEncode(const unsigned char *data, int length, int parity, unsigned char *parityBytes)
+**              const unsigned char *data -- Data of the codeword
+**              int length -- Bytes of data, at most 255 less the parity
+**              int parity -- Parity bytes, MIN_FEC_PARITY to MAX_FEC_PARITY
+**              unsigned char *parityBytes -- Receives the parity
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** The shift register is held 16 coefficients to a vector. Each step
+** shifts it down a byte, the next vector's first byte coming in at the
+** top, and adds the generator times the feedback.
+**********************************************************************/
+void rsEncode(const unsigned char *data, int length, int parity, unsigned char *parityBytes)
+{
+    const unsigned char *generator = generators[parity];
+
+#ifdef __SSSE3__
+    int numVectors = (parity + 15) / 16;
+    __m128i remainder[MAX_FEC_PARITY / 16 + 1];
+    __m128i lowNibbles[MAX_FEC_PARITY / 16];
+    __m128i highNibbles[MAX_FEC_PARITY / 16];
+    __m128i nibble = _mm_set1_epi8(0x0F);
+
+    for (int v = 0; v < numVectors; v++)
+    {
+        __m128i coefficients = _mm_loadu_si128((const __m128i *) (generator + v * 16));
+        lowNibbles[v] = _mm_and_si128(coefficients, nibble);
+        highNibbles[v] = _mm_and_si128(_mm_srli_epi16(coefficients, 4), nibble);
+        remainder[v] = _mm_setzero_si128();
+    }
+    remainder[numVectors] = _mm_setzero_si128();
+
+    for (int i = 0; i < length; i++)
+    {
+        int feedback = data[i] ^ (_mm_cvtsi128_si32(remainder[0]) & 0xFF);
+        __m128i low = _mm_loadu_si128((const __m128i *) multiplyLow[feedback]);
+        __m128i high = _mm_loadu_si128((const __m128i *) multiplyHigh[feedback]);
+
+        for (int v = 0; v < numVectors; v++)
+        {
+            __m128i product = _mm_xor_si128(_mm_shuffle_epi8(low, lowNibbles[v]), _mm_shuffle_epi8(high, highNibbles[v]));
+            remainder[v] = _mm_xor_si128(_mm_alignr_epi8(remainder[v + 1], remainder[v], 1), product);
+        }
+    }
+
+    unsigned char result[MAX_FEC_PARITY];
+    for (int v = 0; v < numVectors; v++)
+    {
+        _mm_storeu_si128((__m128i *) (result + v * 16), remainder[v]);
+    }
+    memcpy(parityBytes, result, parity);
+#else
+    unsigned char remainder[MAX_FEC_PARITY + 1] = {0};
+
+    for (int i = 0; i < length; i++)
+    {
+        const unsigned char *product = multiplyTable[data[i] ^ remainder[0]];
+        for (int j = 0; j < parity; j++)
+        {
+            remainder[j] = remainder[j + 1] ^ product[generator[j]];
+        }
+    }
+
+    memcpy(parityBytes, remainder, parity);
+#endif
+}
+
+
+
+/*****************************************************************
+** Function: rsDecode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int rsDecode(unsigned char *data, int length, unsigned char *parityBytes, int parity)
+**              unsigned char *data -- Data of the codeword, corrected in place
+**              int length -- Bytes of data
+**              unsigned char *parityBytes -- Parity of the codeword, corrected in place
+**              int parity -- Parity bytes
+**
+**
+** Returns:
+**			int -- Number of bytes corrected, or -1 if there were too many
+**                 errors to put right, when nothing is changed
+**
+** Notes:
+** The syndromes are taken from the difference between the parity
+** received and the parity of the data received, which is the
+** remainder of the whole codeword.
+**********************************************************************/
+int rsDecode(unsigned char *data, int length, unsigned char *parityBytes, int parity)
+{
+    unsigned char remainder[MAX_FEC_PARITY];
+    rsEncode(data, length, parity, remainder);
+
+    bool clean = true;
+    for (int i = 0; i < parity; i++)
+    {
+        remainder[i] ^= parityBytes[i];
+        clean = clean && remainder[i] == 0;
+    }
+    if (clean)
+    {
+        return 0;
+    }
+
+    //the remainder at each root of the generator
+    unsigned char syndromes[MAX_FEC_PARITY];
+    for (int m = 0; m < parity; m++)
+    {
+        unsigned char root = fieldExp[m];
+        unsigned char value = 0;
+        for (int i = 0; i < parity; i++)
+        {
+            value = fieldMultiply(value, root) ^ remainder[i];
+        }
+        syndromes[m] = value;
+    }
+
+    //Berlekamp-Massey finds the error locator
+    unsigned char locator[MAX_FEC_PARITY + 1] = {1};
+    unsigned char previous[MAX_FEC_PARITY + 1] = {1};
+    unsigned char saved[MAX_FEC_PARITY + 1];
+    int numErrors = 0;
+    int shift = 1;
+    unsigned char lastDiscrepancy = 1;
+
+    for (int n = 0; n < parity; n++)
+    {
+        unsigned char discrepancy = syndromes[n];
+        for (int i = 1; i <= numErrors; i++)
+        {
+            discrepancy ^= fieldMultiply(locator[i], syndromes[n - i]);
+        }
+
+        if (discrepancy == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        unsigned char scale = fieldExp[fieldLog[discrepancy] + RS_CODEWORD_LENGTH - fieldLog[lastDiscrepancy]];
+        memcpy(saved, locator, sizeof(locator));
+        for (int i = 0; i + shift <= parity; i++)
+        {
+            locator[i + shift] ^= fieldMultiply(scale, previous[i]);
+        }
+
+        if (2 * numErrors <= n)
+        {
+            numErrors = n + 1 - numErrors;
+            memcpy(previous, saved, sizeof(previous));
+            lastDiscrepancy = discrepancy;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+    }
+
+    if (2 * numErrors > parity)
+    {
+        return -1;
+    }
+
+    //Chien search: byte j of the codeword is at power n - 1 - j
+    int codewordLength = length + parity;
+    int positions[MAX_FEC_PARITY];
+    int numFound = 0;
+    for (int j = 0; j < codewordLength && numFound <= numErrors; j++)
+    {
+        int inverse = (RS_CODEWORD_LENGTH - (codewordLength - 1 - j)) % RS_CODEWORD_LENGTH;
+        unsigned char value = 0;
+        for (int i = numErrors; i >= 0; i--)
+        {
+            value = fieldMultiply(value, fieldExp[inverse]) ^ locator[i];
+        }
+
+        if (value == 0)
+        {
+            if (numFound == numErrors)
+            {
+                return -1;
+            }
+            positions[numFound++] = j;
+        }
+    }
+
+    if (numFound != numErrors)
+    {
+        return -1;
+    }
+
+    //the error evaluator is the syndromes times the locator, cut at the parity
+    unsigned char evaluator[MAX_FEC_PARITY] = {0};
+    for (int i = 0; i < parity; i++)
+    {
+        for (int k = 0; k <= i && k <= numErrors; k++)
+        {
+            evaluator[i] ^= fieldMultiply(syndromes[i - k], locator[k]);
+        }
+    }
+
+    //Forney's formula gives the value of each error
+    unsigned char values[MAX_FEC_PARITY];
+    for (int e = 0; e < numFound; e++)
+    {
+        int power = codewordLength - 1 - positions[e];
+        unsigned char inverse = fieldExp[(RS_CODEWORD_LENGTH - power) % RS_CODEWORD_LENGTH];
+
+        unsigned char numerator = 0;
+        for (int i = parity - 1; i >= 0; i--)
+        {
+            numerator = fieldMultiply(numerator, inverse) ^ evaluator[i];
+        }
+
+        //the derivative keeps only the odd terms
+        unsigned char denominator = 0;
+        unsigned char inverseSquared = fieldMultiply(inverse, inverse);
+        for (int i = numErrors - (numErrors % 2 == 0); i >= 1; i -= 2)
+        {
+            denominator = fieldMultiply(denominator, inverseSquared) ^ locator[i];
+        }
+
+        if (numerator == 0 || denominator == 0)
+        {
+            return -1;
+        }
+
+        values[e] = fieldMultiply(fieldExp[power],
+                                  fieldExp[fieldLog[numerator] + RS_CODEWORD_LENGTH - fieldLog[denominator]]);
+    }
+
+    for (int e = 0; e < numFound; e++)
+    {
+        if (positions[e] < length)
+        {
+            data[positions[e]] ^= values[e];
+        }
+        else
+        {
+            parityBytes[positions[e] - length] ^= values[e];
+        }
+    }
+
+    return numFound;
+}
+
+
+
+/*****************************************************************
+** Function: fecEncode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void fecEncode(const unsigned char *data, long length, int parity, unsigned char *codewords)
+**              const unsigned char *data -- Data to protect
+**              long length -- Bytes of data
+**              int parity -- Parity bytes per codeword
+**              unsigned char *codewords -- Receives fecEncodedSize(length, parity) bytes
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Each codeword is its data followed by its parity. The codewords are
+** split between the cores.
+**********************************************************************/
+void fecEncode(const unsigned char *data, long length, int parity, unsigned char *codewords)
+{
+    long dataLength = RS_CODEWORD_LENGTH - parity;
+    long numCodewords = (length + dataLength - 1) / dataLength;
+    int numThreads = codewordThreads(numCodewords);
+    if (numThreads == 1)
+    {
+        encodeCodewords(data, length, parity, 0, numCodewords, codewords);
+        return;
+    }
+
+    vector<thread> workers;
+    for (int i = 0; i < numThreads; i++)
+    {
+        workers.push_back(thread(encodeCodewords, data, length, parity, numCodewords * i / numThreads,
+                                 numCodewords * (i + 1) / numThreads, codewords));
+    }
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+
+
+/*****************************************************************
+** Function: fecDecode
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long fecDecode(const unsigned char *codewords, long encodedLength, int parity, unsigned char *data)
+**              const unsigned char *codewords -- Codewords from fecEncode, maybe damaged
+**              long encodedLength -- Bytes of codewords
+**              int parity -- Parity bytes per codeword
+**              unsigned char *data -- Receives fecDataLength(encodedLength, parity) bytes
+**
+**
+** Returns:
+**			long -- Number of bytes corrected, or -1 if a codeword had too many
+**                  errors to put right
+**
+** Notes:
+** The data of a codeword that can not be put right is handed back
+** as it was received.
+**********************************************************************/
+long fecDecode(const unsigned char *codewords, long encodedLength, int parity, unsigned char *data)
+{
+    long numCodewords = (encodedLength + RS_CODEWORD_LENGTH - 1) / RS_CODEWORD_LENGTH;
+    int numThreads = codewordThreads(numCodewords);
+    vector<long> corrected(numThreads, 0);
+
+    if (numThreads == 1)
+    {
+        decodeCodewords(codewords, encodedLength, parity, 0, numCodewords, data, &corrected[0]);
+    }
+    else
+    {
+        vector<thread> workers;
+        for (int i = 0; i < numThreads; i++)
+        {
+            workers.push_back(thread(decodeCodewords, codewords, encodedLength, parity, numCodewords * i / numThreads,
+                                     numCodewords * (i + 1) / numThreads, data, &corrected[i]));
+        }
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+    }
+
+    long total = 0;
+    for (int i = 0; i < numThreads; i++)
+    {
+        if (corrected[i] < 0)
+        {
+            return -1;
+        }
+        total += corrected[i];
+    }
+
+    return total;
+}
+
+
+
+/*****************************************************************
+** Function: buildFieldTables
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool buildFieldTables()
+**
+**
+** Returns:
+**			bool -- Always true, so the tables can be built during static initialization
+**
+** Notes:
+** The generator for p parity bytes has the roots 2^0 to 2^(p-1), so
+** each one is the last times one more factor.
+**********************************************************************/
+static bool buildFieldTables()
+{
+    int value = 1;
+    for (int i = 0; i < RS_CODEWORD_LENGTH; i++)
+    {
+        fieldExp[i] = (unsigned char) value;
+        fieldExp[i + RS_CODEWORD_LENGTH] = (unsigned char) value;
+        fieldLog[value] = (unsigned char) i;
+
+        value <<= 1;
+        if (value & 0x100)
+        {
+            value ^= FIELD_POLYNOMIAL;
+        }
+    }
+
+    for (int element = 0; element < 256; element++)
+    {
+        for (int n = 0; n < 16; n++)
+        {
+            multiplyLow[element][n] = fieldMultiply((unsigned char) element, (unsigned char) n);
+            multiplyHigh[element][n] = fieldMultiply((unsigned char) element, (unsigned char) (n << 4));
+        }
+
+#ifndef __SSSE3__
+        for (int n = 0; n < 256; n++)
+        {
+            multiplyTable[element][n] = fieldMultiply((unsigned char) element, (unsigned char) n);
+        }
+#endif
+    }
+
+    //polynomial[0] is the leading 1, then the rest highest degree first
+    unsigned char polynomial[MAX_FEC_PARITY + 1] = {1};
+    for (int parity = 1; parity <= MAX_FEC_PARITY; parity++)
+    {
+        unsigned char root = fieldExp[parity - 1];
+        for (int j = parity; j >= 1; j--)
+        {
+            polynomial[j] ^= fieldMultiply(root, polynomial[j - 1]);
+        }
+
+        memcpy(generators[parity], polynomial + 1, parity);
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: fieldMultiply
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned char fieldMultiply(unsigned char a, unsigned char b)
+**              unsigned char a -- First element
+**              unsigned char b -- Second element
+**
+**
+** Returns:
+**			unsigned char -- Product of the two in GF(2^8)
+**********************************************************************/
+static unsigned char fieldMultiply(unsigned char a, unsigned char b)
+{
+    if (a == 0 || b == 0)
+    {
+        return 0;
+    }
+
+    return fieldExp[fieldLog[a] + fieldLog[b]];
+}
+
+
+
+/*****************************************************************
+** Function: encodeCodewords
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void encodeCodewords(const unsigned char *data, long length, int parity,
+**                               long first, long last, unsigned char *codewords)
+**              const unsigned char *data -- All the data being protected
+**              long length -- Bytes of data
+**              int parity -- Parity bytes per codeword
+**              long first -- First codeword to build
+**              long last -- Codeword after the last one to build
+**              unsigned char *codewords -- All the codewords
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own when the run is long enough.
+**********************************************************************/
+static void encodeCodewords(const unsigned char *data, long length, int parity,
+                            long first, long last, unsigned char *codewords)
+{
+    long dataLength = RS_CODEWORD_LENGTH - parity;
+    long c = first;
+
+    //whole codewords a group at a time
+    for (; c + RS_INTERLEAVE <= last && (c + RS_INTERLEAVE) * dataLength <= length; c += RS_INTERLEAVE)
+    {
+        const unsigned char *groupData[RS_INTERLEAVE];
+        unsigned char *groupParity[RS_INTERLEAVE];
+        for (int w = 0; w < RS_INTERLEAVE; w++)
+        {
+            unsigned char *codeword = codewords + (c + w) * RS_CODEWORD_LENGTH;
+            memcpy(codeword, data + (c + w) * dataLength, dataLength);
+            groupData[w] = codeword;
+            groupParity[w] = codeword + dataLength;
+        }
+
+        encodeInterleaved(groupData, (int) dataLength, parity, groupParity);
+    }
+
+    for (; c < last; c++)
+    {
+        long start = c * dataLength;
+        int numBytes = (int) ((length - start < dataLength) ? length - start : dataLength);
+        unsigned char *codeword = codewords + c * RS_CODEWORD_LENGTH;
+
+        memcpy(codeword, data + start, numBytes);
+        rsEncode(codeword, numBytes, parity, codeword + numBytes);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: decodeCodewords
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void decodeCodewords(const unsigned char *codewords, long encodedLength, int parity,
+**                               long first, long last, unsigned char *data, long *corrected)
+**              const unsigned char *codewords -- All the codewords
+**              long encodedLength -- Bytes of codewords
+**              int parity -- Parity bytes per codeword
+**              long first -- First codeword to check
+**              long last -- Codeword after the last one to check
+**              unsigned char *data -- All the data
+**              long *corrected -- Set to the bytes corrected, or -1 if a codeword
+**                                 could not be put right
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own when the run is long enough.
+**********************************************************************/
+static void decodeCodewords(const unsigned char *codewords, long encodedLength, int parity,
+                            long first, long last, unsigned char *data, long *corrected)
+{
+    long dataLength = RS_CODEWORD_LENGTH - parity;
+    unsigned char parityBytes[MAX_FEC_PARITY];
+    *corrected = 0;
+    long c = first;
+
+    //whole codewords a group at a time, only the damaged ones are decoded
+    for (; c + RS_INTERLEAVE <= last && (c + RS_INTERLEAVE) * RS_CODEWORD_LENGTH <= encodedLength; c += RS_INTERLEAVE)
+    {
+        const unsigned char *groupData[RS_INTERLEAVE];
+        unsigned char groupParity[RS_INTERLEAVE][MAX_FEC_PARITY];
+        unsigned char *parityPointers[RS_INTERLEAVE];
+        for (int w = 0; w < RS_INTERLEAVE; w++)
+        {
+            memcpy(data + (c + w) * dataLength, codewords + (c + w) * RS_CODEWORD_LENGTH, dataLength);
+            groupData[w] = data + (c + w) * dataLength;
+            parityPointers[w] = groupParity[w];
+        }
+
+        encodeInterleaved(groupData, (int) dataLength, parity, parityPointers);
+
+        for (int w = 0; w < RS_INTERLEAVE; w++)
+        {
+            const unsigned char *received = codewords + (c + w) * RS_CODEWORD_LENGTH + dataLength;
+            if (memcmp(groupParity[w], received, parity) == 0)
+            {
+                continue;
+            }
+
+            memcpy(parityBytes, received, parity);
+            int numErrors = rsDecode(data + (c + w) * dataLength, (int) dataLength, parityBytes, parity);
+            if (numErrors < 0)
+            {
+                *corrected = -1;
+            }
+            else if (*corrected >= 0)
+            {
+                *corrected += numErrors;
+            }
+        }
+    }
+
+    for (; c < last; c++)
+    {
+        long start = c * RS_CODEWORD_LENGTH;
+        int numBytes = (int) (((encodedLength - start < RS_CODEWORD_LENGTH) ? encodedLength - start
+                                                                           : RS_CODEWORD_LENGTH) - parity);
+        unsigned char *output = data + c * dataLength;
+
+        memcpy(output, codewords + start, numBytes);
+        memcpy(parityBytes, codewords + start + numBytes, parity);
+
+        int numErrors = rsDecode(output, numBytes, parityBytes, parity);
+        if (numErrors < 0)
+        {
+            *corrected = -1;
+        }
+        else if (*corrected >= 0)
+        {
+            *corrected += numErrors;
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: encodeInterleaved
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void encodeInterleaved(const unsigned char *const *data, int length, int parity,
+**                                 unsigned char *const *parityBytes)
+**              const unsigned char *const *data -- Data of RS_INTERLEAVE codewords
+**              int length -- Bytes of data in each, the same for all of them
+**              int parity -- Parity bytes
+**              unsigned char *const *parityBytes -- Receive the parity of each
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** The same as rsEncode on each codeword, but the steps of the
+** codewords are taken in turn, so one waits on its feedback while the
+** others work.
+**********************************************************************/
+static void encodeInterleaved(const unsigned char *const *data, int length, int parity,
+                              unsigned char *const *parityBytes)
+{
+#ifdef __SSSE3__
+    const unsigned char *generator = generators[parity];
+    int numVectors = (parity + 15) / 16;
+    __m128i remainder[RS_INTERLEAVE][MAX_FEC_PARITY / 16 + 1];
+    __m128i lowNibbles[MAX_FEC_PARITY / 16];
+    __m128i highNibbles[MAX_FEC_PARITY / 16];
+    __m128i nibble = _mm_set1_epi8(0x0F);
+
+    for (int v = 0; v < numVectors; v++)
+    {
+        __m128i coefficients = _mm_loadu_si128((const __m128i *) (generator + v * 16));
+        lowNibbles[v] = _mm_and_si128(coefficients, nibble);
+        highNibbles[v] = _mm_and_si128(_mm_srli_epi16(coefficients, 4), nibble);
+    }
+    for (int w = 0; w < RS_INTERLEAVE; w++)
+    {
+        for (int v = 0; v <= numVectors; v++)
+        {
+            remainder[w][v] = _mm_setzero_si128();
+        }
+    }
+
+    for (int i = 0; i < length; i++)
+    {
+        for (int w = 0; w < RS_INTERLEAVE; w++)
+        {
+            int feedback = data[w][i] ^ (_mm_cvtsi128_si32(remainder[w][0]) & 0xFF);
+            __m128i low = _mm_loadu_si128((const __m128i *) multiplyLow[feedback]);
+            __m128i high = _mm_loadu_si128((const __m128i *) multiplyHigh[feedback]);
+
+            for (int v = 0; v < numVectors; v++)
+            {
+                __m128i product = _mm_xor_si128(_mm_shuffle_epi8(low, lowNibbles[v]),
+                                                _mm_shuffle_epi8(high, highNibbles[v]));
+                remainder[w][v] = _mm_xor_si128(_mm_alignr_epi8(remainder[w][v + 1], remainder[w][v], 1), product);
+            }
+        }
+    }
+
+    for (int w = 0; w < RS_INTERLEAVE; w++)
+    {
+        unsigned char result[MAX_FEC_PARITY];
+        for (int v = 0; v < numVectors; v++)
+        {
+            _mm_storeu_si128((__m128i *) (result + v * 16), remainder[w][v]);
+        }
+        memcpy(parityBytes[w], result, parity);
+    }
+#else
+    for (int w = 0; w < RS_INTERLEAVE; w++)
+    {
+        rsEncode(data[w], length, parity, parityBytes[w]);
+    }
+#endif
+}
+
+
+
+/*****************************************************************
+** Function: codewordThreads
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int codewordThreads(long numCodewords)
+**              long numCodewords -- Codewords to encode or decode
+**
+**
+** Returns:
+**			int -- Threads to split them between, at least 1
+**********************************************************************/
+static int codewordThreads(long numCodewords)
+{
+    int numThreads = (int) thread::hardware_concurrency();
+    long maxThreads = numCodewords / FEC_MIN_THREAD_CODEWORDS;
+    if (numThreads > maxThreads)
+    {
+        numThreads = (int) maxThreads;
+    }
+
+    return (numThreads < 1) ? 1 : numThreads;
+}
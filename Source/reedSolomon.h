@@ -0,0 +1,16 @@
+#ifndef REEDSOLOMON_H
+#define REEDSOLOMON_H
+
+#define RS_CODEWORD_LENGTH 255
+#define MIN_FEC_PARITY 2
+#define MAX_FEC_PARITY 128
+#define FEC_MIN_THREAD_CODEWORDS 64     //fewest codewords worth a thread of their own
+
+long long fecEncodedSize(long long, int);
+long fecDataLength(long, int);
+void rsEncode(const unsigned char *, int, int, unsigned char *);
+int rsDecode(unsigned char *, int, unsigned char *, int);
+void fecEncode(const unsigned char *, long, int, unsigned char *);
+long fecDecode(const unsigned char *, long, int, unsigned char *);
+
+#endif // REEDSOLOMON_H
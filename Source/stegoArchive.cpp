@@ -0,0 +1,761 @@
+/**********************************************************************
+**	SOURCE FILE:	stegoArchive.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** unsigned int archiveChecksum(unsigned int, const char *, long long)
+** int archiveEmbed(PixelBuffer *, const BitMask *, const StegoOptions *, const string &,
+**                  const vector<ArchiveFile> &, RowRange *)
+** int archiveAppend(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *,
+**                   const vector<ArchiveFile> &, RowRange *)
+** int archiveReadIndex(const PixelBuffer *, const BitMask *, const SecretHeader *, vector<ArchiveEntry> *)
+** int archiveExtractFile(const PixelBuffer *, const BitMask *, const SecretHeader *, const ArchiveEntry *,
+**                        StegoWriter, void *)
+** bool checkNames(const vector<ArchiveFile> &, set<string> *)
+** string writeEntries(const vector<ArchiveFile> &, long long)
+** bool buildChecksumTables()
+** void checksumFiles(const vector<ArchiveFile> &, vector<unsigned int> *)
+** long readArchive(void *, char *, long)
+** bool writeChecked(void *, const char *, long)
+** bool writeIndex(void *, const char *, long)
+**
+**
+**	DATE:       October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Embeds several files as one secret, with an index in front of them
+** so one file can be listed or retrieved without the rest.
+**
+** The secret is stored by stegoCore as usual, named after the archive,
+** with the index option ("index=N") saying its first N bytes are the
+** index. Each file has an entry of four null terminated fields: its
+** name, its offset from the end of the index and its size as decimal
+** text, and its CRC-32 as eight hex digits. The files follow the index
+** in the same order, one after the other.
+**
+** Listing retrieves only the index, and retrieving a file only its own
+** bytes (see stegoExtractRange), so a small file out of a full carrier
+** costs about its own size. The checksum is worked out as the file is
+** written and a file that does not match is reported as corrupt.
+**
+** Files are added to an archive already embedded (see archiveAppend)
+** without moving the ones there. They go after the last file, and
+** their entries into a second index at the end of the data, which the
+** tail option ("tail=N") gives the length of. Each append writes its
+** files over that index and the grown index after them, so it costs
+** the new files and the entries of the files appended before.
+*************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "stegoArchive.h"
+
+using namespace std;
+
+//an archive being embedded, its index, each file in turn and then the index at the end
+struct ArchiveSource
+{
+    const string *index;
+    const vector<ArchiveFile> *files;
+    const string *tail;
+    size_t file;                    //file being read, 0 is the first after the index
+    long long position;             //bytes read of the index or that file
+};
+
+//a file being retrieved, checked on its way to the caller's writer
+struct CheckedWriter
+{
+    StegoWriter writer;
+    void *context;
+    unsigned int checksum;
+};
+
+//CRC-32 remainders of one byte followed by 0 to 7 zero bytes
+static unsigned int checksumTables[8][256];
+
+static bool checkNames(const vector<ArchiveFile> &, set<string> *);
+static string writeEntries(const vector<ArchiveFile> &, long long);
+static bool buildChecksumTables();
+static void checksumFiles(const vector<ArchiveFile> &, vector<unsigned int> *);
+static long readArchive(void *, char *, long);
+static bool writeChecked(void *, const char *, long);
+static bool writeIndex(void *, const char *, long);
+
+static bool checksumTablesBuilt = buildChecksumTables();
+
+
+
+/*****************************************************************
+** Function: archiveChecksum
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          unsigned int archiveChecksum(unsigned int checksum, const char *data, long long length)
+**              unsigned int checksum -- Checksum of the bytes before, 0 to start
+**              const char *data -- Next bytes
+**              long long length -- Number of bytes
+**
+**
+** Returns:
+**			unsigned int -- CRC-32 of the bytes so far
+**
+** Notes:
+** The same CRC-32 as zip and PNG. Eight bytes are taken at a time
+** through eight tables, so each step does not wait on the last.
+**********************************************************************/
+unsigned int archiveChecksum(unsigned int checksum, const char *data, long long length)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+    unsigned int crc = ~checksum;
+
+    while (length >= 8)
+    {
+        crc ^= (unsigned int) bytes[0] | ((unsigned int) bytes[1] << 8)
+               | ((unsigned int) bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+        crc = checksumTables[7][crc & 0xff] ^ checksumTables[6][(crc >> 8) & 0xff]
+              ^ checksumTables[5][(crc >> 16) & 0xff] ^ checksumTables[4][crc >> 24]
+              ^ checksumTables[3][bytes[4]] ^ checksumTables[2][bytes[5]]
+              ^ checksumTables[1][bytes[6]] ^ checksumTables[0][bytes[7]];
+        bytes += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0)
+    {
+        crc = checksumTables[0][(crc ^ *bytes++) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+
+
+/*****************************************************************
+** Function: archiveEmbed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Checks the names and writes the index through checkNames and writeEntries
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int archiveEmbed(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+**                           const string &name, const vector<ArchiveFile> &files, RowRange *rows)
+**              PixelBuffer *carrier -- Carrier pixels, changed in place
+**              const BitMask *bitMask -- Positions to embed in
+**              const StegoOptions *options -- How the data is spread, may be null
+**              const string &name -- Name of the archive
+**              const vector<ArchiveFile> &files -- Files to put in it
+**              RowRange *rows -- Set to the rows that were changed, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_TOO_BIG if the archive does not fit, or
+**                 STEGO_ERROR if a name is bad or given twice
+**
+** Notes:
+** The checksums are worked out first, the files shared between the
+** cores, since the index holding them goes in front of the files.
+**********************************************************************/
+int archiveEmbed(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+                 const string &name, const vector<ArchiveFile> &files, RowRange *rows)
+{
+    set<string> names;
+    if (files.empty() || files.size() > MAX_ARCHIVE_FILES || !checkNames(files, &names))
+    {
+        return STEGO_ERROR;
+    }
+
+    string index = writeEntries(files, 0);
+    long long offset = 0;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        offset += files[i].size;
+    }
+
+    StegoOptions archiveOptions;
+    stegoDefaultOptions(&archiveOptions);
+    if (options != NULL)
+    {
+        archiveOptions = *options;
+    }
+    archiveOptions.archiveIndex = (int) index.length();
+
+    ArchiveSource source = {&index, &files, NULL, 0, 0};
+
+    return stegoEmbedStream(carrier, bitMask, &archiveOptions, name, (long long) index.length() + offset,
+                            readArchive, &source, rows);
+}
+
+
+
+/*****************************************************************
+** Function: archiveAppend
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int archiveAppend(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+**                            const StegoOptions *options, const vector<ArchiveFile> &files, RowRange *rows)
+**              PixelBuffer *carrier -- Pixels with an archive embedded, changed in place
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              const StegoOptions *options -- Only whether to embed by LSB matching, may be null
+**              const vector<ArchiveFile> &files -- Files to add
+**              RowRange *rows -- Set to the rows that were changed, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the secret is not an archive or a
+**                 name is bad or already in it, STEGO_TOO_BIG if the files do
+**                 not fit, or another STEGO_ error
+**
+** Notes:
+** Reads the index, then embeds the new files and the index at the end
+** from where the old index at the end started (see stegoAppendStream).
+**********************************************************************/
+int archiveAppend(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                  const StegoOptions *options, const vector<ArchiveFile> &files, RowRange *rows)
+{
+    if (header->options.archiveIndex == 0)
+    {
+        return STEGO_ERROR;
+    }
+
+    vector<ArchiveEntry> entries;
+    int result = archiveReadIndex(carrier, bitMask, header, &entries);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+
+    set<string> names;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        names.insert(entries[i].name);
+    }
+    if (files.empty() || entries.size() + files.size() > MAX_ARCHIVE_FILES || !checkNames(files, &names))
+    {
+        return STEGO_ERROR;
+    }
+
+    //the entries at the end so far are kept ahead of the new ones
+    long long oldTail = header->options.archiveTail;
+    long long offset = header->size - header->options.archiveIndex - oldTail;
+    string tail;
+    tail.reserve((size_t) oldTail);
+    result = stegoExtractRange(carrier, bitMask, header, header->size - oldTail, oldTail, writeIndex, &tail);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+    tail += writeEntries(files, offset);
+
+    long long size = 0;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        size += files[i].size;
+    }
+
+    StegoOptions appendOptions = header->options;
+    appendOptions.matching = (options != NULL) ? options->matching : 0;
+    appendOptions.archiveTail = (int) tail.length();
+
+    string index;
+    ArchiveSource source = {&index, &files, &tail, 0, 0};
+
+    return stegoAppendStream(carrier, bitMask, header, &appendOptions, header->size - oldTail,
+                             size + (long long) tail.length(), readArchive, &source, rows);
+}
+
+
+
+/*****************************************************************
+** Function: archiveReadIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int archiveReadIndex(const PixelBuffer *carrier, const BitMask *bitMask,
+**                               const SecretHeader *header, vector<ArchiveEntry> *entries)
+**              const PixelBuffer *carrier -- Pixels that have an archive embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              vector<ArchiveEntry> *entries -- Set to the files of the archive
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_NO_SECRET if the secret is not an archive
+**                 or its index does not make sense, or STEGO_CORRUPT
+**
+** Notes:
+** Only the index is retrieved, and the index at the end after it.
+**********************************************************************/
+int archiveReadIndex(const PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                     vector<ArchiveEntry> *entries)
+{
+    long long indexLength = header->options.archiveIndex;
+    long long tailLength = header->options.archiveTail;
+    if (indexLength <= 0 || indexLength + tailLength > header->size)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    string index;
+    index.reserve((size_t) (indexLength + tailLength));
+    int result = stegoExtractRange(carrier, bitMask, header, 0, indexLength, writeIndex, &index);
+    if (result == STEGO_OK)
+    {
+        result = stegoExtractRange(carrier, bitMask, header, header->size - tailLength, tailLength, writeIndex, &index);
+    }
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+
+    //each entry is four fields, and the files have to lie inside the data
+    entries->clear();
+    long long dataSize = header->size - indexLength - tailLength;
+    size_t start = 0;
+    while (start < index.length())
+    {
+        string fields[4];
+        for (int i = 0; i < 4; i++)
+        {
+            size_t end = index.find('\0', start);
+            if (end == string::npos)
+            {
+                return STEGO_NO_SECRET;
+            }
+            fields[i] = index.substr(start, end - start);
+            start = end + 1;
+        }
+
+        ArchiveEntry entry;
+        entry.name = fields[0];
+        try
+        {
+            entry.offset = stoll(fields[1]);
+            entry.size = stoll(fields[2]);
+            entry.checksum = (unsigned int) stoul(fields[3], NULL, 16);
+        }
+        catch (const std::exception& e)
+        {
+            return STEGO_NO_SECRET;
+        }
+
+        if (entry.name.empty() || entry.offset < 0 || entry.size < 0 || entry.offset > dataSize
+            || entry.size > dataSize - entry.offset)
+        {
+            return STEGO_NO_SECRET;
+        }
+        entries->push_back(entry);
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: archiveExtractFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int archiveExtractFile(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                 const SecretHeader *header, const ArchiveEntry *entry,
+**                                 StegoWriter writer, void *context)
+**              const PixelBuffer *carrier -- Pixels that have an archive embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              const ArchiveEntry *entry -- File to retrieve, from archiveReadIndex
+**              StegoWriter writer -- Called for each chunk of the file
+**              void *context -- Passed to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_WRITE_FAILED if the writer stopped, or
+**                 STEGO_CORRUPT if the file does not match its checksum
+**
+** Notes:
+** The writer has already been given the file by the time its checksum
+** is known, so it is up to the caller to throw away a corrupt file.
+**********************************************************************/
+int archiveExtractFile(const PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                       const ArchiveEntry *entry, StegoWriter writer, void *context)
+{
+    CheckedWriter checked = {writer, context, 0};
+    int result = stegoExtractRange(carrier, bitMask, header, header->options.archiveIndex + entry->offset,
+                                   entry->size, writeChecked, &checked);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+
+    return (checked.checksum == entry->checksum) ? STEGO_OK : STEGO_CORRUPT;
+}
+
+
+
+/*****************************************************************
+** Function: checkNames
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool checkNames(const vector<ArchiveFile> &files, set<string> *names)
+**              const vector<ArchiveFile> &files -- Files going into the archive
+**              set<string> *names -- Names already in it, the new ones are added
+**
+**
+** Returns:
+**			bool -- False if a name is bad or given twice
+**********************************************************************/
+static bool checkNames(const vector<ArchiveFile> &files, set<string> *names)
+{
+    //every file has to be found again by its name alone
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (files[i].name.empty() || files[i].name.length() > MAX_NAME_LENGTH
+            || files[i].name.find('\0') != string::npos || files[i].size < 0
+            || !names->insert(files[i].name).second)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: writeEntries
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string writeEntries(const vector<ArchiveFile> &files, long long offset)
+**              const vector<ArchiveFile> &files -- Files going into the archive
+**              long long offset -- Offset of the first of them after the index
+**
+**
+** Returns:
+**			string -- The index entries of the files, one after the other
+**********************************************************************/
+static string writeEntries(const vector<ArchiveFile> &files, long long offset)
+{
+    vector<unsigned int> checksums;
+    checksumFiles(files, &checksums);
+
+    stringstream ss;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        char checksum[9];
+        snprintf(checksum, sizeof(checksum), "%08x", checksums[i]);
+
+        ss << files[i].name << '\0' << offset << '\0' << files[i].size << '\0' << checksum << '\0';
+        offset += files[i].size;
+    }
+
+    return ss.str();
+}
+
+
+
+/*****************************************************************
+** Function: buildChecksumTables
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool buildChecksumTables()
+**
+**
+** Returns:
+**			bool -- Always true, so the tables can be built at start up
+**********************************************************************/
+static bool buildChecksumTables()
+{
+    for (unsigned int value = 0; value < 256; value++)
+    {
+        unsigned int crc = value;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        checksumTables[0][value] = crc;
+    }
+
+    for (int table = 1; table < 8; table++)
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            unsigned int crc = checksumTables[table - 1][value];
+            checksumTables[table][value] = checksumTables[0][crc & 0xff] ^ (crc >> 8);
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: checksumFiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void checksumFiles(const vector<ArchiveFile> &files, vector<unsigned int> *checksums)
+**              const vector<ArchiveFile> &files -- Files going into the archive
+**              vector<unsigned int> *checksums -- Set to the checksum of each file
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Each core takes every so many files.
+**********************************************************************/
+static void checksumFiles(const vector<ArchiveFile> &files, vector<unsigned int> *checksums)
+{
+    checksums->assign(files.size(), 0);
+
+    int numThreads = (int) thread::hardware_concurrency();
+    if (numThreads > (int) files.size())
+    {
+        numThreads = (int) files.size();
+    }
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.push_back(thread([&files, checksums, t, numThreads]()
+        {
+            for (size_t i = t; i < files.size(); i += numThreads)
+            {
+                (*checksums)[i] = archiveChecksum(0, files[i].data, files[i].size);
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+}
+
+
+
+/*****************************************************************
+** Function: readArchive
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Serves the index at the end after the files
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readArchive(void *context, char *buffer, long length)
+**              void *context -- ArchiveSource of the archive
+**              char *buffer -- Receives the next bytes
+**              long length -- Most bytes wanted
+**
+**
+** Returns:
+**			long -- Bytes read, 0 at the end of the archive
+**
+** Notes:
+** Serves the index, then each file straight from its memory, then
+** the index at the end if there is one.
+**********************************************************************/
+static long readArchive(void *context, char *buffer, long length)
+{
+    ArchiveSource *source = (ArchiveSource *) context;
+    const char *data;
+    long long size;
+
+    //the index counts as the file before the first, and the one at the end as the file after the last
+    while (true)
+    {
+        if (source->file == 0)
+        {
+            data = source->index->data();
+            size = (long long) source->index->length();
+        }
+        else if (source->file <= source->files->size())
+        {
+            data = (*source->files)[source->file - 1].data;
+            size = (*source->files)[source->file - 1].size;
+        }
+        else if (source->file == source->files->size() + 1 && source->tail != NULL)
+        {
+            data = source->tail->data();
+            size = (long long) source->tail->length();
+        }
+        else
+        {
+            return 0;
+        }
+
+        if (source->position < size)
+        {
+            break;
+        }
+        source->file++;
+        source->position = 0;
+    }
+
+    long count = (size - source->position < length) ? (long) (size - source->position) : length;
+    memcpy(buffer, data + source->position, count);
+    source->position += count;
+
+    return count;
+}
+
+
+
+/*****************************************************************
+** Function: writeChecked
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeChecked(void *context, const char *buffer, long length)
+**              void *context -- CheckedWriter of the file
+**              const char *buffer -- Next bytes of the file
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			bool -- What the caller's writer returned
+**********************************************************************/
+static bool writeChecked(void *context, const char *buffer, long length)
+{
+    CheckedWriter *checked = (CheckedWriter *) context;
+    checked->checksum = archiveChecksum(checked->checksum, buffer, length);
+
+    return checked->writer(checked->context, buffer, length);
+}
+
+
+
+/*****************************************************************
+** Function: writeIndex
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeIndex(void *context, const char *buffer, long length)
+**              void *context -- string the index is retrieved into
+**              const char *buffer -- Next bytes of the index
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			bool -- Always true
+**********************************************************************/
+static bool writeIndex(void *context, const char *buffer, long length)
+{
+    ((string *) context)->append(buffer, length);
+
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef STEGOARCHIVE_H
+#define STEGOARCHIVE_H
+
+#include <string>
+#include <vector>
+#include "stegoCore.h"
+
+#define MAX_ARCHIVE_FILES 65536
+
+//a file put into an archive from memory
+struct ArchiveFile
+{
+    std::string name;
+    const char *data;
+    long long size;
+};
+
+//a file listed in the index of an archive
+struct ArchiveEntry
+{
+    std::string name;
+    long long offset;           //first byte of the file in the data, after the index
+    long long size;
+    unsigned int checksum;      //CRC-32 of the file
+};
+
+unsigned int archiveChecksum(unsigned int, const char *, long long);
+int archiveEmbed(PixelBuffer *, const BitMask *, const StegoOptions *, const std::string &,
+                 const std::vector<ArchiveFile> &, RowRange *);
+int archiveAppend(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *,
+                  const std::vector<ArchiveFile> &, RowRange *);
+int archiveReadIndex(const PixelBuffer *, const BitMask *, const SecretHeader *, std::vector<ArchiveEntry> *);
+int archiveExtractFile(const PixelBuffer *, const BitMask *, const SecretHeader *, const ArchiveEntry *,
+                       StegoWriter, void *);
+
+#endif // STEGOARCHIVE_H
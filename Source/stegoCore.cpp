@@ -0,0 +1,3809 @@
+/**********************************************************************
+**	SOURCE FILE:	stegoCore.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** void stegoDefaultOptions(StegoOptions *)
+** string stegoFormatOptions(const StegoOptions *)
+** bool stegoParseOptions(const string &, StegoOptions *)
+** long long stegoCapacity(const PixelBuffer *, const BitMask *, const StegoOptions *)
+** long long stegoSlotsNeeded(const string &, long long, const StegoOptions *)
+** int stegoEmbed(PixelBuffer *, const BitMask *, const StegoOptions *, const string &,
+**                const char *, long long, RowRange *)
+** int stegoEmbedStream(PixelBuffer *, const BitMask *, const StegoOptions *, const string &, long long,
+**                      StegoReader, void *, RowRange *)
+** int stegoEmbedUnsized(PixelBuffer *, const BitMask *, const StegoOptions *, const string &,
+**                       StegoReader, void *, long long *, RowRange *)
+** int stegoAppend(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *,
+**                 const char *, long long, RowRange *)
+** int stegoAppendStream(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *,
+**                       long long, long long, StegoReader, void *, RowRange *)
+** int stegoUpdate(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *,
+**                 const char *, long long, long long *, RowRange *)
+** int stegoReadHeader(const PixelBuffer *, const BitMask *, SecretHeader *)
+** int stegoExtract(const PixelBuffer *, const BitMask *, string *, vector<char> *)
+** int stegoExtractStream(const PixelBuffer *, const BitMask *, const SecretHeader *, StegoWriter, void *)
+** int stegoExtractRange(const PixelBuffer *, const BitMask *, const SecretHeader *, long long, long long,
+**                       StegoWriter, void *)
+** int stegoDetectBitMask(const PixelBuffer *, bool *)
+** long readMemory(void *, char *, long)
+** bool writeMemory(void *, const char *, long)
+** long readAppend(void *, char *, long)
+** long readCounted(void *, char *, long)
+** long readChunk(StegoReader, void *, char *, long)
+** long chunkLength(const StegoOptions *)
+** long long dataSlots(const StegoOptions *, long long)
+** long long fittingSize(const StegoOptions *, long long)
+** string buildHeader(const string &, long long, const StegoOptions *, int)
+** string encodeFecHeader(const string &)
+** bool readFecHeader(const PixelBuffer *, const BitMask *, SecretHeader *)
+** bool parseSizeField(const string &, long long *, StegoOptions *)
+** int embedData(PixelBuffer *, const BitMask *, const PixelSelection *, const StegoOptions *, long long,
+**               long long, StegoReader, void *, RowRange *, MatchingRandom *)
+** int embedFecData(PixelBuffer *, const BitMask *, const PixelSelection *, const StegoOptions *, long long,
+**                  const char *, long, long long, StegoReader, void *, RowRange *, MatchingRandom *)
+** int retrieveFecData(const PixelBuffer *, const BitMask *, const PixelSelection *, const SecretHeader *,
+**                     long long, StegoWriter, void *)
+** long long embedChunk(PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+**                      const char *, long, RowRange *, MatchingRandom *)
+** void retrieveStream(const PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+**                     long long, char *, long)
+** long long retrieveChunk(const PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+**                         char *, long)
+** long long embedSlots(PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+**                      const char *, long, RowRange *, MatchingRandom *)
+** long long retrieveSlots(const PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+**                         char *, long)
+** long long embedBytes(PixelBuffer *, const BitMask *, long long, const char *, long, RowRange *,
+**                      MatchingRandom *)
+** long long retrieveBytes(const PixelBuffer *, const BitMask *, long long, char *, long)
+** bool retrieveField(const PixelBuffer *, const BitMask *, long long *, string *, size_t)
+** bool placeData(const PixelBuffer *, const BitMask *, const StegoOptions *, long long, long long,
+**                PixelSelection *, long long *)
+** void selectPixels(const PixelBuffer *, const BitMask *, int, long long, long long, PixelSelection *)
+** void markRows(const PixelBuffer *, const BitMask *, int, long long, int, int, PixelSelection *)
+** long long embedSelected(PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+**                         const char *, long, RowRange *, MatchingRandom *)
+** long long retrieveSelected(const PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+**                            char *, long)
+** int gatherPixels(const unsigned char *, const unsigned long long *, int, int, unsigned char *)
+** void scatterPixels(unsigned char *, const unsigned long long *, int, int, const unsigned char *)
+** bool scoreBitMask(const unsigned short *, long, long long, unsigned int, MaskScore *)
+** void scoreBitMasks(const unsigned short *, long, long long, unsigned int, int, int, vector<MaskScore> *)
+** bool betterMask(const MaskScore &, const MaskScore &)
+** bool readsHeader(const PixelBuffer *, unsigned int)
+**
+**
+**	DATE:       October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** The steganography codec on its own, without Qt and without files.
+** The carrier is any block of pixels in one of the scanline layouts
+** and the secret comes from, and goes to, memory or a callback, so
+** the codec can be linked into other programs.
+**
+** The secret is stored as its file name, a null, its size as decimal
+** text, another null and then the raw data. Options that change where
+** the data goes follow the size after a semicolon (e.g.
+** "1234;adaptive=96"), so a secret embedded without any is stored the
+** same as it always was.
+**
+** The header always fills the first slots in order. With the adaptive
+** option the data only goes into the pixels whose texture (see
+** markTexturedPixels) reaches the threshold, where changes are hardest
+** to see. The texture ignores the enabled bit positions, so the
+** retriever works out the same pixels from the carrier alone. The
+** cost map is built on all the cores, a band of rows each.
+**
+** The matching option ("matching=1") embeds by LSB matching (see
+** embedBitsInScanline) instead of replacing bits. The bits end up the
+** same, so it is not written to the header and retrieving is unchanged.
+**
+** With the matrix option (e.g. "matrix=3") the data is matrix
+** embedded (see matrixEncode): each chunk of it is read back out of
+** the slots it will take, the few bits that need to change are
+** flipped, and the slots are written again. Chunks are a whole number
+** of k bits, so the retriever splits the data the same way.
+**
+** The fec option (e.g. "fec=32") protects the secret with Reed-Solomon
+** codes (see reedSolomon) that put right up to half that many damaged
+** bytes in every 255. The header is then padded to a fixed size and
+** given parity of its own, FEC_HEADER_PARITY bytes per codeword, so
+** it is found even when the size in it has been damaged. The data
+** follows as codewords of 255 bytes with the chosen parity, which are
+** embedded like any other data and can be combined with the other
+** options. A header with parity is always tried first when reading.
+**
+** Any byte of the data is found without retrieving the ones before it
+** (see stegoExtractRange): its slot follows from the k bits a block
+** holds, and with error correction only the codewords around it are
+** retrieved and corrected. The index option ("index=N") says the
+** first N bytes of the data are the index of an archive of several
+** files (see stegoArchive), which is how those are found, and the
+** tail option ("tail=N") that its last N bytes are more of the index.
+**
+** Data can be appended to a secret already embedded (see
+** stegoAppendStream). Only the new bytes are embedded, from the slot
+** after the last one, and the header is written again in place with
+** the new size. The size is padded with leading zeros so the header
+** keeps its length; when it can not, the data is moved once behind a
+** size of APPEND_SIZE_DIGITS digits, which every later append fits.
+**
+** A secret can be replaced by a new version of itself (see
+** stegoUpdate) by rewriting only the blocks of it that changed. Each
+** block of the new data is compared with what its slots hold, and
+** only the ones that differ are embedded again, along with the header
+** when the size changed.
+**
+** A secret whose size is not known until it ends, e.g. one read from
+** a pipe, is embedded with a size of APPEND_SIZE_DIGITS zeros in its
+** header (see stegoEmbedUnsized). The data is embedded as it arrives,
+** and the header is written with the real size once the reader runs
+** out, so it reads back like any other secret.
+**
+** Each stage is timed through stegoTrace, so the time spent in the
+** bit loops shows up apart from the decode and the save.
+*************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "stegoCore.h"
+#include "stegoTrace.h"
+#include "reedSolomon.h"
+
+using namespace std;
+
+#define SELECT_BAND_ROWS 32
+#define SELECT_ROUND_BANDS 4
+
+//the header with error correction: two codewords of data, then their parity
+#define FEC_HEADER_DATA 191
+#define FEC_HEADER_PARITY 64
+#define FEC_HEADER_CODEWORDS 2
+#define FEC_HEADER_BYTES (FEC_HEADER_CODEWORDS * RS_CODEWORD_LENGTH)
+
+//codewords embedded or retrieved at a time, a multiple of every matrix k in bytes,
+//and chunks of them encoded or decoded at a time across the cores
+#define FEC_CHUNK_CODEWORDS 224
+#define FEC_BATCH_CHUNKS 16
+
+//digits the size is padded to when an append has to move the data, enough for any size
+#define APPEND_SIZE_DIGITS 19
+
+//bytes of a secret compared and rewritten at a time by an update, less a remainder of
+//the matrix k, and codewords at a time with error correction, a multiple of every k in bytes
+#define UPDATE_BLOCK_SIZE 4096
+#define UPDATE_BLOCK_CODEWORDS 56
+
+//bit mask that decodes to a believable header, and how believable it is
+struct MaskScore
+{
+    unsigned int mask;
+    int plainName;              //1 if the name is printable ASCII
+    int oddCharacters;          //characters of the name seldom found in file names
+    int length;                 //length of the header
+};
+
+//secret being embedded straight from memory
+struct MemorySource
+{
+    const char *data;
+    long long remaining;
+};
+
+//data being appended: bytes already embedded that go in again, then the new bytes
+struct AppendSource
+{
+    MemorySource kept;
+    StegoReader reader;
+    void *context;
+};
+
+//secret of unknown size being embedded, counted as it is read
+struct CountedSource
+{
+    StegoReader reader;
+    void *context;
+    long long count;
+};
+
+//pixels that hold the data of a secret
+struct PixelSelection
+{
+    int threshold;                          //0 when the data fills every slot in order
+    int wordsPerRow;
+    vector<unsigned long long> marked;      //one bit per pixel, row by row
+    vector<long long> before;               //pixels marked before each row, height + 1 of them
+};
+
+static long readMemory(void *, char *, long);
+static bool writeMemory(void *, const char *, long);
+static long readAppend(void *, char *, long);
+static long readCounted(void *, char *, long);
+static long readChunk(StegoReader, void *, char *, long);
+static long chunkLength(const StegoOptions *);
+static long long dataSlots(const StegoOptions *, long long);
+static long long fittingSize(const StegoOptions *, long long);
+static string buildHeader(const string &, long long, const StegoOptions *, int);
+static string encodeFecHeader(const string &);
+static bool readFecHeader(const PixelBuffer *, const BitMask *, SecretHeader *);
+static bool parseSizeField(const string &, long long *, StegoOptions *);
+static long long embedChunk(PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+                            const char *, long, RowRange *, MatchingRandom *);
+static void retrieveStream(const PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+                           long long, char *, long);
+static long long retrieveChunk(const PixelBuffer *, const BitMask *, const PixelSelection *, int, long long,
+                               char *, long);
+static long long embedSlots(PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+                            const char *, long, RowRange *, MatchingRandom *);
+static long long retrieveSlots(const PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+                               char *, long);
+static long long embedBytes(PixelBuffer *, const BitMask *, long long, const char *, long, RowRange *,
+                            MatchingRandom *);
+static long long retrieveBytes(const PixelBuffer *, const BitMask *, long long, char *, long);
+static bool retrieveField(const PixelBuffer *, const BitMask *, long long *, string *, size_t);
+static bool placeData(const PixelBuffer *, const BitMask *, const StegoOptions *, long long, long long,
+                      PixelSelection *, long long *);
+static void selectPixels(const PixelBuffer *, const BitMask *, int, long long, long long, PixelSelection *);
+static void markRows(const PixelBuffer *, const BitMask *, int, long long, int, int, PixelSelection *);
+static long long embedSelected(PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+                               const char *, long, RowRange *, MatchingRandom *);
+static long long retrieveSelected(const PixelBuffer *, const BitMask *, const PixelSelection *, long long,
+                                  char *, long);
+static int gatherPixels(const unsigned char *, const unsigned long long *, int, int, unsigned char *);
+static void scatterPixels(unsigned char *, const unsigned long long *, int, int, const unsigned char *);
+static bool scoreBitMask(const unsigned short *, long, long long, unsigned int, MaskScore *);
+static void scoreBitMasks(const unsigned short *, long, long long, unsigned int, int, int, vector<MaskScore> *);
+static bool betterMask(const MaskScore &, const MaskScore &);
+static bool readsHeader(const PixelBuffer *, unsigned int);
+static int embedData(PixelBuffer *, const BitMask *, const PixelSelection *, const StegoOptions *, long long,
+                     long long, StegoReader, void *, RowRange *, MatchingRandom *);
+static int embedFecData(PixelBuffer *, const BitMask *, const PixelSelection *, const StegoOptions *, long long,
+                        const char *, long, long long, StegoReader, void *, RowRange *, MatchingRandom *);
+static int retrieveFecData(const PixelBuffer *, const BitMask *, const PixelSelection *, const SecretHeader *,
+                           long long, StegoWriter, void *);
+
+
+/*****************************************************************
+** Function: stegoDefaultOptions
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Embeds bit for bit by default
+** October 19th, 2026 - Replaces bits by default
+** October 19th, 2026 - No error correction by default
+** October 19th, 2026 - A single file by default
+** October 19th, 2026 - No index at the end by default
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void stegoDefaultOptions(StegoOptions *options)
+**              StegoOptions *options -- Set to embedding in every slot in order
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+void stegoDefaultOptions(StegoOptions *options)
+{
+    options->adaptiveThreshold = 0;
+    options->matrixBits = 0;
+    options->matching = 0;
+    options->fecParity = 0;
+    options->archiveIndex = 0;
+    options->archiveTail = 0;
+}
+
+
+
+/*****************************************************************
+** Function: stegoFormatOptions
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Writes the matrix option
+** October 19th, 2026 - Leaves out the matching option
+** October 19th, 2026 - Writes the fec option
+** October 19th, 2026 - Writes the index option
+** October 19th, 2026 - Writes the tail option
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string stegoFormatOptions(const StegoOptions *options)
+**              const StegoOptions *options -- Options to write out, may be null
+**
+**
+** Returns:
+**			string -- The options that differ from the defaults, separated
+**                    by semicolons, e.g. "adaptive=96;matrix=3"
+**
+** Notes:
+** Leaves out matching, which the retriever does not need.
+**********************************************************************/
+string stegoFormatOptions(const StegoOptions *options)
+{
+    stringstream ss;
+    if (options == NULL)
+    {
+        return "";
+    }
+
+    if (options->adaptiveThreshold > 0)
+    {
+        ss << "adaptive=" << options->adaptiveThreshold;
+    }
+    if (options->matrixBits > 0)
+    {
+        ss << (ss.str().empty() ? "" : ";") << "matrix=" << options->matrixBits;
+    }
+    if (options->fecParity > 0)
+    {
+        ss << (ss.str().empty() ? "" : ";") << "fec=" << options->fecParity;
+    }
+    if (options->archiveIndex > 0)
+    {
+        ss << (ss.str().empty() ? "" : ";") << "index=" << options->archiveIndex;
+    }
+    if (options->archiveTail > 0)
+    {
+        ss << (ss.str().empty() ? "" : ";") << "tail=" << options->archiveTail;
+    }
+
+    return ss.str();
+}
+
+
+
+/*****************************************************************
+** Function: stegoParseOptions
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Reads the matrix option
+** October 19th, 2026 - Reads the matching option
+** October 19th, 2026 - Reads the fec option
+** October 19th, 2026 - Reads the index option
+** October 19th, 2026 - Reads the tail option
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool stegoParseOptions(const string &text, StegoOptions *options)
+**              const string &text -- Options written by stegoFormatOptions
+**              StegoOptions *options -- Set to the options, defaults for the rest
+**
+**
+** Returns:
+**			bool -- False if an option is unknown or its value is bad
+**********************************************************************/
+bool stegoParseOptions(const string &text, StegoOptions *options)
+{
+    stegoDefaultOptions(options);
+
+    stringstream ss(text);
+    string option;
+    while (getline(ss, option, ';'))
+    {
+        size_t equals = option.find('=');
+        if (equals == string::npos)
+        {
+            return false;
+        }
+
+        string key = option.substr(0, equals);
+        string value = option.substr(equals + 1);
+        if (value.empty() || value.length() > 9 || value.find_first_not_of("0123456789") != string::npos)
+        {
+            return false;
+        }
+
+        if (key == "adaptive")
+        {
+            options->adaptiveThreshold = atoi(value.c_str());
+        }
+        else if (key == "matching")
+        {
+            options->matching = atoi(value.c_str());
+            if (options->matching > 1)
+            {
+                return false;
+            }
+        }
+        else if (key == "matrix")
+        {
+            options->matrixBits = atoi(value.c_str());
+            if (options->matrixBits < MIN_MATRIX_BITS || options->matrixBits > MAX_MATRIX_BITS)
+            {
+                return false;
+            }
+        }
+        else if (key == "fec")
+        {
+            options->fecParity = atoi(value.c_str());
+            if (options->fecParity < MIN_FEC_PARITY || options->fecParity > MAX_FEC_PARITY)
+            {
+                return false;
+            }
+        }
+        else if (key == "index")
+        {
+            options->archiveIndex = atoi(value.c_str());
+            if (options->archiveIndex == 0)
+            {
+                return false;
+            }
+        }
+        else if (key == "tail")
+        {
+            options->archiveTail = atoi(value.c_str());
+            if (options->archiveTail == 0)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: stegoCapacity
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Counts only the textured pixels for adaptive embedding
+** October 19th, 2026 - Counts k bits per block of 2^k slots for matrix embedding
+** October 19th, 2026 - Leaves out the parity of error correction
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long stegoCapacity(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                  const StegoOptions *options)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const StegoOptions *options -- How the data is spread, may be null
+**
+**
+** Returns:
+**			long long -- Number of bits the carrier can hold, header included
+**
+** Notes:
+** For adaptive embedding this is the slots of the textured pixels. The
+** header takes the first pixels in order, so slightly less than that
+** is left for the data. Matrix embedding holds k bits in every 2^k
+** slots, and error correction leaves the data 255 less the parity
+** bytes of every 255.
+**********************************************************************/
+long long stegoCapacity(const PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options)
+{
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    long long numSlots = (long long) carrier->width * carrier->height * slotsPerPixel;
+
+    if (options == NULL)
+    {
+        return numSlots;
+    }
+
+    if (options->adaptiveThreshold > 0)
+    {
+        PixelSelection selection;
+        selectPixels(carrier, bitMask, options->adaptiveThreshold, 0, -1, &selection);
+        numSlots = selection.before[carrier->height] * slotsPerPixel;
+    }
+
+    if (options->matrixBits > 0)
+    {
+        numSlots = (numSlots >> options->matrixBits) * options->matrixBits;
+    }
+
+    if (options->fecParity > 0)
+    {
+        numSlots = numSlots / RS_CODEWORD_LENGTH * (RS_CODEWORD_LENGTH - options->fecParity);
+    }
+
+    return numSlots;
+}
+
+
+
+/*****************************************************************
+** Function: stegoSlotsNeeded
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long stegoSlotsNeeded(const string &name, long long size, const StegoOptions *options)
+**              const string &name -- Name of the secret's file
+**              long long size -- Size of the secret
+**              const StegoOptions *options -- How the data would be spread, may be null
+**
+**
+** Returns:
+**			long long -- Slots the header and data take, or -1 if they can not
+**                       be embedded with the options
+**
+** Notes:
+** Works out whether a secret fits a carrier from its dimensions alone:
+** it fits when the carrier has at least this many slots (see
+** stegoCapacity with no options). Adaptive embedding depends on the
+** pixels, so it can not be counted this way.
+**********************************************************************/
+long long stegoSlotsNeeded(const string &name, long long size, const StegoOptions *options)
+{
+    if (size < 0 || (options != NULL && options->adaptiveThreshold != 0))
+    {
+        return -1;
+    }
+
+    string header = buildHeader(name, size, options, 0);
+    if (options != NULL && options->fecParity > 0)
+    {
+        if (header.length() > FEC_HEADER_DATA * FEC_HEADER_CODEWORDS)
+        {
+            return -1;
+        }
+        header = encodeFecHeader(header);
+    }
+
+    return (long long) header.length() * 8 + dataSlots(options, size);
+}
+
+
+
+/*****************************************************************
+** Function: stegoEmbed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Takes the options that spread the data
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoEmbed(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+**                         const string &name, const char *data, long long size, RowRange *modified)
+**              PixelBuffer *carrier -- Carrier pixels to embed the secret in
+**              const BitMask *bitMask -- Positions that are available
+**              const StegoOptions *options -- How to spread the data, may be null
+**              const string &name -- Name of the secret's file
+**              const char *data -- The secret
+**              long long size -- Size of the secret
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Embeds a secret that is already in memory.
+**********************************************************************/
+int stegoEmbed(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+               const string &name, const char *data, long long size, RowRange *modified)
+{
+    MemorySource source = {data, size};
+
+    return stegoEmbedStream(carrier, bitMask, options, name, size, readMemory, &source, modified);
+}
+
+
+
+/*****************************************************************
+** Function: stegoEmbedStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Writes the options after the size and can embed adaptively
+** October 19th, 2026 - Can matrix embed the data
+** October 19th, 2026 - Can embed by LSB matching
+** October 19th, 2026 - Can protect the header and data with error correction
+** October 19th, 2026 - Builds the header and embeds the data through buildHeader and embedData
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoEmbedStream(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+**                               const string &name, long long size, StegoReader reader, void *context,
+**                               RowRange *modified)
+**              PixelBuffer *carrier -- Carrier pixels to embed the secret in
+**              const BitMask *bitMask -- Positions that are available
+**              const StegoOptions *options -- How to spread the data, may be null
+**              const string &name -- Name of the secret's file
+**              long long size -- Size of the secret
+**              StegoReader reader -- Called for each chunk of the secret
+**              void *context -- Passed to the reader
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Embeds the header and then the secret, a chunk at a time as the
+** reader hands it over. Nothing is written if the secret does not fit.
+** LSB matching can not be used with adaptive embedding: a step can
+** carry into the bits the texture is measured on.
+**********************************************************************/
+int stegoEmbedStream(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+                     const string &name, long long size, StegoReader reader, void *context, RowRange *modified)
+{
+    RowRange rows = {-1, -1};
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    int matrixBits = (options != NULL) ? options->matrixBits : 0;
+    int fecParity = (options != NULL) ? options->fecParity : 0;
+    bool matching = (options != NULL && options->matching != 0);
+    if (carrier->data == NULL || bitMask->numBits == 0 || size < 0
+        || (options != NULL && options->adaptiveThreshold < 0)
+        || (matrixBits != 0 && (matrixBits < MIN_MATRIX_BITS || matrixBits > MAX_MATRIX_BITS))
+        || (fecParity != 0 && (fecParity < MIN_FEC_PARITY || fecParity > MAX_FEC_PARITY))
+        || (matching && options->adaptiveThreshold > 0))
+    {
+        return STEGO_ERROR;
+    }
+
+    //LSB matching steps up or down at random, a fresh sequence each embed
+    MatchingRandom matchingRandom;
+    MatchingRandom *random = NULL;
+    if (matching)
+    {
+        random_device device;
+        seedMatchingRandom(&matchingRandom, ((unsigned long long) device() << 32) | device());
+        random = &matchingRandom;
+    }
+
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    TraceSpan span;
+
+    string header = buildHeader(name, size, options, 0);
+
+    //with error correction the header is padded out and protected on its own,
+    //so the retriever can find it before it knows anything else
+    if (fecParity > 0)
+    {
+        if (header.length() > FEC_HEADER_DATA * FEC_HEADER_CODEWORDS)
+        {
+            return STEGO_ERROR;
+        }
+        header = encodeFecHeader(header);
+    }
+
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, options, (long long) header.length() * 8, dataSlots(options, size),
+                   &selection, &slot))
+    {
+        return STEGO_TOO_BIG;
+    }
+
+    traceBegin(&span, STAGE_HEADER_ENCODE);
+    long long headerSlots = embedBytes(carrier, bitMask, 0, header.data(), (long) header.length(), &rows, random);
+    traceEnd(&span, (headerSlots + slotsPerPixel - 1) / slotsPerPixel, (long long) header.length());
+
+    int result;
+    if (fecParity > 0)
+    {
+        result = embedFecData(carrier, bitMask, &selection, options, slot, NULL, 0, size, reader, context, &rows,
+                              random);
+    }
+    else
+    {
+        result = embedData(carrier, bitMask, &selection, options, slot, size, reader, context, &rows, random);
+    }
+
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: stegoEmbedUnsized
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoEmbedUnsized(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+**                                const string &name, StegoReader reader, void *context, long long *size,
+**                                RowRange *modified)
+**              PixelBuffer *carrier -- Carrier pixels to embed the secret in
+**              const BitMask *bitMask -- Positions that are available
+**              const StegoOptions *options -- How to spread the data, may be null
+**              const string &name -- Name of the secret's file
+**              StegoReader reader -- Called for each chunk of the secret until it returns 0
+**              void *context -- Passed to the reader
+**              long long *size -- Set to the size of the secret embedded
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_TOO_BIG if the reader still had bytes once
+**                 the carrier was full, STEGO_READ_FAILED if it had none at
+**                 all, or another STEGO_ error
+**
+** Notes:
+** Embeds a secret as the reader hands it over without knowing its
+** size up front. The slots of a header with a size of
+** APPEND_SIZE_DIGITS digits are kept free, the data goes in behind
+** them until the reader runs out, and only then is the header written
+** with the size. A reader that fails has to say so through its
+** context, as running out looks the same as the end of the secret.
+** When the secret does not fit, the carrier is left part written.
+**********************************************************************/
+int stegoEmbedUnsized(PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+                      const string &name, StegoReader reader, void *context, long long *size, RowRange *modified)
+{
+    RowRange rows = {-1, -1};
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+    *size = 0;
+
+    int matrixBits = (options != NULL) ? options->matrixBits : 0;
+    int fecParity = (options != NULL) ? options->fecParity : 0;
+    bool matching = (options != NULL && options->matching != 0);
+    if (carrier->data == NULL || bitMask->numBits == 0
+        || (options != NULL && options->adaptiveThreshold < 0)
+        || (matrixBits != 0 && (matrixBits < MIN_MATRIX_BITS || matrixBits > MAX_MATRIX_BITS))
+        || (fecParity != 0 && (fecParity < MIN_FEC_PARITY || fecParity > MAX_FEC_PARITY))
+        || (matching && options->adaptiveThreshold > 0))
+    {
+        return STEGO_ERROR;
+    }
+
+    //LSB matching steps up or down at random, a fresh sequence each embed
+    MatchingRandom matchingRandom;
+    MatchingRandom *random = NULL;
+    if (matching)
+    {
+        random_device device;
+        seedMatchingRandom(&matchingRandom, ((unsigned long long) device() << 32) | device());
+        random = &matchingRandom;
+    }
+
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    TraceSpan span;
+
+    //the header is only written at the end, but its length has to be known now
+    string header = buildHeader(name, 0, options, APPEND_SIZE_DIGITS);
+    if (fecParity > 0 && header.length() > FEC_HEADER_DATA * FEC_HEADER_CODEWORDS)
+    {
+        return STEGO_ERROR;
+    }
+    long long headerSlots = (long long) ((fecParity > 0) ? FEC_HEADER_BYTES : header.length()) * 8;
+
+    //the data may run to the end of the carrier, so every pixel that could hold it is selected
+    PixelSelection selection;
+    long long slot;
+    long long numSlots;
+    if (options == NULL || options->adaptiveThreshold == 0)
+    {
+        selection.threshold = 0;
+        slot = headerSlots;
+        numSlots = stegoCapacity(carrier, bitMask, NULL) - headerSlots;
+    }
+    else
+    {
+        selectPixels(carrier, bitMask, options->adaptiveThreshold, (headerSlots + slotsPerPixel - 1) / slotsPerPixel,
+                     -1, &selection);
+        slot = 0;
+        numSlots = (headerSlots <= stegoCapacity(carrier, bitMask, NULL))
+                   ? selection.before[carrier->height] * slotsPerPixel : -1;
+    }
+
+    if (numSlots < 0)
+    {
+        return STEGO_TOO_BIG;
+    }
+
+    long long maxSize = fittingSize(options, numSlots);
+    CountedSource source = {reader, context, 0};
+
+    int result;
+    if (fecParity > 0)
+    {
+        result = embedFecData(carrier, bitMask, &selection, options, slot, NULL, 0, maxSize, readCounted, &source,
+                              &rows, random);
+    }
+    else
+    {
+        result = embedData(carrier, bitMask, &selection, options, slot, maxSize, readCounted, &source, &rows,
+                           random);
+    }
+
+    //running out before the carrier is full is the end of the secret, and filling
+    //it is only fine if the secret ends there too
+    char extra;
+    if (result == STEGO_READ_FAILED)
+    {
+        result = (source.count > 0) ? STEGO_OK : STEGO_READ_FAILED;
+    }
+    else if (result == STEGO_OK && readChunk(reader, context, &extra, 1) > 0)
+    {
+        result = STEGO_TOO_BIG;
+    }
+
+    if (result == STEGO_OK)
+    {
+        *size = source.count;
+
+        header = buildHeader(name, source.count, options, APPEND_SIZE_DIGITS);
+        if (fecParity > 0)
+        {
+            header = encodeFecHeader(header);
+        }
+
+        traceBegin(&span, STAGE_HEADER_ENCODE);
+        headerSlots = embedBytes(carrier, bitMask, 0, header.data(), (long) header.length(), &rows, random);
+        traceEnd(&span, (headerSlots + slotsPerPixel - 1) / slotsPerPixel, (long long) header.length());
+    }
+
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: stegoAppend
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoAppend(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+**                          const StegoOptions *options, const char *data, long long size, RowRange *modified)
+**              PixelBuffer *carrier -- Pixels with a secret embedded, changed in place
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              const StegoOptions *options -- Options of the grown secret, may be null for the header's
+**              const char *data -- Bytes to add to the end of the secret
+**              long long size -- Number of bytes
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Appends bytes that are already in memory.
+**********************************************************************/
+int stegoAppend(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                const StegoOptions *options, const char *data, long long size, RowRange *modified)
+{
+    MemorySource source = {data, size};
+
+    return stegoAppendStream(carrier, bitMask, header, options, header->size, size, readMemory, &source, modified);
+}
+
+
+
+/*****************************************************************
+** Function: stegoAppendStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoAppendStream(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+**                                const StegoOptions *options, long long offset, long long size,
+**                                StegoReader reader, void *context, RowRange *modified)
+**              PixelBuffer *carrier -- Pixels with a secret embedded, changed in place
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              const StegoOptions *options -- Options of the grown secret, may be null for the header's
+**              long long offset -- Byte of the data the new bytes go at, at most its size
+**              long long size -- Number of new bytes
+**              StegoReader reader -- Called for each chunk of the new bytes
+**              void *context -- Passed to the reader
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the options would move the data,
+**                 STEGO_TOO_BIG if the grown secret does not fit, STEGO_CORRUPT
+**                 if the codeword it grows from is too damaged, or another
+**                 STEGO_ error
+**
+** Notes:
+** The secret ends up offset + size bytes long, so an offset short of
+** its size writes over its last bytes. Only the options that do not
+** change where the data goes (matching, index and tail) may differ
+** from the header's. The new bytes are embedded from the slot of the
+** offset; matrix embedded data starts again from its block, and data
+** with error correction from its codeword, whose bytes are retrieved
+** first. The header is only written once the data is in, so a reader
+** that runs out leaves the old size behind it.
+**********************************************************************/
+int stegoAppendStream(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                      const StegoOptions *options, long long offset, long long size,
+                      StegoReader reader, void *context, RowRange *modified)
+{
+    RowRange rows = {-1, -1};
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    StegoOptions appendOptions = (options != NULL) ? *options : header->options;
+    if (carrier->data == NULL || bitMask->numBits == 0 || offset < 0 || offset > header->size || size < 0
+        || offset + size == 0 || appendOptions.adaptiveThreshold != header->options.adaptiveThreshold
+        || appendOptions.matrixBits != header->options.matrixBits
+        || appendOptions.fecParity != header->options.fecParity
+        || (appendOptions.matching != 0 && appendOptions.adaptiveThreshold > 0))
+    {
+        return STEGO_ERROR;
+    }
+
+    //LSB matching steps up or down at random, a fresh sequence each append
+    MatchingRandom matchingRandom;
+    MatchingRandom *random = NULL;
+    if (appendOptions.matching != 0)
+    {
+        random_device device;
+        seedMatchingRandom(&matchingRandom, ((unsigned long long) device() << 32) | device());
+        random = &matchingRandom;
+    }
+
+    long long newSize = offset + size;
+    int matrixBits = appendOptions.matrixBits;
+    int parity = appendOptions.fecParity;
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    TraceSpan span;
+
+    //the size is padded out to keep the header the length it was, and if it has
+    //outgrown that the data moves behind a size that leaves room for later appends
+    string headerText = buildHeader(header->name, newSize, &appendOptions, 0);
+    long long oldLength = header->dataSlot / 8;
+    if (parity == 0 && (long long) headerText.length() < oldLength)
+    {
+        int sizeDigits = (int) (to_string(newSize).length() + oldLength - headerText.length());
+        headerText = buildHeader(header->name, newSize, &appendOptions, sizeDigits);
+    }
+    else if (parity == 0 && (long long) headerText.length() > oldLength)
+    {
+        headerText = buildHeader(header->name, newSize, &appendOptions, APPEND_SIZE_DIGITS);
+    }
+    else if (parity > 0)
+    {
+        if (headerText.length() > FEC_HEADER_DATA * FEC_HEADER_CODEWORDS)
+        {
+            return STEGO_ERROR;
+        }
+        headerText = encodeFecHeader(headerText);
+    }
+
+    long long dataSlot = (long long) headerText.length() * 8;
+    bool moved = (dataSlot != header->dataSlot);
+
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, &appendOptions, dataSlot, dataSlots(&appendOptions, newSize), &selection, &slot))
+    {
+        return STEGO_TOO_BIG;
+    }
+
+    //codewords are encoded whole, so the one the offset falls in is encoded again with its
+    //bytes before the offset, which are retrieved (all of them if the data moves)
+    long dataPerCodeword = RS_CODEWORD_LENGTH - parity;
+    long long restart = offset;
+    long long encodedStart = offset;
+    if (moved)
+    {
+        restart = 0;
+        encodedStart = 0;
+    }
+    else if (parity > 0)
+    {
+        restart = offset - offset % dataPerCodeword;
+        encodedStart = restart / dataPerCodeword * RS_CODEWORD_LENGTH;
+    }
+
+    vector<char> kept;
+    if (restart < offset)
+    {
+        kept.reserve((size_t) (offset - restart));
+        int result = stegoExtractRange(carrier, bitMask, header, restart, offset - restart, writeMemory, &kept);
+        if (result != STEGO_OK)
+        {
+            return result;
+        }
+    }
+
+    //matrix embedded bytes are written from the start of their block, so those of
+    //it already embedded are read back out to go in again unchanged
+    long unit = (matrixBits == 0) ? 1 : matrixBits;
+    long lead = (long) (encodedStart % unit);
+    char leadBytes[MAX_MATRIX_BITS];
+    StegoOptions streamOptions = appendOptions;
+    streamOptions.fecParity = 0;
+    slot += dataSlots(&streamOptions, encodedStart - lead);
+    if (lead > 0)
+    {
+        retrieveStream(carrier, bitMask, &selection, matrixBits, slot, 0, leadBytes, lead);
+    }
+
+    int result;
+    if (parity > 0)
+    {
+        AppendSource source = {{kept.data(), (long long) kept.size()}, reader, context};
+        result = embedFecData(carrier, bitMask, &selection, &appendOptions, slot, leadBytes, lead,
+                              (long long) kept.size() + size, readAppend, &source, &rows, random);
+    }
+    else
+    {
+        AppendSource source = {{moved ? kept.data() : leadBytes, moved ? (long long) kept.size() : lead},
+                               reader, context};
+        result = embedData(carrier, bitMask, &selection, &appendOptions, slot, source.kept.remaining + size,
+                           readAppend, &source, &rows, random);
+    }
+
+    if (result == STEGO_OK)
+    {
+        traceBegin(&span, STAGE_HEADER_ENCODE);
+        long long headerSlots = embedBytes(carrier, bitMask, 0, headerText.data(), (long) headerText.length(),
+                                           &rows, random);
+        traceEnd(&span, (headerSlots + slotsPerPixel - 1) / slotsPerPixel, (long long) headerText.length());
+    }
+
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: stegoUpdate
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoUpdate(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+**                          const StegoOptions *options, const char *data, long long size,
+**                          long long *changed, RowRange *modified)
+**              PixelBuffer *carrier -- Pixels with a secret embedded, changed in place
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              const StegoOptions *options -- Options of the new secret, may be null for the header's
+**              const char *data -- New version of the secret
+**              long long size -- Size of the new version
+**              long long *changed -- Set to the bytes of the secret embedded again
+**              RowRange *modified -- Set to the rows written, may be null
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the options would move the data,
+**                 STEGO_TOO_BIG if the new version does not fit, or another
+**                 STEGO_ error
+**
+** Notes:
+** The data is taken UPDATE_BLOCK_SIZE bytes at a time, or
+** UPDATE_BLOCK_CODEWORDS codewords with error correction. Each block
+** is compared with the slots it goes in, read as they are, and only
+** embedded if they differ, so what it costs to write follows the size
+** of the change. Codewords are compared with their parity, so one a
+** few damaged slots no longer match is written again whole. As for
+** stegoAppendStream, only matching, index and tail may differ from the
+** header's options. The header is padded to keep its length; when it
+** can not, the whole secret is embedded again behind a longer one.
+**********************************************************************/
+int stegoUpdate(PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                const StegoOptions *options, const char *data, long long size, long long *changed,
+                RowRange *modified)
+{
+    RowRange rows = {-1, -1};
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+    *changed = 0;
+
+    StegoOptions updateOptions = (options != NULL) ? *options : header->options;
+    if (carrier->data == NULL || bitMask->numBits == 0 || size <= 0
+        || updateOptions.adaptiveThreshold != header->options.adaptiveThreshold
+        || updateOptions.matrixBits != header->options.matrixBits
+        || updateOptions.fecParity != header->options.fecParity
+        || (updateOptions.matching != 0 && updateOptions.adaptiveThreshold > 0))
+    {
+        return STEGO_ERROR;
+    }
+
+    int matrixBits = updateOptions.matrixBits;
+    int parity = updateOptions.fecParity;
+
+    //the size is padded out to keep the header the length it was, and if it has
+    //outgrown that the data is embedded again behind a longer one
+    string headerText = buildHeader(header->name, size, &updateOptions, 0);
+    long long oldLength = header->dataSlot / 8;
+    if (parity == 0 && (long long) headerText.length() > oldLength)
+    {
+        MemorySource source = {data, size};
+        *changed = size;
+        return stegoAppendStream(carrier, bitMask, header, &updateOptions, 0, size, readMemory, &source, modified);
+    }
+    else if (parity == 0)
+    {
+        int sizeDigits = (int) (to_string(size).length() + oldLength - headerText.length());
+        headerText = buildHeader(header->name, size, &updateOptions, sizeDigits);
+    }
+    else
+    {
+        if (headerText.length() > FEC_HEADER_DATA * FEC_HEADER_CODEWORDS)
+        {
+            return STEGO_ERROR;
+        }
+        headerText = encodeFecHeader(headerText);
+    }
+
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, &updateOptions, header->dataSlot, dataSlots(&updateOptions, size),
+                   &selection, &slot))
+    {
+        return STEGO_TOO_BIG;
+    }
+
+    //LSB matching steps up or down at random, a fresh sequence each update
+    MatchingRandom matchingRandom;
+    MatchingRandom *random = NULL;
+    if (updateOptions.matching != 0)
+    {
+        random_device device;
+        seedMatchingRandom(&matchingRandom, ((unsigned long long) device() << 32) | device());
+        random = &matchingRandom;
+    }
+
+    long blockLength = (parity > 0) ? UPDATE_BLOCK_CODEWORDS * (RS_CODEWORD_LENGTH - parity)
+                                    : UPDATE_BLOCK_SIZE - UPDATE_BLOCK_SIZE % ((matrixBits == 0) ? 1 : matrixBits);
+    vector<char> encoded((size_t) UPDATE_BLOCK_CODEWORDS * RS_CODEWORD_LENGTH);
+    vector<char> embedded(encoded.size());
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    TraceSpan span;
+
+    for (long long offset = 0; offset < size; offset += blockLength)
+    {
+        long length = (size - offset < blockLength) ? (long) (size - offset) : blockLength;
+        const char *block = data + offset;
+        long encodedLength = length;
+
+        if (parity > 0)
+        {
+            traceBegin(&span, STAGE_FEC_ENCODE);
+            fecEncode((const unsigned char *) block, length, parity, (unsigned char *) encoded.data());
+            encodedLength = (long) fecEncodedSize(length, parity);
+            block = encoded.data();
+            traceEnd(&span, 0, length);
+        }
+
+        traceBegin(&span, STAGE_EXTRACT);
+        long long numSlots = retrieveChunk(carrier, bitMask, &selection, matrixBits, slot, embedded.data(),
+                                           encodedLength);
+        traceEnd(&span, numSlots / slotsPerPixel, encodedLength);
+
+        if (memcmp(block, embedded.data(), encodedLength) != 0)
+        {
+            traceBegin(&span, STAGE_EMBED);
+            embedChunk(carrier, bitMask, &selection, matrixBits, slot, block, encodedLength, &rows, random);
+            traceEnd(&span, numSlots / slotsPerPixel, encodedLength);
+
+            *changed += length;
+        }
+
+        slot += numSlots;
+    }
+
+    //the header only changes with the size, or when its parity no longer matches
+    traceBegin(&span, STAGE_HEADER_ENCODE);
+    string oldHeader(headerText.length(), '\0');
+    retrieveBytes(carrier, bitMask, 0, &oldHeader[0], (long) oldHeader.length());
+    if (oldHeader != headerText)
+    {
+        embedBytes(carrier, bitMask, 0, headerText.data(), (long) headerText.length(), &rows, random);
+    }
+    traceEnd(&span, ((long long) headerText.length() * 8 + slotsPerPixel - 1) / slotsPerPixel,
+             (long long) headerText.length());
+
+    if (modified != NULL)
+    {
+        *modified = rows;
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: stegoReadHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Reads the options after the size
+** October 19th, 2026 - Reads and corrects a header with error correction first
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoReadHeader(const PixelBuffer *carrier, const BitMask *bitMask, SecretHeader *header)
+**              const PixelBuffer *carrier -- Pixels that may have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              SecretHeader *header -- Filled in with the header found
+**
+**
+** Returns:
+**			int -- STEGO_OK, or STEGO_NO_SECRET if there is no believable header
+**
+** Notes:
+** Reads the file name and size, and checks that a secret of that
+** size could fit behind them. Stops at the end of the carrier if
+** no delimeter turns up. A header with error correction is read
+** whole and put right before it is checked.
+**********************************************************************/
+int stegoReadHeader(const PixelBuffer *carrier, const BitMask *bitMask, SecretHeader *header)
+{
+    if (carrier->data == NULL || bitMask->numBits == 0)
+    {
+        return STEGO_ERROR;
+    }
+
+    long long slot = 0;
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    TraceSpan span;
+    traceBegin(&span, STAGE_HEADER_DECODE);
+
+    if (readFecHeader(carrier, bitMask, header))
+    {
+        traceEnd(&span, (FEC_HEADER_BYTES * 8 + slotsPerPixel - 1) / slotsPerPixel, FEC_HEADER_BYTES);
+        return STEGO_OK;
+    }
+
+    //first we need the file name, then the file size
+    string fileName;
+    string fileSizeStr;
+    bool found = retrieveField(carrier, bitMask, &slot, &fileName, MAX_NAME_LENGTH)
+                 && retrieveField(carrier, bitMask, &slot, &fileSizeStr, MAX_SIZE_LENGTH + MAX_OPTIONS_LENGTH)
+                 && !fileName.empty();
+
+    traceEnd(&span, (slot + slotsPerPixel - 1) / slotsPerPixel, slot / 8);
+    if (!found)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    StegoOptions options;
+    long long fileSize;
+    if (!parseSizeField(fileSizeStr, &fileSize, &options))
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    //the parity of a header that could not be put right still comes before the data
+    if (options.fecParity > 0)
+    {
+        slot = FEC_HEADER_BYTES * 8;
+    }
+
+    //make sure we got a proper file size before continuing
+    if (slot + dataSlots(&options, fileSize) > stegoCapacity(carrier, bitMask, NULL))
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    header->name = fileName;
+    header->size = fileSize;
+    header->dataSlot = slot;
+    header->options = options;
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: stegoExtract
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Retrieves adaptively embedded data
+** October 19th, 2026 - Retrieves matrix embedded data
+** October 19th, 2026 - Corrects data with error correction through stegoExtractStream
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoExtract(const PixelBuffer *carrier, const BitMask *bitMask,
+**                           string *name, vector<char> *data)
+**              const PixelBuffer *carrier -- Pixels that may have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              string *name -- Set to the name of the secret's file
+**              vector<char> *data -- Set to the secret
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Retrieves the whole secret into memory.
+**********************************************************************/
+int stegoExtract(const PixelBuffer *carrier, const BitMask *bitMask, string *name, vector<char> *data)
+{
+    SecretHeader header;
+    int result = stegoReadHeader(carrier, bitMask, &header);
+    if (result != STEGO_OK)
+    {
+        return result;
+    }
+
+    if (header.options.fecParity > 0)
+    {
+        data->clear();
+        data->reserve((size_t) header.size);
+        result = stegoExtractStream(carrier, bitMask, &header, writeMemory, data);
+        if (result == STEGO_OK)
+        {
+            *name = header.name;
+        }
+        return result;
+    }
+
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, &header.options, header.dataSlot, dataSlots(&header.options, header.size),
+                   &selection, &slot))
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    data->resize((size_t) header.size);
+
+    //read the raw data now that we know the name + size
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    long chunk = chunkLength(&header.options);
+    long long done = 0;
+    TraceSpan span;
+    while (done < header.size)
+    {
+        long length = (header.size - done < chunk) ? (long) (header.size - done) : chunk;
+
+        traceBegin(&span, STAGE_EXTRACT);
+        long long numSlots = retrieveChunk(carrier, bitMask, &selection, header.options.matrixBits, slot,
+                                           data->data() + done, length);
+        traceEnd(&span, numSlots / slotsPerPixel, length);
+
+        slot += numSlots;
+        done += length;
+    }
+
+    *name = header.name;
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: stegoExtractStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Retrieves adaptively embedded data
+** October 19th, 2026 - Retrieves matrix embedded data
+** October 19th, 2026 - Corrects data with error correction
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoExtractStream(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                 const SecretHeader *header, StegoWriter writer, void *context)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              StegoWriter writer -- Called for each chunk of the secret
+**              void *context -- Passed to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_WRITE_FAILED if the writer stopped, or
+**                 STEGO_CORRUPT if the data was too damaged to put right
+**
+** Notes:
+** Retrieves the secret a chunk at a time, so the caller can decide
+** where it goes once it has seen the header.
+**********************************************************************/
+int stegoExtractStream(const PixelBuffer *carrier, const BitMask *bitMask,
+                       const SecretHeader *header, StegoWriter writer, void *context)
+{
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, &header->options, header->dataSlot, dataSlots(&header->options, header->size),
+                   &selection, &slot))
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    if (header->options.fecParity > 0)
+    {
+        return retrieveFecData(carrier, bitMask, &selection, header, slot, writer, context);
+    }
+
+    vector<char> buffer(READ_CHUNK_SIZE);
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    long chunk = chunkLength(&header->options);
+    long long remaining = header->size;
+    TraceSpan span;
+
+    while (remaining > 0)
+    {
+        long length = (remaining < chunk) ? (long) remaining : chunk;
+
+        traceBegin(&span, STAGE_EXTRACT);
+        long long numSlots = retrieveChunk(carrier, bitMask, &selection, header->options.matrixBits, slot,
+                                           buffer.data(), length);
+        traceEnd(&span, numSlots / slotsPerPixel, length);
+        slot += numSlots;
+
+        traceBegin(&span, STAGE_SECRET_WRITE);
+        bool written = writer(context, buffer.data(), length);
+        traceEnd(&span, 0, length);
+
+        if (!written)
+        {
+            return STEGO_WRITE_FAILED;
+        }
+        remaining -= length;
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: stegoExtractRange
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoExtractRange(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                const SecretHeader *header, long long offset, long long length,
+**                                StegoWriter writer, void *context)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const SecretHeader *header -- Header read by stegoReadHeader
+**              long long offset -- First byte of the data to retrieve
+**              long long length -- Number of bytes
+**              StegoWriter writer -- Called for each chunk of the range
+**              void *context -- Passed to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_ERROR if the range is not in the secret,
+**                 STEGO_WRITE_FAILED if the writer stopped, or STEGO_CORRUPT if
+**                 a codeword was too damaged to put right
+**
+** Notes:
+** Goes straight to the slot of the first byte. Matrix embedded data
+** is retrieved from the start of the block holding it, and data with
+** error correction from the start of its codeword, so only the slots
+** of the range itself are read. With the adaptive option the textured
+** pixels are only counted as far as the end of the range.
+**********************************************************************/
+int stegoExtractRange(const PixelBuffer *carrier, const BitMask *bitMask, const SecretHeader *header,
+                      long long offset, long long length, StegoWriter writer, void *context)
+{
+    if (offset < 0 || length < 0 || offset + length > header->size)
+    {
+        return STEGO_ERROR;
+    }
+
+    int matrixBits = header->options.matrixBits;
+    int parity = header->options.fecParity;
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    long chunk = chunkLength(&header->options);
+    long long end = offset + length;
+    TraceSpan span;
+
+    //only the slots up to the end of the range, or of its last codeword, have to be found
+    long dataPerCodeword = RS_CODEWORD_LENGTH - parity;
+    long long lastCodeword = (parity > 0) ? (end + dataPerCodeword - 1) / dataPerCodeword : 0;
+    long long encodedSize = (parity > 0) ? fecEncodedSize(header->size, parity) : 0;
+    StegoOptions streamOptions = header->options;
+    streamOptions.fecParity = 0;
+    long long rangeEnd = (parity > 0) ? min(lastCodeword * RS_CODEWORD_LENGTH, encodedSize) : end;
+    long long rangeSlots = dataSlots(&streamOptions, rangeEnd);
+
+    PixelSelection selection;
+    long long slot;
+    if (!placeData(carrier, bitMask, &header->options, header->dataSlot, rangeSlots, &selection, &slot))
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    if (parity == 0)
+    {
+        //the first piece ends on a whole block so the rest start on one
+        vector<char> buffer(chunk);
+        long unit = (matrixBits == 0) ? 1 : matrixBits;
+        while (offset < end)
+        {
+            long piece = chunk - (long) (offset % unit);
+            long count = (end - offset < piece) ? (long) (end - offset) : piece;
+
+            traceBegin(&span, STAGE_EXTRACT);
+            retrieveStream(carrier, bitMask, &selection, matrixBits, slot, offset, buffer.data(), count);
+            traceEnd(&span, (long long) count * 8 / slotsPerPixel, count);
+
+            traceBegin(&span, STAGE_SECRET_WRITE);
+            bool written = writer(context, buffer.data(), count);
+            traceEnd(&span, 0, count);
+
+            if (!written)
+            {
+                return STEGO_WRITE_FAILED;
+            }
+            offset += count;
+        }
+
+        return STEGO_OK;
+    }
+
+    //only the codewords holding the range are retrieved and corrected, a batch at a time
+    long long codeword = offset / dataPerCodeword;
+    vector<char> codewords((size_t) FEC_BATCH_CHUNKS * chunk);
+    vector<char> data((size_t) fecDataLength((long) codewords.size(), parity));
+
+    while (offset < end)
+    {
+        long long batchEnd = min(codeword + FEC_BATCH_CHUNKS * FEC_CHUNK_CODEWORDS, lastCodeword);
+        long long encodedStart = codeword * RS_CODEWORD_LENGTH;
+        long encodedLength = (long) (min(batchEnd * RS_CODEWORD_LENGTH, encodedSize) - encodedStart);
+
+        for (long done = 0; done < encodedLength; done += chunk)
+        {
+            long count = (encodedLength - done < chunk) ? encodedLength - done : chunk;
+
+            traceBegin(&span, STAGE_EXTRACT);
+            retrieveStream(carrier, bitMask, &selection, matrixBits, slot, encodedStart + done,
+                           codewords.data() + done, count);
+            traceEnd(&span, (long long) count * 8 / slotsPerPixel, count);
+        }
+
+        traceBegin(&span, STAGE_FEC_DECODE);
+        long corrected = fecDecode((const unsigned char *) codewords.data(), encodedLength, parity,
+                                   (unsigned char *) data.data());
+        long skip = (long) (offset - codeword * dataPerCodeword);
+        long count = fecDataLength(encodedLength, parity) - skip;
+        count = (end - offset < count) ? (long) (end - offset) : count;
+        traceEnd(&span, 0, count);
+
+        if (corrected < 0)
+        {
+            return STEGO_CORRUPT;
+        }
+
+        traceBegin(&span, STAGE_SECRET_WRITE);
+        bool written = writer(context, data.data() + skip, count);
+        traceEnd(&span, 0, count);
+
+        if (!written)
+        {
+            return STEGO_WRITE_FAILED;
+        }
+        offset += count;
+        codeword = batchEnd;
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: stegoDetectBitMask
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Ranks the masks by how believable their header is and
+**                      checks the best ones with stegoReadHeader
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int stegoDetectBitMask(const PixelBuffer *carrier, bool *enabledBits)
+**              const PixelBuffer *carrier -- Pixels that may have a secret embedded
+**              bool *enabledBits -- Set to the bit positions that were found
+**
+**
+** Returns:
+**			int -- Number of bit positions found, 0 if no mask or several equally
+**                 good ones gave a header
+**
+** Notes:
+** Finds the bit positions a secret was embedded with when they are not
+** known. Only the start of the carrier is read, once, and all 255 masks
+** of the low 8 positions are then tried against those channel values
+** on all the cores. A mask is a candidate if it decodes to a header
+** stegoReadHeader would take: a file name, a null, a decimal size and
+** options of a secret that fits in the carrier, and another null.
+**
+** Masks that share most of their positions with the real one often
+** decode to a header as well, so the candidates are ranked by how
+** much their name looks like a file name, then by the length of the
+** header (see betterMask). They are read whole with stegoReadHeader
+** from the best down, and when several equally good ones pass no mask
+** is given rather than a guess.
+**********************************************************************/
+int stegoDetectBitMask(const PixelBuffer *carrier, bool *enabledBits)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_DETECT);
+
+    int width = carrier->width;
+    int channels = channelsInFormat(carrier->format);
+    long long totalSamples = (long long) width * carrier->height * channels;
+
+    //enough channels for the longest header with only one bit position enabled
+    long long wanted = (long long) (MAX_NAME_LENGTH + MAX_SIZE_LENGTH + MAX_OPTIONS_LENGTH + 2) * NUM_BITS;
+    if (wanted > totalSamples)
+    {
+        wanted = totalSamples;
+    }
+
+    vector<unsigned short> samples(wanted + (long long) width * channels);
+    long numSamples = 0;
+    for (int row = 0; row < carrier->height && numSamples < wanted; row++)
+    {
+        numSamples += readScanlineSamples(carrier->data + row * carrier->stride, width, carrier->format,
+                                          samples.data() + numSamples);
+    }
+
+    //split the masks between the cores
+    int numThreads = (int) thread::hardware_concurrency();
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+
+    //legacy secrets only ever used the low 8 positions, and trying all
+    //65535 masks of a 16 bit carrier would let too many of them match
+    unsigned int numMasks = (1u << NUM_BITS) - 1;
+    vector<vector<MaskScore> > results(numThreads);
+    vector<thread> workers;
+    for (int i = 0; i < numThreads; i++)
+    {
+        workers.push_back(thread(scoreBitMasks, samples.data(), numSamples, totalSamples,
+                                 numMasks, i, numThreads, &results[i]));
+    }
+
+    vector<MaskScore> candidates;
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+        candidates.insert(candidates.end(), results[i].begin(), results[i].end());
+    }
+
+    stable_sort(candidates.begin(), candidates.end(), betterMask);
+
+    //read the best candidates whole until one passes, then any as good as it
+    size_t best = 0;
+    while (best < candidates.size() && !readsHeader(carrier, candidates[best].mask))
+    {
+        best++;
+    }
+
+    unsigned int bestMask = (best < candidates.size()) ? candidates[best].mask : 0;
+    for (size_t i = best + 1; i < candidates.size() && !betterMask(candidates[best], candidates[i]); i++)
+    {
+        if (readsHeader(carrier, candidates[i].mask))
+        {
+            bestMask = 0;
+        }
+    }
+
+    int numBits = 0;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        enabledBits[i] = (bestMask >> i) & 1;
+        numBits += enabledBits[i];
+    }
+
+    traceEnd(&span, numSamples / channels, 0);
+
+    return numBits;
+}
+
+
+
+/*****************************************************************
+** Function: readMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readMemory(void *context, char *buffer, long length)
+**              void *context -- The MemorySource being embedded
+**              char *buffer -- Receives the next bytes of the secret
+**              long length -- Most bytes to hand over
+**
+**
+** Returns:
+**			long -- Number of bytes handed over
+**********************************************************************/
+static long readMemory(void *context, char *buffer, long length)
+{
+    MemorySource *source = (MemorySource *) context;
+    if (length > source->remaining)
+    {
+        length = (long) source->remaining;
+    }
+
+    memcpy(buffer, source->data, length);
+    source->data += length;
+    source->remaining -= length;
+
+    return length;
+}
+
+
+
+/*****************************************************************
+** Function: writeMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeMemory(void *context, const char *buffer, long length)
+**              void *context -- vector<char> the secret is retrieved into
+**              const char *buffer -- Next bytes of the secret
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			bool -- Always true
+**********************************************************************/
+static bool writeMemory(void *context, const char *buffer, long length)
+{
+    vector<char> *data = (vector<char> *) context;
+    data->insert(data->end(), buffer, buffer + length);
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: readAppend
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readAppend(void *context, char *buffer, long length)
+**              void *context -- The AppendSource being embedded
+**              char *buffer -- Receives the next bytes
+**              long length -- Most bytes to hand over
+**
+**
+** Returns:
+**			long -- Number of bytes handed over
+**
+** Notes:
+** Hands over the bytes kept from the old data before the new ones.
+**********************************************************************/
+static long readAppend(void *context, char *buffer, long length)
+{
+    AppendSource *source = (AppendSource *) context;
+    if (source->kept.remaining > 0)
+    {
+        return readMemory(&source->kept, buffer, length);
+    }
+
+    return source->reader(source->context, buffer, length);
+}
+
+
+
+/*****************************************************************
+** Function: readCounted
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readCounted(void *context, char *buffer, long length)
+**              void *context -- The CountedSource being embedded
+**              char *buffer -- Receives the next bytes of the secret
+**              long length -- Most bytes to hand over
+**
+**
+** Returns:
+**			long -- Number of bytes handed over
+**********************************************************************/
+static long readCounted(void *context, char *buffer, long length)
+{
+    CountedSource *source = (CountedSource *) context;
+    long numRead = source->reader(source->context, buffer, length);
+    if (numRead > 0)
+    {
+        source->count += numRead;
+    }
+
+    return numRead;
+}
+
+
+
+/*****************************************************************
+** Function: readChunk
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readChunk(StegoReader reader, void *context, char *buffer, long length)
+**              StegoReader reader -- Reader of the secret
+**              void *context -- Passed to the reader
+**              char *buffer -- Receives the next bytes of the secret
+**              long length -- Number of bytes wanted
+**
+**
+** Returns:
+**			long -- Number of bytes read, less than asked for only if the
+**                  reader ran out
+**
+** Notes:
+** Keeps calling the reader until the chunk is full, so a matrix
+** embedded chunk is never cut short of a whole number of blocks.
+**********************************************************************/
+static long readChunk(StegoReader reader, void *context, char *buffer, long length)
+{
+    long done = 0;
+    while (done < length)
+    {
+        long numRead = reader(context, buffer + done, length - done);
+        if (numRead <= 0)
+        {
+            break;
+        }
+        done += numRead;
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: chunkLength
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long chunkLength(const StegoOptions *options)
+**              const StegoOptions *options -- How the data is spread, may be null
+**
+**
+** Returns:
+**			long -- Bytes of the secret embedded or retrieved at a time
+**
+** Notes:
+** For matrix embedding this is a multiple of k bytes, which is a
+** whole number of blocks. Only the last chunk of a secret has a
+** padded block. With error correction it is a whole number of
+** codewords, which is also a multiple of any k.
+**********************************************************************/
+static long chunkLength(const StegoOptions *options)
+{
+    if (options != NULL && options->fecParity > 0)
+    {
+        return FEC_CHUNK_CODEWORDS * RS_CODEWORD_LENGTH;
+    }
+
+    int matrixBits = (options != NULL) ? options->matrixBits : 0;
+    if (matrixBits == 0)
+    {
+        return READ_CHUNK_SIZE;
+    }
+
+    return READ_CHUNK_SIZE - READ_CHUNK_SIZE % matrixBits;
+}
+
+
+
+/*****************************************************************
+** Function: dataSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long dataSlots(const StegoOptions *options, long long size)
+**              const StegoOptions *options -- How the data is spread, may be null
+**              long long size -- Size of the secret
+**
+**
+** Returns:
+**			long long -- Number of slots the data of the secret takes
+**
+** Notes:
+** With error correction the size is that of the codewords.
+**********************************************************************/
+static long long dataSlots(const StegoOptions *options, long long size)
+{
+    int matrixBits = (options != NULL) ? options->matrixBits : 0;
+    if (options != NULL && options->fecParity > 0)
+    {
+        size = fecEncodedSize(size, options->fecParity);
+    }
+
+    if (matrixBits == 0)
+    {
+        return size * 8;
+    }
+
+    long long chunk = chunkLength(options);
+    long long blocksPerChunk = chunk * 8 / matrixBits;
+    long long last = size % chunk;
+    long long numBlocks = (size / chunk) * blocksPerChunk + (last * 8 + matrixBits - 1) / matrixBits;
+
+    return numBlocks << matrixBits;
+}
+
+
+
+/*****************************************************************
+** Function: fittingSize
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long fittingSize(const StegoOptions *options, long long numSlots)
+**              const StegoOptions *options -- How the data is spread, may be null
+**              long long numSlots -- Slots there are for the data
+**
+**
+** Returns:
+**			long long -- Largest size of a secret whose data fits in them
+**
+** Notes:
+** The data of a secret takes at least 8 slots a byte, so the size is
+** searched for between 0 and an eighth of the slots.
+**********************************************************************/
+static long long fittingSize(const StegoOptions *options, long long numSlots)
+{
+    long long low = 0;
+    long long high = numSlots / 8;
+
+    while (low < high)
+    {
+        long long middle = low + (high - low + 1) / 2;
+        if (dataSlots(options, middle) <= numSlots)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
+
+
+
+/*****************************************************************
+** Function: buildHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string buildHeader(const string &name, long long size, const StegoOptions *options, int sizeDigits)
+**              const string &name -- Name of the secret's file
+**              long long size -- Size of the secret
+**              const StegoOptions *options -- Options to write after the size, may be null
+**              int sizeDigits -- Fewest digits of the size, padded with leading zeros
+**
+**
+** Returns:
+**			string -- The name, size and options, each ended by a null
+**********************************************************************/
+static string buildHeader(const string &name, long long size, const StegoOptions *options, int sizeDigits)
+{
+    //the file name and the file size (with any options) are each followed by a null as a delimeter
+    stringstream ss;
+    ss << name << '\0' << setw(sizeDigits) << setfill('0') << size;
+    string optionText = stegoFormatOptions(options);
+    if (!optionText.empty())
+    {
+        ss << ';' << optionText;
+    }
+    ss << '\0';
+
+    return ss.str();
+}
+
+
+
+/*****************************************************************
+** Function: encodeFecHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string encodeFecHeader(const string &header)
+**              const string &header -- Name, size and options, each ended by a null
+**
+**
+** Returns:
+**			string -- FEC_HEADER_BYTES bytes: the header padded with nulls to
+**                    FEC_HEADER_CODEWORDS codewords of data, then their parity
+**
+** Notes:
+** The parity goes after all the data, so the header still reads in
+** order without being decoded, which is what detection looks for.
+**********************************************************************/
+static string encodeFecHeader(const string &header)
+{
+    string block(FEC_HEADER_BYTES, '\0');
+    memcpy(&block[0], header.data(), header.length());
+
+    unsigned char *bytes = (unsigned char *) &block[0];
+    for (int c = 0; c < FEC_HEADER_CODEWORDS; c++)
+    {
+        rsEncode(bytes + c * FEC_HEADER_DATA, FEC_HEADER_DATA, FEC_HEADER_PARITY,
+                 bytes + FEC_HEADER_CODEWORDS * FEC_HEADER_DATA + c * FEC_HEADER_PARITY);
+    }
+
+    return block;
+}
+
+
+
+/*****************************************************************
+** Function: readFecHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool readFecHeader(const PixelBuffer *carrier, const BitMask *bitMask, SecretHeader *header)
+**              const PixelBuffer *carrier -- Pixels that may have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              SecretHeader *header -- Filled in if a header with error correction is found
+**
+**
+** Returns:
+**			bool -- True if the header decoded, even after corrections, and
+**                  is believable
+**
+** Notes:
+** Random slots decode as a codeword far too rarely to matter, and
+** the header found must still ask for error correction.
+**********************************************************************/
+static bool readFecHeader(const PixelBuffer *carrier, const BitMask *bitMask, SecretHeader *header)
+{
+    long long capacity = stegoCapacity(carrier, bitMask, NULL);
+    if (capacity < FEC_HEADER_BYTES * 8)
+    {
+        return false;
+    }
+
+    unsigned char block[FEC_HEADER_BYTES];
+    retrieveBytes(carrier, bitMask, 0, (char *) block, FEC_HEADER_BYTES);
+
+    for (int c = 0; c < FEC_HEADER_CODEWORDS; c++)
+    {
+        if (rsDecode(block + c * FEC_HEADER_DATA, FEC_HEADER_DATA,
+                     block + FEC_HEADER_CODEWORDS * FEC_HEADER_DATA + c * FEC_HEADER_PARITY, FEC_HEADER_PARITY) < 0)
+        {
+            return false;
+        }
+    }
+
+    string text((const char *) block, FEC_HEADER_CODEWORDS * FEC_HEADER_DATA);
+    size_t nameEnd = text.find('\0');
+    size_t sizeEnd = (nameEnd == string::npos) ? string::npos : text.find('\0', nameEnd + 1);
+    if (sizeEnd == string::npos || nameEnd == 0 || nameEnd > MAX_NAME_LENGTH
+        || sizeEnd - nameEnd - 1 > MAX_SIZE_LENGTH + MAX_OPTIONS_LENGTH)
+    {
+        return false;
+    }
+
+    StegoOptions options;
+    long long fileSize;
+    if (!parseSizeField(text.substr(nameEnd + 1, sizeEnd - nameEnd - 1), &fileSize, &options)
+        || options.fecParity == 0 || FEC_HEADER_BYTES * 8 + dataSlots(&options, fileSize) > capacity)
+    {
+        return false;
+    }
+
+    header->name = text.substr(0, nameEnd);
+    header->size = fileSize;
+    header->dataSlot = FEC_HEADER_BYTES * 8;
+    header->options = options;
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: parseSizeField
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool parseSizeField(const string &field, long long *size, StegoOptions *options)
+**              const string &field -- Size of the secret, then any options after a semicolon
+**              long long *size -- Set to the size
+**              StegoOptions *options -- Set to the options
+**
+**
+** Returns:
+**			bool -- False if the size is not a positive number or an option is unknown
+**********************************************************************/
+static bool parseSizeField(const string &field, long long *size, StegoOptions *options)
+{
+    //any options follow the size, and one we do not know means we can not find the data
+    size_t split = field.find(';');
+    if (!stegoParseOptions((split == string::npos) ? "" : field.substr(split + 1), options))
+    {
+        return false;
+    }
+
+    //try converting what we found into a file size, if it fails we know there is no secret
+    try
+    {
+        *size = stoll(field.substr(0, split));
+    }
+    catch (const std::exception& e)
+    {
+        return false;
+    }
+
+    return *size > 0;
+}
+
+
+
+/*****************************************************************
+** Function: embedChunk
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long embedChunk(PixelBuffer *carrier, const BitMask *bitMask,
+**                               const PixelSelection *selection, int matrixBits, long long slot,
+**                               const char *bytes, long length, RowRange *rows, MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              int matrixBits -- k of the matrix embedding, 0 for none
+**              long long slot -- First data slot to fill
+**              const char *bytes -- Chunk of the secret
+**              long length -- Number of bytes
+**              RowRange *rows -- Widened to the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			long long -- Number of slots taken
+**
+** Notes:
+** For matrix embedding the slots the chunk will take are read out as
+** they are, the blocks are changed to carry the chunk and the slots
+** are written back.
+**********************************************************************/
+static long long embedChunk(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                            int matrixBits, long long slot, const char *bytes, long length, RowRange *rows,
+                            MatchingRandom *random)
+{
+    if (matrixBits == 0)
+    {
+        return embedSlots(carrier, bitMask, selection, slot, bytes, length, rows, random);
+    }
+
+    long numBlocks = (length * 8 + matrixBits - 1) / matrixBits;
+    vector<char> cover((size_t) ((numBlocks << matrixBits) / 8));
+
+    retrieveSlots(carrier, bitMask, selection, slot, cover.data(), (long) cover.size());
+    matrixEncode((unsigned char *) cover.data(), (const unsigned char *) bytes, length, matrixBits);
+
+    return embedSlots(carrier, bitMask, selection, slot, cover.data(), (long) cover.size(), rows, random);
+}
+
+
+
+/*****************************************************************
+** Function: retrieveStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void retrieveStream(const PixelBuffer *carrier, const BitMask *bitMask,
+**                              const PixelSelection *selection, int matrixBits, long long slot,
+**                              long long position, char *bytes, long length)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const PixelSelection *selection -- Pixels that hold the data
+**              int matrixBits -- k of the matrix embedding, 0 for none
+**              long long slot -- Data slot the embedded bytes start at
+**              long long position -- First embedded byte to retrieve
+**              char *bytes -- Receives the bytes
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Every k bytes of matrix embedded data fill 8 blocks of 2^k slots,
+** so a position that is a multiple of k starts a block. Others are
+** retrieved from the block before and the extra bytes dropped.
+**********************************************************************/
+static void retrieveStream(const PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                           int matrixBits, long long slot, long long position, char *bytes, long length)
+{
+    if (matrixBits == 0)
+    {
+        retrieveChunk(carrier, bitMask, selection, 0, slot + position * 8, bytes, length);
+        return;
+    }
+
+    long long first = position / matrixBits;
+    long skip = (long) (position - first * matrixBits);
+    slot += first * (8LL << matrixBits);
+    if (skip == 0)
+    {
+        retrieveChunk(carrier, bitMask, selection, matrixBits, slot, bytes, length);
+        return;
+    }
+
+    vector<char> buffer(skip + length);
+    retrieveChunk(carrier, bitMask, selection, matrixBits, slot, buffer.data(), skip + length);
+    memcpy(bytes, buffer.data() + skip, length);
+}
+
+
+
+/*****************************************************************
+** Function: retrieveChunk
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long retrieveChunk(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                  const PixelSelection *selection, int matrixBits, long long slot,
+**                                  char *bytes, long length)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const PixelSelection *selection -- Pixels that hold the data
+**              int matrixBits -- k of the matrix embedding, 0 for none
+**              long long slot -- First data slot to read
+**              char *bytes -- Receives the chunk of the secret
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			long long -- Number of slots read
+**********************************************************************/
+static long long retrieveChunk(const PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                               int matrixBits, long long slot, char *bytes, long length)
+{
+    if (matrixBits == 0)
+    {
+        return retrieveSlots(carrier, bitMask, selection, slot, bytes, length);
+    }
+
+    long numBlocks = (length * 8 + matrixBits - 1) / matrixBits;
+    vector<char> cover((size_t) ((numBlocks << matrixBits) / 8));
+
+    long long numSlots = retrieveSlots(carrier, bitMask, selection, slot, cover.data(), (long) cover.size());
+    matrixDecode((const unsigned char *) cover.data(), (unsigned char *) bytes, length, matrixBits);
+
+    return numSlots;
+}
+
+
+
+/*****************************************************************
+** Function: embedSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long embedSlots(PixelBuffer *carrier, const BitMask *bitMask,
+**                               const PixelSelection *selection, long long slot,
+**                               const char *bytes, long length, RowRange *rows, MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              long long slot -- First data slot to fill
+**              const char *bytes -- Bits to write, one per slot
+**              long length -- Number of bytes
+**              RowRange *rows -- Widened to the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			long long -- Number of slots filled
+**********************************************************************/
+static long long embedSlots(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                            long long slot, const char *bytes, long length, RowRange *rows, MatchingRandom *random)
+{
+    if (selection->threshold == 0)
+    {
+        return embedBytes(carrier, bitMask, slot, bytes, length, rows, random);
+    }
+
+    return embedSelected(carrier, bitMask, selection, slot, bytes, length, rows, random);
+}
+
+
+
+/*****************************************************************
+** Function: retrieveSlots
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long retrieveSlots(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                  const PixelSelection *selection, long long slot,
+**                                  char *bytes, long length)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions to read
+**              const PixelSelection *selection -- Pixels that hold the data
+**              long long slot -- First data slot to read
+**              char *bytes -- Receives the bits, one per slot
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			long long -- Number of slots read
+**********************************************************************/
+static long long retrieveSlots(const PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                               long long slot, char *bytes, long length)
+{
+    if (selection->threshold == 0)
+    {
+        return retrieveBytes(carrier, bitMask, slot, bytes, length);
+    }
+
+    return retrieveSelected(carrier, bitMask, selection, slot, bytes, length);
+}
+
+
+
+/*****************************************************************
+** Function: embedBytes
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Can embed by LSB matching
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long embedBytes(PixelBuffer *carrier, const BitMask *bitMask, long long slot,
+**                               const char *bytes, long length, RowRange *rows, MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              long long slot -- First slot of the carrier to fill
+**              const char *bytes -- Data to embed
+**              long length -- Number of bytes to embed
+**              RowRange *rows -- Widened to take in the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			long long -- Number of slots filled
+**
+** Notes:
+** Walks the scanlines from the one holding the slot until all the
+** bytes are embedded, and remembers which rows were written.
+**********************************************************************/
+static long long embedBytes(PixelBuffer *carrier, const BitMask *bitMask, long long slot,
+                            const char *bytes, long length, RowRange *rows, MatchingRandom *random)
+{
+    long long slotsPerLine = (long long) carrier->width * channelsInFormat(carrier->format) * bitMask->numBits;
+    long numBits = length * 8;
+    long done = 0;
+
+    while (done < numBits)
+    {
+        int row = (int) (slot / slotsPerLine);
+        if (row >= carrier->height)
+        {
+            break;
+        }
+
+        done += embedBitsInScanline(carrier->data + row * carrier->stride, carrier->width, carrier->format, bitMask,
+                                    (long) (slot % slotsPerLine), (const unsigned char *) bytes, done, numBits - done,
+                                    random);
+        slot = (long long) row * slotsPerLine + slotsPerLine;
+
+        //remember which rows were touched so the display can update only those
+        if (rows->first == -1 || row < rows->first)
+        {
+            rows->first = row;
+        }
+        if (row > rows->last)
+        {
+            rows->last = row;
+        }
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveBytes
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long retrieveBytes(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                  long long slot, char *bytes, long length)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              long long slot -- First slot to read
+**              char *bytes -- Buffer for the data
+**              long length -- Number of bytes to read
+**
+**
+** Returns:
+**			long long -- Number of slots read
+**********************************************************************/
+static long long retrieveBytes(const PixelBuffer *carrier, const BitMask *bitMask,
+                               long long slot, char *bytes, long length)
+{
+    long long slotsPerLine = (long long) carrier->width * channelsInFormat(carrier->format) * bitMask->numBits;
+    long numBits = length * 8;
+    long done = 0;
+
+    while (done < numBits)
+    {
+        int row = (int) (slot / slotsPerLine);
+        if (row >= carrier->height)
+        {
+            break;
+        }
+
+        done += retrieveBitsFromScanline(carrier->data + row * carrier->stride, carrier->width, carrier->format, bitMask,
+                                         (long) (slot % slotsPerLine), (unsigned char *) bytes, done, numBits - done);
+        slot = (long long) row * slotsPerLine + slotsPerLine;
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveField
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool retrieveField(const PixelBuffer *carrier, const BitMask *bitMask,
+**                             long long *slot, string *field, size_t maxLength)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              long long *slot -- Slot to start at, moved past the field
+**              string *field -- Receives the text of the field
+**              size_t maxLength -- Longest the field can be
+**
+**
+** Returns:
+**			bool -- False if no delimeter was found in time
+**
+** Notes:
+** Reads a null terminated header field one byte at a time.
+**********************************************************************/
+static bool retrieveField(const PixelBuffer *carrier, const BitMask *bitMask,
+                          long long *slot, string *field, size_t maxLength)
+{
+    long long capacity = stegoCapacity(carrier, bitMask, NULL);
+
+    while (field->length() <= maxLength && *slot + NUM_BITS <= capacity)
+    {
+        char character;
+        *slot += retrieveBytes(carrier, bitMask, *slot, &character, 1);
+
+        //look for our delimeter
+        if (character == '\0')
+        {
+            return true;
+        }
+
+        *field += character;
+    }
+
+    return false;
+}
+
+
+
+/*****************************************************************
+** Function: scoreBitMask
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Accepts options after the size
+** October 19th, 2026 - Accepts a size padded with leading zeros
+** October 19th, 2026 - Parses the options and checks the fit the way stegoReadHeader
+**                      does, and rates the name
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool scoreBitMask(const unsigned short *samples, long numSamples,
+**                            long long totalSamples, unsigned int mask, MaskScore *score)
+**              const unsigned short *samples -- First channel values of the carrier
+**              long numSamples -- Number of channel values given
+**              long long totalSamples -- Number of channel values in the whole carrier
+**              unsigned int mask -- Bit positions to try
+**              MaskScore *score -- Set to how believable the header is
+**
+**
+** Returns:
+**			bool -- False if the mask does not decode to a header
+**
+** Notes:
+** Decodes the header a byte at a time and gives up at the first byte
+** that can not belong to it, so most masks are ruled out after a single
+** byte. The file name may not hold control characters, path separators
+** or bytes that are not UTF-8, and the size must be written the way
+** embedSecret writes it: digits that are not all zero, padded with
+** leading zeros only by an append, then any options after a semicolon
+** that stegoParseOptions takes. The secret those options spread has to
+** fit behind the header.
+**********************************************************************/
+static bool scoreBitMask(const unsigned short *samples, long numSamples, long long totalSamples,
+                         unsigned int mask, MaskScore *score)
+{
+    int positions[MAX_NUM_BITS];
+    int numBits = 0;
+    for (int pos = MAX_NUM_BITS - 1; pos >= 0; pos--)
+    {
+        if ((mask >> pos) & 1)
+        {
+            positions[numBits++] = pos;
+        }
+    }
+
+    long long capacity = totalSamples * numBits;
+    int nameLength = 0;
+    int sizeLength = 0;
+    int continuations = 0;
+    long long fileSize = 0;
+    string options;
+    bool inName = true;
+    bool inOptions = false;
+    unsigned int character = 0;
+    int numCharBits = 0;
+
+    score->mask = mask;
+    score->plainName = 1;
+    score->oddCharacters = 0;
+
+    for (long i = 0; i < numSamples; i++)
+    {
+        for (int b = 0; b < numBits; b++)
+        {
+            //bits are stored flipped
+            character = (character << 1) | (((samples[i] >> positions[b]) & 1) ^ 1);
+            if (++numCharBits < NUM_BITS)
+            {
+                continue;
+            }
+
+            if (inName)
+            {
+                if (character == '\0')
+                {
+                    if (nameLength == 0 || continuations > 0)
+                    {
+                        return false;
+                    }
+                    inName = false;
+                }
+                else if (character < ' ' || character == 0x7F || character == '/' || character == '\\'
+                         || ++nameLength > MAX_NAME_LENGTH)
+                {
+                    return false;
+                }
+                else if (character >= 0x80)
+                {
+                    //a continuation byte has to follow a lead byte, and a lead byte has to be one UTF-8 uses
+                    score->plainName = 0;
+                    if (character < 0xC0)
+                    {
+                        if (continuations-- == 0)
+                        {
+                            return false;
+                        }
+                    }
+                    else if (continuations > 0 || character < 0xC2 || character > 0xF4)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        continuations = (character >= 0xF0) ? 3 : (character >= 0xE0) ? 2 : 1;
+                    }
+                }
+                else if (continuations > 0)
+                {
+                    return false;
+                }
+                else if (!isalnum(character) && character != ' ' && character != '.' && character != '_'
+                         && character != '-' && character != '(' && character != ')')
+                {
+                    score->oddCharacters++;
+                }
+            }
+            else if (character == '\0')
+            {
+                //the options have to be ones we know, and the whole secret has to fit in the carrier
+                StegoOptions parsed;
+                if (fileSize == 0 || options == ";" || !stegoParseOptions(inOptions ? options.substr(1) : "", &parsed))
+                {
+                    return false;
+                }
+
+                score->length = nameLength + sizeLength + (int) options.length() + 2;
+                long long dataSlot = (parsed.fecParity > 0) ? FEC_HEADER_BYTES * 8 : (long long) score->length * 8;
+                return dataSlot + dataSlots(&parsed, fileSize) <= capacity;
+            }
+            else if (inOptions)
+            {
+                options += (char) character;
+                if (options.length() > MAX_OPTIONS_LENGTH)
+                {
+                    return false;
+                }
+            }
+            else if (character == ';' && fileSize > 0)
+            {
+                //the semicolon counts towards the options
+                inOptions = true;
+                options = ";";
+            }
+            else if (character < '0' || character > '9' || ++sizeLength > MAX_SIZE_LENGTH - 1)
+            {
+                return false;
+            }
+            else
+            {
+                //a size of more bytes than the carrier has bits can not fit, and would overflow
+                fileSize = fileSize * 10 + (character - '0');
+                if (fileSize > capacity)
+                {
+                    return false;
+                }
+            }
+
+            character = 0;
+            numCharBits = 0;
+        }
+    }
+
+    return false;
+}
+
+
+
+/*****************************************************************
+** Function: scoreBitMasks
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Keeps every mask that decodes to a header
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void scoreBitMasks(const unsigned short *samples, long numSamples, long long totalSamples,
+**                             unsigned int numMasks, int first, int step, vector<MaskScore> *found)
+**              const unsigned short *samples -- First channel values of the carrier
+**              long numSamples -- Number of channel values given
+**              long long totalSamples -- Number of channel values in the whole carrier
+**              unsigned int numMasks -- Highest mask to try
+**              int first -- First mask this thread tries, less one
+**              int step -- Distance between the masks this thread tries
+**              vector<MaskScore> *found -- Receives the masks this thread found a header with
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on one detection thread over every step'th mask.
+**********************************************************************/
+static void scoreBitMasks(const unsigned short *samples, long numSamples, long long totalSamples,
+                          unsigned int numMasks, int first, int step, vector<MaskScore> *found)
+{
+    for (unsigned int mask = first + 1; mask <= numMasks; mask += step)
+    {
+        MaskScore score;
+        if (scoreBitMask(samples, numSamples, totalSamples, mask, &score))
+        {
+            found->push_back(score);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: betterMask
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool betterMask(const MaskScore &first, const MaskScore &second)
+**              const MaskScore &first -- Mask that may be better
+**              const MaskScore &second -- Mask to compare it with
+**
+**
+** Returns:
+**			bool -- True if the first mask's header is more believable
+**
+** Notes:
+** A name in printable ASCII beats one with UTF-8 in it, then the name
+** with fewer characters seldom found in file names wins, then the
+** longer header. The wrong masks that still decode to a header mostly
+** differ from the real one in a single position, which garbles a few
+** bits of the real name, so they rarely keep it looking like one.
+**********************************************************************/
+static bool betterMask(const MaskScore &first, const MaskScore &second)
+{
+    if (first.plainName != second.plainName)
+    {
+        return first.plainName > second.plainName;
+    }
+
+    if (first.oddCharacters != second.oddCharacters)
+    {
+        return first.oddCharacters < second.oddCharacters;
+    }
+
+    return first.length > second.length;
+}
+
+
+
+/*****************************************************************
+** Function: readsHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool readsHeader(const PixelBuffer *carrier, unsigned int mask)
+**              const PixelBuffer *carrier -- Pixels that may have a secret embedded
+**              unsigned int mask -- Low bit positions to read the header with
+**
+**
+** Returns:
+**			bool -- True if stegoReadHeader finds a header with them
+**********************************************************************/
+static bool readsHeader(const PixelBuffer *carrier, unsigned int mask)
+{
+    bool enabledBits[MAX_NUM_BITS] = {false};
+    for (int pos = 0; pos < NUM_BITS; pos++)
+    {
+        enabledBits[pos] = (mask >> pos) & 1;
+    }
+
+    BitMask bitMask;
+    SecretHeader header;
+    buildBitMask(&bitMask, enabledBits, depthInFormat(carrier->format));
+
+    return stegoReadHeader(carrier, &bitMask, &header) == STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: placeData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Counts the slots matrix embedded data takes
+** October 19th, 2026 - Counts the parity of error correction
+** October 19th, 2026 - Takes the slots to find and selects pixels only that far
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool placeData(const PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+**                         long long dataSlot, long long numSlots, PixelSelection *selection, long long *slot)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const StegoOptions *options -- How the data is spread, may be null
+**              long long dataSlot -- Slot right after the header
+**              long long numSlots -- Slots of the data that have to be found
+**              PixelSelection *selection -- Set to the pixels that hold the data
+**              long long *slot -- Set to the slot the data starts at
+**
+**
+** Returns:
+**			bool -- False if the data does not fit
+**
+** Notes:
+** Without the adaptive option the data follows the header in order.
+** Otherwise it starts at the first pixel the header left alone, and
+** slots count only the textured pixels from there on.
+**********************************************************************/
+static bool placeData(const PixelBuffer *carrier, const BitMask *bitMask, const StegoOptions *options,
+                      long long dataSlot, long long numSlots, PixelSelection *selection, long long *slot)
+{
+    selection->threshold = (options != NULL) ? options->adaptiveThreshold : 0;
+    if (selection->threshold == 0)
+    {
+        *slot = dataSlot;
+        return dataSlot + numSlots <= stegoCapacity(carrier, bitMask, NULL);
+    }
+
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    selectPixels(carrier, bitMask, selection->threshold, (dataSlot + slotsPerPixel - 1) / slotsPerPixel,
+                 (numSlots + slotsPerPixel - 1) / slotsPerPixel, selection);
+
+    *slot = 0;
+    return dataSlot <= stegoCapacity(carrier, bitMask, NULL)
+           && numSlots <= selection->before[carrier->height] * slotsPerPixel;
+}
+
+
+
+/*****************************************************************
+** Function: selectPixels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Can stop once enough pixels are selected
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void selectPixels(const PixelBuffer *carrier, const BitMask *bitMask, int threshold,
+**                            long long firstPixel, long long numPixels, PixelSelection *selection)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              int threshold -- Lowest texture of a pixel that is selected
+**              long long firstPixel -- Pixels before this one are never selected
+**              long long numPixels -- Pixels that have to be selected, -1 for all there are
+**              PixelSelection *selection -- Set to the selected pixels
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Builds the cost map a band of rows per core. When only so many
+** pixels are needed, SELECT_ROUND_BANDS bands per core are marked at
+** a time until they are found, and the rows after are left unmarked
+** with the count they reached.
+**********************************************************************/
+static void selectPixels(const PixelBuffer *carrier, const BitMask *bitMask, int threshold,
+                         long long firstPixel, long long numPixels, PixelSelection *selection)
+{
+    TraceSpan span;
+    traceBegin(&span, STAGE_COST_MAP);
+
+    int height = carrier->height;
+    selection->threshold = threshold;
+    selection->wordsPerRow = (carrier->width + 63) / 64;
+    selection->marked.assign((size_t) selection->wordsPerRow * height, 0);
+    selection->before.assign((size_t) height + 1, 0);
+
+    int numThreads = (int) thread::hardware_concurrency();
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+    int roundRows = (numPixels < 0) ? height : numThreads * SELECT_ROUND_BANDS * SELECT_BAND_ROWS;
+
+    int row = 0;
+    while (row < height)
+    {
+        int roundEnd = (height - row < roundRows) ? height : row + roundRows;
+
+        //small rounds are not worth more than one band
+        int roundThreads = (roundEnd - row + SELECT_BAND_ROWS - 1) / SELECT_BAND_ROWS;
+        if (roundThreads > numThreads)
+        {
+            roundThreads = numThreads;
+        }
+
+        int bandRows = (roundEnd - row + roundThreads - 1) / roundThreads;
+        vector<thread> workers;
+        for (int first = row; first < roundEnd; first += bandRows)
+        {
+            int last = (first + bandRows < roundEnd) ? first + bandRows : roundEnd;
+            workers.push_back(thread(markRows, carrier, bitMask, threshold, firstPixel, first, last, selection));
+        }
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+
+        //each row holds its own count until now
+        for (; row < roundEnd; row++)
+        {
+            selection->before[row + 1] += selection->before[row];
+        }
+
+        if (numPixels >= 0 && selection->before[row] >= numPixels)
+        {
+            break;
+        }
+    }
+
+    for (int rest = row; rest < height; rest++)
+    {
+        selection->before[rest + 1] = selection->before[row];
+    }
+
+    traceEnd(&span, (long long) carrier->width * row, 0);
+}
+
+
+
+/*****************************************************************
+** Function: markRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void markRows(const PixelBuffer *carrier, const BitMask *bitMask, int threshold,
+**                        long long firstPixel, int firstRow, int lastRow, PixelSelection *selection)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              int threshold -- Lowest texture of a pixel that is selected
+**              long long firstPixel -- Pixels before this one are never selected
+**              int firstRow -- First row of the band
+**              int lastRow -- Row after the band
+**              PixelSelection *selection -- Receives the marks and the count of each row
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own. Keeps the texture of three rows and
+** reads one new row for each row it marks.
+**********************************************************************/
+static void markRows(const PixelBuffer *carrier, const BitMask *bitMask, int threshold,
+                     long long firstPixel, int firstRow, int lastRow, PixelSelection *selection)
+{
+    int width = carrier->width;
+    vector<unsigned short> texture((size_t) width * 3);
+    vector<unsigned char> marks(width);
+
+    unsigned short *above = texture.data();
+    unsigned short *line = above + width;
+    unsigned short *below = line + width;
+
+    //rows past the edges repeat the edge rows
+    int previous = (firstRow > 0) ? firstRow - 1 : 0;
+    readTextureLine(carrier->data + previous * carrier->stride, width, carrier->format, bitMask, above);
+    readTextureLine(carrier->data + firstRow * carrier->stride, width, carrier->format, bitMask, line);
+
+    for (int row = firstRow; row < lastRow; row++)
+    {
+        int next = (row + 1 < carrier->height) ? row + 1 : row;
+        readTextureLine(carrier->data + next * carrier->stride, width, carrier->format, bitMask, below);
+        markTexturedPixels(above, line, below, width, threshold, marks.data());
+
+        unsigned long long *words = selection->marked.data() + (size_t) row * selection->wordsPerRow;
+        long long start = (long long) row * width;
+        long long count = 0;
+        for (int x = 0; x < width; x++)
+        {
+            if (marks[x] && start + x >= firstPixel)
+            {
+                words[x >> 6] |= 1ULL << (x & 63);
+                count++;
+            }
+        }
+        selection->before[row + 1] = count;
+
+        unsigned short *oldest = above;
+        above = line;
+        line = below;
+        below = oldest;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: embedSelected
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long embedSelected(PixelBuffer *carrier, const BitMask *bitMask,
+**                                  const PixelSelection *selection, long long slot,
+**                                  const char *bytes, long length, RowRange *rows,
+**                                  MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              long long slot -- Slot among the selected pixels to start at
+**              const char *bytes -- Bytes to embed
+**              long length -- Number of bytes
+**              RowRange *rows -- Widened to the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			long long -- Number of slots written
+**
+** Notes:
+** The selected pixels of each row are packed together, embedded as a
+** scanline of their own and put back.
+**********************************************************************/
+static long long embedSelected(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                               long long slot, const char *bytes, long length, RowRange *rows,
+                               MatchingRandom *random)
+{
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    int pixelSize = pixelSizeInFormat(carrier->format);
+    vector<unsigned char> packed((size_t) carrier->width * pixelSize);
+    const vector<long long> &before = selection->before;
+    long numBits = length * 8;
+    long done = 0;
+
+    while (done < numBits)
+    {
+        long long pixel = slot / slotsPerPixel;
+        if (pixel >= before[carrier->height])
+        {
+            break;
+        }
+
+        int row = (int) (upper_bound(before.begin(), before.end(), pixel) - before.begin()) - 1;
+        const unsigned long long *marked = selection->marked.data() + (size_t) row * selection->wordsPerRow;
+        unsigned char *line = carrier->data + row * carrier->stride;
+
+        int count = gatherPixels(line, marked, carrier->width, pixelSize, packed.data());
+        done += embedBitsInScanline(packed.data(), count, carrier->format, bitMask, (long) (slot - before[row] * slotsPerPixel),
+                                    (const unsigned char *) bytes, done, numBits - done, random);
+        scatterPixels(line, marked, carrier->width, pixelSize, packed.data());
+        slot = before[row + 1] * slotsPerPixel;
+
+        if (rows->first == -1 || row < rows->first)
+        {
+            rows->first = row;
+        }
+        if (row > rows->last)
+        {
+            rows->last = row;
+        }
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveSelected
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long retrieveSelected(const PixelBuffer *carrier, const BitMask *bitMask,
+**                                     const PixelSelection *selection, long long slot,
+**                                     char *bytes, long length)
+**              const PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              long long slot -- Slot among the selected pixels to start at
+**              char *bytes -- Receives the bytes
+**              long length -- Number of bytes
+**
+**
+** Returns:
+**			long long -- Number of slots read
+**********************************************************************/
+static long long retrieveSelected(const PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                                  long long slot, char *bytes, long length)
+{
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    int pixelSize = pixelSizeInFormat(carrier->format);
+    vector<unsigned char> packed((size_t) carrier->width * pixelSize);
+    const vector<long long> &before = selection->before;
+    long numBits = length * 8;
+    long done = 0;
+
+    while (done < numBits)
+    {
+        long long pixel = slot / slotsPerPixel;
+        if (pixel >= before[carrier->height])
+        {
+            break;
+        }
+
+        int row = (int) (upper_bound(before.begin(), before.end(), pixel) - before.begin()) - 1;
+        const unsigned long long *marked = selection->marked.data() + (size_t) row * selection->wordsPerRow;
+
+        int count = gatherPixels(carrier->data + row * carrier->stride, marked, carrier->width, pixelSize, packed.data());
+        done += retrieveBitsFromScanline(packed.data(), count, carrier->format, bitMask, (long) (slot - before[row] * slotsPerPixel),
+                                         (unsigned char *) bytes, done, numBits - done);
+        slot = before[row + 1] * slotsPerPixel;
+    }
+
+    return done;
+}
+
+
+
+/*****************************************************************
+** Function: gatherPixels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int gatherPixels(const unsigned char *line, const unsigned long long *marked,
+**                           int width, int pixelSize, unsigned char *packed)
+**              const unsigned char *line -- Scanline
+**              const unsigned long long *marked -- Selected pixels of the scanline
+**              int width -- Number of pixels in the scanline
+**              int pixelSize -- Bytes per pixel
+**              unsigned char *packed -- Receives the selected pixels, one after the other
+**
+**
+** Returns:
+**			int -- Number of pixels packed
+**********************************************************************/
+static int gatherPixels(const unsigned char *line, const unsigned long long *marked,
+                        int width, int pixelSize, unsigned char *packed)
+{
+    int count = 0;
+
+    for (int x = 0; x < width; x += 64)
+    {
+        unsigned long long word = marked[x >> 6];
+        for (int bit = 0; word != 0; bit++, word >>= 1)
+        {
+            if (word & 1)
+            {
+                memcpy(packed + (long) count * pixelSize, line + (long) (x + bit) * pixelSize, pixelSize);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+
+/*****************************************************************
+** Function: scatterPixels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void scatterPixels(unsigned char *line, const unsigned long long *marked,
+**                             int width, int pixelSize, const unsigned char *packed)
+**              unsigned char *line -- Scanline
+**              const unsigned long long *marked -- Selected pixels of the scanline
+**              int width -- Number of pixels in the scanline
+**              int pixelSize -- Bytes per pixel
+**              const unsigned char *packed -- Pixels packed by gatherPixels
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+static void scatterPixels(unsigned char *line, const unsigned long long *marked,
+                          int width, int pixelSize, const unsigned char *packed)
+{
+    int count = 0;
+
+    for (int x = 0; x < width; x += 64)
+    {
+        unsigned long long word = marked[x >> 6];
+        for (int bit = 0; word != 0; bit++, word >>= 1)
+        {
+            if (word & 1)
+            {
+                memcpy(line + (long) (x + bit) * pixelSize, packed + (long) count * pixelSize, pixelSize);
+                count++;
+            }
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: embedData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int embedData(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+**                        const StegoOptions *options, long long slot, long long size,
+**                        StegoReader reader, void *context, RowRange *rows, MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              const StegoOptions *options -- How the data is spread, may be null
+**              long long slot -- First data slot to fill
+**              long long size -- Bytes to embed
+**              StegoReader reader -- Called for the secret
+**              void *context -- Passed to the reader
+**              RowRange *rows -- Widened to the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			int -- STEGO_OK, or STEGO_READ_FAILED if the reader ran out
+**
+** Notes:
+** Embeds the raw data a chunk at a time as the reader hands it over.
+**********************************************************************/
+static int embedData(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                     const StegoOptions *options, long long slot, long long size,
+                     StegoReader reader, void *context, RowRange *rows, MatchingRandom *random)
+{
+    int matrixBits = (options != NULL) ? options->matrixBits : 0;
+    long chunk = chunkLength(options);
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    vector<char> buffer(READ_CHUNK_SIZE);
+    long long remaining = size;
+    TraceSpan span;
+
+    while (remaining > 0)
+    {
+        traceBegin(&span, STAGE_SECRET_READ);
+        long numRead = readChunk(reader, context, buffer.data(), (remaining < chunk) ? (long) remaining : chunk);
+        traceEnd(&span, 0, (numRead > 0) ? numRead : 0);
+        if (numRead <= 0)
+        {
+            return STEGO_READ_FAILED;
+        }
+
+        traceBegin(&span, STAGE_EMBED);
+        long long numSlots = embedChunk(carrier, bitMask, selection, matrixBits, slot, buffer.data(), numRead,
+                                        rows, random);
+        traceEnd(&span, numSlots / slotsPerPixel, numRead);
+
+        slot += numSlots;
+        remaining -= numRead;
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: embedFecData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Can write bytes already embedded again ahead of the codewords
+** October 19th, 2026 - Embeds the codewords of a short last batch before giving up
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int embedFecData(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+**                           const StegoOptions *options, long long slot, const char *lead, long leadLength,
+**                           long long size, StegoReader reader, void *context, RowRange *rows,
+**                           MatchingRandom *random)
+**              PixelBuffer *carrier -- Carrier pixels
+**              const BitMask *bitMask -- Positions that are available
+**              const PixelSelection *selection -- Pixels that hold the data
+**              const StegoOptions *options -- How the data is spread, with error correction
+**              long long slot -- First data slot to fill
+**              const char *lead -- Encoded bytes to embed before the codewords, may be null
+**              long leadLength -- Number of them, less than a block
+**              long long size -- Size of the secret
+**              StegoReader reader -- Called for the secret
+**              void *context -- Passed to the reader
+**              RowRange *rows -- Widened to the rows written
+**              MatchingRandom *random -- Generator for LSB matching, NULL to replace the bits
+**
+**
+** Returns:
+**			int -- STEGO_OK, or STEGO_READ_FAILED if the reader ran out
+**
+** Notes:
+** Reads FEC_BATCH_CHUNKS chunks worth of the secret at a time and
+** encodes them on all the cores, then embeds the codewords a chunk at
+** a time, the same as retrieveFecData takes them back out. Bytes in
+** front of the codewords that leave a batch short of a whole block
+** are held over to the front of the next batch. When the reader runs
+** out, what it did hand over is embedded before STEGO_READ_FAILED is
+** returned.
+**********************************************************************/
+static int embedFecData(PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                        const StegoOptions *options, long long slot, const char *lead, long leadLength,
+                        long long size, StegoReader reader, void *context, RowRange *rows, MatchingRandom *random)
+{
+    int parity = options->fecParity;
+    long chunk = chunkLength(options);
+    long unit = (options->matrixBits == 0) ? 1 : options->matrixBits;
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    vector<char> data((size_t) FEC_BATCH_CHUNKS * FEC_CHUNK_CODEWORDS * (RS_CODEWORD_LENGTH - parity));
+    vector<char> codewords((size_t) FEC_BATCH_CHUNKS * chunk + MAX_MATRIX_BITS);
+    long long remaining = size;
+    TraceSpan span;
+
+    long held = leadLength;
+    if (held > 0)
+    {
+        memcpy(codewords.data(), lead, held);
+    }
+
+    while (remaining > 0)
+    {
+        long wanted = (remaining < (long long) data.size()) ? (long) remaining : (long) data.size();
+
+        traceBegin(&span, STAGE_SECRET_READ);
+        long numRead = readChunk(reader, context, data.data(), wanted);
+        traceEnd(&span, 0, numRead);
+
+        //a reader that runs out ends the data with this batch, which is still embedded
+        //whole for a secret whose size is only known at its end (see stegoEmbedUnsized)
+        bool ended = (numRead < wanted);
+
+        traceBegin(&span, STAGE_FEC_ENCODE);
+        if (numRead > 0)
+        {
+            fecEncode((const unsigned char *) data.data(), numRead, parity,
+                      (unsigned char *) codewords.data() + held);
+        }
+        long encodedLength = held + (long) fecEncodedSize(numRead, parity);
+        traceEnd(&span, 0, numRead);
+
+        //only the last batch may end part way through a block
+        remaining -= numRead;
+        long embedLength = (remaining > 0 && !ended) ? encodedLength - encodedLength % unit : encodedLength;
+        for (long done = 0; done < embedLength; done += chunk)
+        {
+            long length = (embedLength - done < chunk) ? embedLength - done : chunk;
+
+            traceBegin(&span, STAGE_EMBED);
+            long long numSlots = embedChunk(carrier, bitMask, selection, options->matrixBits, slot,
+                                            codewords.data() + done, length, rows, random);
+            traceEnd(&span, numSlots / slotsPerPixel, length);
+
+            slot += numSlots;
+        }
+
+        held = encodedLength - embedLength;
+        memmove(codewords.data(), codewords.data() + embedLength, held);
+
+        if (ended)
+        {
+            return STEGO_READ_FAILED;
+        }
+    }
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: retrieveFecData
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int retrieveFecData(const PixelBuffer *carrier, const BitMask *bitMask,
+**                              const PixelSelection *selection, const SecretHeader *header,
+**                              long long slot, StegoWriter writer, void *context)
+**              const PixelBuffer *carrier -- Pixels that have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              const PixelSelection *selection -- Pixels that hold the data
+**              const SecretHeader *header -- Header of a secret with error correction
+**              long long slot -- First data slot to read
+**              StegoWriter writer -- Called for each batch of the secret
+**              void *context -- Passed to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_WRITE_FAILED if the writer stopped, or
+**                 STEGO_CORRUPT if a codeword was too damaged to put right
+**
+** Notes:
+** Retrieves FEC_BATCH_CHUNKS chunks of codewords at a time and
+** corrects them on all the cores before handing them on.
+**********************************************************************/
+static int retrieveFecData(const PixelBuffer *carrier, const BitMask *bitMask, const PixelSelection *selection,
+                           const SecretHeader *header, long long slot, StegoWriter writer, void *context)
+{
+    int parity = header->options.fecParity;
+    long chunk = chunkLength(&header->options);
+    long long slotsPerPixel = (long long) channelsInFormat(carrier->format) * bitMask->numBits;
+    vector<char> codewords((size_t) FEC_BATCH_CHUNKS * chunk);
+    vector<char> data((size_t) fecDataLength((long) codewords.size(), parity));
+    long long remaining = fecEncodedSize(header->size, parity);
+    TraceSpan span;
+
+    while (remaining > 0)
+    {
+        long encodedLength = (remaining < (long long) codewords.size()) ? (long) remaining : (long) codewords.size();
+        for (long done = 0; done < encodedLength; done += chunk)
+        {
+            long length = (encodedLength - done < chunk) ? encodedLength - done : chunk;
+
+            traceBegin(&span, STAGE_EXTRACT);
+            long long numSlots = retrieveChunk(carrier, bitMask, selection, header->options.matrixBits, slot,
+                                               codewords.data() + done, length);
+            traceEnd(&span, numSlots / slotsPerPixel, length);
+
+            slot += numSlots;
+        }
+
+        traceBegin(&span, STAGE_FEC_DECODE);
+        long corrected = fecDecode((const unsigned char *) codewords.data(), encodedLength, parity,
+                                   (unsigned char *) data.data());
+        long length = fecDataLength(encodedLength, parity);
+        traceEnd(&span, 0, length);
+
+        if (corrected < 0)
+        {
+            return STEGO_CORRUPT;
+        }
+
+        traceBegin(&span, STAGE_SECRET_WRITE);
+        bool written = writer(context, data.data(), length);
+        traceEnd(&span, 0, length);
+
+        if (!written)
+        {
+            return STEGO_WRITE_FAILED;
+        }
+        remaining -= encodedLength;
+    }
+
+    return STEGO_OK;
+}
@@ -0,0 +1,90 @@
+#ifndef STEGOCORE_H
+#define STEGOCORE_H
+
+#include <string>
+#include <vector>
+#include "imageManipulation.h"
+
+#define READ_CHUNK_SIZE 65536
+#define MAX_NAME_LENGTH 255
+#define MAX_SIZE_LENGTH 20
+#define MAX_OPTIONS_LENGTH 64
+#define DEFAULT_ADAPTIVE_THRESHOLD 96
+
+//results of the core functions
+#define STEGO_OK 0
+#define STEGO_ERROR -1          //bad arguments
+#define STEGO_TOO_BIG -2        //the secret does not fit in the carrier
+#define STEGO_NO_SECRET -3      //no believable header was found
+#define STEGO_READ_FAILED -4    //the reader ran out before the whole secret
+#define STEGO_WRITE_FAILED -5   //the writer refused the data
+#define STEGO_CORRUPT -6        //the data was too damaged to correct or failed its checksum
+
+//carrier pixels owned by the caller
+struct PixelBuffer
+{
+    unsigned char *data;        //first scanline
+    int width;
+    int height;
+    long stride;                //bytes from one scanline to the next
+    PixelFormat format;
+};
+
+//how the data of a secret is embedded, kept after the size in the header
+//where the retriever needs it
+struct StegoOptions
+{
+    int adaptiveThreshold;      //lowest texture of a pixel that holds data, 0 for every pixel
+    int matrixBits;             //k of the Hamming code the data is matrix embedded with, 0 for bit for bit
+    int matching;               //1 to embed by LSB matching, never kept in the header
+    int fecParity;              //Reed-Solomon parity bytes per 255 byte codeword, 0 for none
+    int archiveIndex;           //bytes of archive index at the front of the data, 0 for a single file
+    int archiveTail;            //bytes of archive index at the end of the data, for files appended later
+};
+
+//header of an embedded secret
+struct SecretHeader
+{
+    std::string name;
+    long long size;
+    long long dataSlot;         //slot the raw data starts at
+    StegoOptions options;
+};
+
+//rows written by an embed, -1 if none
+struct RowRange
+{
+    int first;
+    int last;
+};
+
+//fills the buffer with up to the given number of bytes of the secret, returns how many
+typedef long (*StegoReader)(void *, char *, long);
+
+//takes the given bytes of a retrieved secret, returns false to stop
+typedef bool (*StegoWriter)(void *, const char *, long);
+
+void stegoDefaultOptions(StegoOptions *);
+std::string stegoFormatOptions(const StegoOptions *);
+bool stegoParseOptions(const std::string &, StegoOptions *);
+long long stegoCapacity(const PixelBuffer *, const BitMask *, const StegoOptions *);
+long long stegoSlotsNeeded(const std::string &, long long, const StegoOptions *);
+int stegoEmbed(PixelBuffer *, const BitMask *, const StegoOptions *, const std::string &, const char *, long long, RowRange *);
+int stegoEmbedStream(PixelBuffer *, const BitMask *, const StegoOptions *, const std::string &, long long,
+                     StegoReader, void *, RowRange *);
+int stegoEmbedUnsized(PixelBuffer *, const BitMask *, const StegoOptions *, const std::string &, StegoReader, void *,
+                      long long *, RowRange *);
+int stegoAppend(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *, const char *, long long,
+                RowRange *);
+int stegoAppendStream(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *, long long, long long,
+                      StegoReader, void *, RowRange *);
+int stegoUpdate(PixelBuffer *, const BitMask *, const SecretHeader *, const StegoOptions *, const char *, long long,
+                long long *, RowRange *);
+int stegoReadHeader(const PixelBuffer *, const BitMask *, SecretHeader *);
+int stegoExtract(const PixelBuffer *, const BitMask *, std::string *, std::vector<char> *);
+int stegoExtractStream(const PixelBuffer *, const BitMask *, const SecretHeader *, StegoWriter, void *);
+int stegoExtractRange(const PixelBuffer *, const BitMask *, const SecretHeader *, long long, long long,
+                      StegoWriter, void *);
+int stegoDetectBitMask(const PixelBuffer *, bool *);
+
+#endif // STEGOCORE_H
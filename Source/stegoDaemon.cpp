@@ -0,0 +1,1836 @@
+/**********************************************************************
+**	SOURCE FILE:	stegoDaemon.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    StegoDaemon(QObject *parent = 0)
+**    ~StegoDaemon()
+**    bool listen(QString, int, int)
+**    void acceptConnection()
+**    void readRequests()
+**    void dropConnection()
+**    void sendResult(quint64, QByteArray, QByteArray, bool, qint64, qint64, QByteArray)
+**    void runJob(StegoDaemon *, DaemonJob)
+**    QByteArray embedJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray jpegEmbedJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray y4mEmbedJob(const DaemonJob &, bool *)
+**    QByteArray appendJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray updateJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray extractJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray jpegExtractJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray y4mExtractJob(const DaemonJob &, bool *)
+**    QByteArray probeJob(const DaemonJob &, JobBuffers *, bool *)
+**    QByteArray jpegProbeJob(const DaemonJob &, bool *)
+**    QByteArray y4mProbeJob(const DaemonJob &, bool *)
+**    QByteArray listJob(const DaemonJob &, JobBuffers *, bool *)
+**    bool parseBits(const QString &, bool *, bool *)
+**    bool parsePlanes(const QString &, int *)
+**    void reply(quint64, const QByteArray &)
+**    QByteArray statistics() const
+**    long readJobFile(void *, char *, long)
+**    bool writeJobFile(void *, const char *, long)
+**    QFileInfoList folderFiles(const QString &)
+**    QByteArray readSecretFiles(const QString &, JobBuffers *, vector<ArchiveFile> *)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Runs the program as a resident process that takes jobs over a local
+** socket (a Unix domain socket on Linux and macOS), so a busy caller
+** does not pay for starting a process and Qt on every image.
+**
+** Requests and replies are single lines of tab separated fields:
+**
+**   <id> embed <carrier> <secret> <output> <bits> [<options>]
+**   <id> append <carrier> <secret> <output> <bits|auto> [matching=1]
+**   <id> update <carrier> <secret> <output> <bits|auto> [matching=1]
+**   <id> extract <carrier> <output folder> <bits|auto> [<file>]
+**   <id> probe <carrier> <bits|auto>
+**   <id> list <carrier> <bits|auto>
+**   <id> stats
+**   <id> trace <file>
+**
+** where <bits> lists the bit positions, e.g. "0,1,2", and <options>
+** are the embedding options, e.g. "adaptive=96;matrix=3" or
+** "matching=1;matrix=3" or "fec=32". Each reply
+** starts with the id of its request, then "ok" or "error", the result,
+** and the latency from receiving the request, the time the job ran,
+** the number of jobs still queued and the time of each stage of the
+** job. The trace command writes every stage timed so far to a file
+** as Chrome trace events.
+**
+** A folder given as the secret has the files in it embedded as an
+** archive (see stegoArchive). List replies with the name and size of
+** each file of a secret, reading only its index, and extract writes
+** every file of an archive, or only the one named, replying with the
+** path and size of each. Append adds a file to the end of the secret
+** already in a carrier, or a folder's files to its archive, embedding
+** only the new bytes with the options the secret was embedded with.
+** Update replaces the secret in a carrier with a new version of it,
+** embedding only the blocks that changed, and replies with how many
+** bytes that was.
+**
+** A JPEG carrier embedded into an output named .jpg or .jpeg is
+** embedded in its DCT coefficients (see jpegStego) instead of its
+** pixels, and extract and probe read JPEG carriers the same way. The
+** bit positions do not apply to those, and no options can be given.
+**
+** A Y4M video carrier is streamed frame by frame (see y4mStego), with
+** the secret read from and written to its file as it goes. In place
+** of the options, embed, extract and probe of a Y4M carrier take the
+** planes to use, "luma" (the default), "chroma" or "all", after the
+** bit positions. Only positions 0 to 7 are used, and "auto" can not
+** be given.
+**
+** Jobs run on a pool of worker threads that are never retired. Each
+** job reserves the memory it needs against the memory budget and
+** works in pooled image and secret buffers, so the daemon's memory
+** stays bounded however long it runs. Carriers are decoded through
+** the carrier cache, so jobs on the same carrier decode it once.
+*************************************************************************/
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QtConcurrent/QtConcurrentRun>
+#include <vector>
+#include "stegoDaemon.h"
+#include "imageStego.h"
+#include "jpegStego.h"
+#include "y4mStego.h"
+#include "stegoTrace.h"
+#include "bufferPool.h"
+#include "carrierCache.h"
+
+using namespace std;
+
+static long readJobFile(void *, char *, long);
+static bool writeJobFile(void *, const char *, long);
+static QFileInfoList folderFiles(const QString &);
+static QByteArray readSecretFiles(const QString &, JobBuffers *, vector<ArchiveFile> *);
+
+
+/*****************************************************************
+** Function: StegoDaemon
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          StegoDaemon(QObject *parent)
+**            QObject *parent -- Owner of the daemon
+**
+** Returns: N/A (Constructor)
+**********************************************************************/
+StegoDaemon::StegoDaemon(QObject *parent) : QObject(parent)
+{
+    nextConnection = 0;
+    maxPending = DEFAULT_MAX_PENDING;
+    jobsDone = 0;
+    jobsFailed = 0;
+    totalLatency = 0;
+    maxLatency = 0;
+
+    //workers stay alive for as long as the daemon does
+    pool.setExpiryTimeout(-1);
+    clock.start();
+
+    connect(&server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+    connect(this, SIGNAL(jobFinished(quint64, QByteArray, QByteArray, bool, qint64, qint64, QByteArray)),
+            this, SLOT(sendResult(quint64, QByteArray, QByteArray, bool, qint64, qint64, QByteArray)), Qt::QueuedConnection);
+}
+
+
+
+/*****************************************************************
+** Function: ~StegoDaemon
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          ~StegoDaemon()
+**
+** Returns: N/A (Destructor)
+**
+** Notes:
+** Stops taking connections and lets the running jobs finish.
+**********************************************************************/
+StegoDaemon::~StegoDaemon()
+{
+    server.close();
+    pool.clear();
+    pool.waitForDone();
+}
+
+
+
+/*****************************************************************
+** Function: listen
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool listen(QString name, int numThreads, int pendingLimit)
+**            QString name -- Name (or path) of the socket
+**            int numThreads -- Most jobs that run at once
+**            int pendingLimit -- Most jobs that can wait, further ones are turned away
+**
+** Returns:
+**          bool -- False if the socket could not be opened
+**
+** Notes:
+** A socket left behind by a daemon that did not shut down cleanly
+** is removed first.
+**********************************************************************/
+bool StegoDaemon::listen(QString name, int numThreads, int pendingLimit)
+{
+    if (numThreads > 0)
+    {
+        pool.setMaxThreadCount(numThreads);
+    }
+    if (pendingLimit > 0)
+    {
+        maxPending = pendingLimit;
+    }
+
+    QLocalServer::removeServer(name);
+    return server.listen(name);
+}
+
+
+
+/*****************************************************************
+** Function: acceptConnection
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void acceptConnection()
+**
+** Returns: void
+**
+** Notes:
+** Gives each new client a number, so the replies of its jobs can
+** find it again or be dropped if it has gone.
+**********************************************************************/
+void StegoDaemon::acceptConnection()
+{
+    while (server.hasPendingConnections())
+    {
+        QLocalSocket *socket = server.nextPendingConnection();
+        quint64 connection = nextConnection++;
+
+        socket->setProperty("connection", connection);
+        connections.insert(connection, socket);
+
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequests()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(dropConnection()));
+    }
+}
+
+
+
+/*****************************************************************
+** Function: readRequests
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Writes traces
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void readRequests()
+**
+** Returns: void
+**
+** Notes:
+** Queues every complete request line of a client on the pool.
+** Statistics and traces are answered straight away and jobs over the
+** pending limit are turned away as busy.
+**********************************************************************/
+void StegoDaemon::readRequests()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == 0)
+    {
+        return;
+    }
+
+    quint64 connection = socket->property("connection").toULongLong();
+
+    while (socket->canReadLine())
+    {
+        QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        QList<QByteArray> fields = line.split('\t');
+        if (fields.size() < 2)
+        {
+            reply(connection, fields[0] + "\terror\tbad request");
+            continue;
+        }
+
+        DaemonJob job;
+        job.connection = connection;
+        job.id = fields[0];
+        job.command = fields[1];
+        job.received = clock.nsecsElapsed();
+        for (int i = 2; i < fields.size(); i++)
+        {
+            job.args.append(QString::fromUtf8(fields[i]));
+        }
+
+        if (job.command == "stats")
+        {
+            reply(connection, job.id + "\tok\t" + statistics());
+        }
+        else if (job.command == "trace")
+        {
+            bool written = (job.args.size() == 1) && traceWriteChrome(job.args[0].toStdString());
+            reply(connection, job.id + (written ? "\tok\t" + job.args[0].toUtf8() : QByteArray("\terror\tcould not write trace")));
+        }
+        else if (job.command != "embed" && job.command != "extract" && job.command != "probe"
+                 && job.command != "list" && job.command != "append" && job.command != "update")
+        {
+            reply(connection, job.id + "\terror\tunknown command");
+        }
+        else if (pending.loadAcquire() >= maxPending)
+        {
+            reply(connection, job.id + "\terror\tbusy");
+        }
+        else
+        {
+            pending.ref();
+            QtConcurrent::run(&pool, runJob, this, job);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: dropConnection
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void dropConnection()
+**
+** Returns: void
+**
+** Notes:
+** Forgets a client that hung up. Its jobs still run, but their
+** replies are thrown away.
+**********************************************************************/
+void StegoDaemon::dropConnection()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == 0)
+    {
+        return;
+    }
+
+    connections.remove(socket->property("connection").toULongLong());
+    socket->deleteLater();
+}
+
+
+
+/*****************************************************************
+** Function: sendResult
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Reports the stage times
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void sendResult(quint64 connection, QByteArray id, QByteArray result,
+**                          bool ok, qint64 received, qint64 runTime, QByteArray stages)
+**            quint64 connection -- Client that sent the job
+**            QByteArray id -- Id the client gave the job
+**            QByteArray result -- Result or error message of the job
+**            bool ok -- True if the job succeeded
+**            qint64 received -- When the job was received, in nanoseconds
+**            qint64 runTime -- How long the job ran, in nanoseconds
+**            QByteArray stages -- Summary of the time each stage took
+**
+** Returns: void
+**
+** Notes:
+** Runs on the daemon's thread once a worker is done, so the counters
+** need no locking.
+**********************************************************************/
+void StegoDaemon::sendResult(quint64 connection, QByteArray id, QByteArray result,
+                             bool ok, qint64 received, qint64 runTime, QByteArray stages)
+{
+    int queued = pending.fetchAndAddOrdered(-1) - 1;
+    qint64 latency = clock.nsecsElapsed() - received;
+
+    if (ok)
+    {
+        jobsDone++;
+    }
+    else
+    {
+        jobsFailed++;
+    }
+    totalLatency += latency;
+    if (latency > maxLatency)
+    {
+        maxLatency = latency;
+    }
+
+    reply(connection, id + (ok ? "\tok\t" : "\terror\t") + result
+                      + "\tlatency_us=" + QByteArray::number(latency / 1000)
+                      + "\trun_us=" + QByteArray::number(runTime / 1000)
+                      + "\tqueue=" + QByteArray::number(queued)
+                      + "\ttrace=" + stages);
+}
+
+
+
+/*****************************************************************
+** Function: runJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Traces the job
+** October 19th, 2026 - Reserves memory and pooled buffers for the job
+** October 19th, 2026 - Runs list jobs and counts the files of a folder secret
+** October 19th, 2026 - Runs append jobs
+** October 19th, 2026 - Runs update jobs
+** October 19th, 2026 - Fails jobs larger than the memory budget
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void runJob(StegoDaemon *daemon, DaemonJob job)
+**            StegoDaemon *daemon -- Daemon to report through
+**            DaemonJob job -- Job to run
+**
+** Returns: void
+**
+** Notes:
+** Runs on a worker thread, once the memory the job needs is free.
+**********************************************************************/
+void StegoDaemon::runJob(StegoDaemon *daemon, DaemonJob job)
+{
+    QFileInfo secretInfo(job.args.value(1));
+    long long secretSize = 0;
+    bool embeds = (job.command == "embed" || job.command == "append" || job.command == "update");
+    if (embeds && secretInfo.isDir())
+    {
+        QFileInfoList files = folderFiles(secretInfo.filePath());
+        for (int i = 0; i < files.size(); i++)
+        {
+            secretSize += files[i].size();
+        }
+    }
+    else if (embeds)
+    {
+        secretSize = secretInfo.size();
+    }
+    long long reserved = reserveMemory(estimateJobMemory(job.args.value(0), secretSize));
+    if (reserved < 0)
+    {
+        emit daemon->jobFinished(job.connection, job.id, "over memory budget", false, job.received, 0, QByteArray());
+        return;
+    }
+    JobBuffers *buffers = acquireBuffers();
+
+    QElapsedTimer timer;
+    timer.start();
+    traceStartJob(job.command.toStdString() + " " + QFileInfo(job.args.value(0)).fileName().toStdString());
+
+    bool ok = false;
+    QByteArray result;
+
+    if (job.command == "embed")
+    {
+        result = embedJob(job, buffers, &ok);
+    }
+    else if (job.command == "extract")
+    {
+        result = extractJob(job, buffers, &ok);
+    }
+    else if (job.command == "list")
+    {
+        result = listJob(job, buffers, &ok);
+    }
+    else if (job.command == "append")
+    {
+        result = appendJob(job, buffers, &ok);
+    }
+    else if (job.command == "update")
+    {
+        result = updateJob(job, buffers, &ok);
+    }
+    else
+    {
+        result = probeJob(job, buffers, &ok);
+    }
+
+    QByteArray stages = QByteArray::fromStdString(traceFinishJob());
+    releaseBuffers(buffers);
+    releaseMemory(reserved);
+    emit daemon->jobFinished(job.connection, job.id, result, ok, job.received, timer.nsecsElapsed(), stages);
+}
+
+
+
+/*****************************************************************
+** Function: embedJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Times the decode, secret read and save
+** October 19th, 2026 - Works in pooled buffers
+** October 19th, 2026 - Takes the embedding options
+** October 19th, 2026 - Embeds JPEG to JPEG in the DCT coefficients
+** October 19th, 2026 - Streams Y4M carriers through y4mEmbedJob
+** October 19th, 2026 - Embeds the files of a folder as an archive
+** October 19th, 2026 - Reads the secret through readSecretFiles
+** October 19th, 2026 - Takes the carrier from the carrier cache
+** October 19th, 2026 - Writes into the pooled pixels
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray embedJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier, secret, output, bit positions and options
+**            JobBuffers *buffers -- Buffers to decode the carrier and hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path of the saved carrier, or the error
+**********************************************************************/
+QByteArray StegoDaemon::embedJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    if (!job.args.isEmpty() && y4mIsCarrier(job.args[0].toStdString()))
+    {
+        return y4mEmbedJob(job, ok);
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() < 4 || job.args.size() > 5 || !parseBits(job.args[3], enabledBits, &detect) || detect)
+    {
+        return "bad request";
+    }
+
+    StegoOptions options;
+    stegoDefaultOptions(&options);
+    if (job.args.size() == 5 && !stegoParseOptions(job.args[4].toStdString(), &options))
+    {
+        return "bad options";
+    }
+
+    //a JPEG saved as a JPEG keeps its coefficients, its pixels are never decoded
+    QString outputSuffix = QFileInfo(job.args[2]).suffix().toLower();
+    if ((outputSuffix == "jpg" || outputSuffix == "jpeg") && jpegIsCarrier(job.args[0].toStdString()))
+    {
+        if (!stegoFormatOptions(&options).empty() || options.matching != 0)
+        {
+            return "bad options";
+        }
+        return jpegEmbedJob(job, buffers, ok);
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    vector<ArchiveFile> archive;
+    QByteArray error = readSecretFiles(job.args[1], buffers, &archive);
+    if (!error.isEmpty())
+    {
+        return error;
+    }
+
+    detachCarrier(buffers);
+    int result;
+    if (QFileInfo(job.args[1]).isDir())
+    {
+        result = embedSecretFiles(&buffers->carrier, QDir(job.args[1]).dirName().toStdString(), archive,
+                                  enabledBits, &options);
+    }
+    else
+    {
+        result = embedSecretData(&buffers->carrier, archive[0].name, archive[0].data, archive[0].size,
+                                 enabledBits, &options);
+    }
+    if (result == STEGO_TOO_BIG)
+    {
+        return "secret too big";
+    }
+    if (result != STEGO_OK)
+    {
+        return "embed failed";
+    }
+
+    if (!saveCarrier(&buffers->carrier, job.args[2]))
+    {
+        return "could not save carrier";
+    }
+
+    *ok = true;
+    return job.args[2].toUtf8();
+}
+
+
+
+/*****************************************************************
+** Function: appendJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Takes the carrier from the carrier cache
+** October 19th, 2026 - Writes into the pooled pixels
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray appendJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier, secret, output, bit positions and options
+**            JobBuffers *buffers -- Buffers to decode the carrier and hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path of the saved carrier, or the error
+**
+** Notes:
+** A file is added to the end of a single secret, and the files of a
+** folder to an archive. Only LSB matching can be asked for, the rest
+** of the options are those of the secret. JPEG and Y4M carriers can
+** not be appended to.
+**********************************************************************/
+QByteArray StegoDaemon::appendJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() < 4 || job.args.size() > 5 || !parseBits(job.args[3], enabledBits, &detect)
+        || jpegIsCarrier(job.args[0].toStdString()) || y4mIsCarrier(job.args[0].toStdString()))
+    {
+        return "bad request";
+    }
+
+    StegoOptions options;
+    stegoDefaultOptions(&options);
+    if (job.args.size() == 5 && (!stegoParseOptions(job.args[4].toStdString(), &options)
+                                 || !stegoFormatOptions(&options).empty()))
+    {
+        return "bad options";
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    SecretHeader header;
+    if ((detect && detectBitMask(&buffers->carrier, enabledBits) == 0)
+        || readSecretHeader(&buffers->carrier, enabledBits, &header) != STEGO_OK)
+    {
+        return "no secret found";
+    }
+
+    bool folder = QFileInfo(job.args[1]).isDir();
+    if (folder && header.options.archiveIndex == 0)
+    {
+        return "not an archive";
+    }
+
+    vector<ArchiveFile> archive;
+    QByteArray error = readSecretFiles(job.args[1], buffers, &archive);
+    if (!error.isEmpty())
+    {
+        return error;
+    }
+
+    detachCarrier(buffers);
+    int result;
+    if (header.options.archiveIndex > 0)
+    {
+        result = appendSecretFiles(&buffers->carrier, archive, enabledBits, &options);
+    }
+    else
+    {
+        result = appendSecretData(&buffers->carrier, archive[0].data, archive[0].size, enabledBits, &options);
+    }
+    if (result == STEGO_TOO_BIG)
+    {
+        return "secret too big";
+    }
+    if (result == STEGO_CORRUPT)
+    {
+        return "secret too damaged";
+    }
+    if (result == STEGO_ERROR && header.options.archiveIndex > 0)
+    {
+        return "file already in archive";
+    }
+    if (result != STEGO_OK)
+    {
+        return "append failed";
+    }
+
+    if (!saveCarrier(&buffers->carrier, job.args[2]))
+    {
+        return "could not save carrier";
+    }
+
+    *ok = true;
+    return job.args[2].toUtf8();
+}
+
+
+
+/*****************************************************************
+** Function: updateJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Writes into the pooled pixels
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray updateJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier, new version of the secret, output, bit positions and options
+**            JobBuffers *buffers -- Buffers to decode the carrier and hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path of the saved carrier and the bytes embedded
+**                        again, or the error
+**
+** Notes:
+** Only a single secret can be updated, not an archive. Only LSB
+** matching can be asked for, the rest of the options are those of the
+** secret. JPEG and Y4M carriers can not be updated.
+**********************************************************************/
+QByteArray StegoDaemon::updateJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() < 4 || job.args.size() > 5 || !parseBits(job.args[3], enabledBits, &detect)
+        || QFileInfo(job.args[1]).isDir()
+        || jpegIsCarrier(job.args[0].toStdString()) || y4mIsCarrier(job.args[0].toStdString()))
+    {
+        return "bad request";
+    }
+
+    StegoOptions options;
+    stegoDefaultOptions(&options);
+    if (job.args.size() == 5 && (!stegoParseOptions(job.args[4].toStdString(), &options)
+                                 || !stegoFormatOptions(&options).empty()))
+    {
+        return "bad options";
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    if (detect && detectBitMask(&buffers->carrier, enabledBits) == 0)
+    {
+        return "no secret found";
+    }
+
+    vector<ArchiveFile> archive;
+    QByteArray error = readSecretFiles(job.args[1], buffers, &archive);
+    if (!error.isEmpty())
+    {
+        return error;
+    }
+
+    detachCarrier(buffers);
+    long long changed;
+    int result = updateSecretData(&buffers->carrier, archive[0].data, archive[0].size, enabledBits, &options,
+                                  &changed);
+    if (result == STEGO_NO_SECRET)
+    {
+        return "no secret found";
+    }
+    if (result == STEGO_TOO_BIG)
+    {
+        return "secret too big";
+    }
+    if (result == STEGO_ERROR)
+    {
+        return "can not update an archive or an empty secret";
+    }
+    if (result != STEGO_OK)
+    {
+        return "update failed";
+    }
+
+    if (!saveCarrier(&buffers->carrier, job.args[2]))
+    {
+        return "could not save carrier";
+    }
+
+    *ok = true;
+    return job.args[2].toUtf8() + "\tchanged=" + QByteArray::number(changed);
+}
+
+
+
+/*****************************************************************
+** Function: jpegEmbedJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray jpegEmbedJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- JPEG carrier, secret and JPEG output
+**            JobBuffers *buffers -- Buffers to hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path of the saved carrier, or the error
+**********************************************************************/
+QByteArray StegoDaemon::jpegEmbedJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    QFile secret(job.args[1]);
+    if (!secret.open(QIODevice::ReadOnly))
+    {
+        return "could not open secret";
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_SECRET_READ);
+    buffers->secret.resize((size_t) secret.size());
+    bool read = (secret.read(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size());
+    traceEnd(&span, 0, (long long) buffers->secret.size());
+
+    if (!read)
+    {
+        return "could not read secret";
+    }
+
+    int result = jpegEmbed(job.args[0].toStdString(), job.args[2].toStdString(),
+                           QFileInfo(job.args[1]).fileName().toStdString(),
+                           buffers->secret.data(), (long long) buffers->secret.size());
+    if (result == STEGO_TOO_BIG)
+    {
+        return "secret too big";
+    }
+    if (result == STEGO_WRITE_FAILED)
+    {
+        return "could not save carrier";
+    }
+    if (result != STEGO_OK)
+    {
+        return "could not read carrier";
+    }
+
+    *ok = true;
+    return job.args[2].toUtf8();
+}
+
+
+
+/*****************************************************************
+** Function: y4mEmbedJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray y4mEmbedJob(const DaemonJob &job, bool *ok)
+**            const DaemonJob &job -- Y4M carrier, secret, output, bit positions and planes
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path of the saved carrier, or the error
+**
+** Notes:
+** The secret is read from its file as the frames need it, so neither
+** it nor the video is ever held in memory whole.
+**********************************************************************/
+QByteArray StegoDaemon::y4mEmbedJob(const DaemonJob &job, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    int planes = Y4M_PLANE_LUMA;
+    if (job.args.size() < 4 || job.args.size() > 5 || !parseBits(job.args[3], enabledBits, &detect) || detect
+        || (job.args.size() == 5 && !parsePlanes(job.args[4], &planes)))
+    {
+        return "bad request";
+    }
+
+    QFile secret(job.args[1]);
+    if (!secret.open(QIODevice::ReadOnly))
+    {
+        return "could not open secret";
+    }
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, NUM_BITS);
+    int result = y4mEmbed(job.args[0].toStdString(), job.args[2].toStdString(), &bitMask, planes,
+                          QFileInfo(job.args[1]).fileName().toStdString(), (long long) secret.size(),
+                          readJobFile, &secret);
+    if (result == STEGO_TOO_BIG)
+    {
+        return "secret too big";
+    }
+    if (result == STEGO_READ_FAILED)
+    {
+        return "could not read secret";
+    }
+    if (result == STEGO_WRITE_FAILED)
+    {
+        return "could not save carrier";
+    }
+    if (result != STEGO_OK)
+    {
+        return "could not read carrier";
+    }
+
+    *ok = true;
+    return job.args[2].toUtf8();
+}
+
+
+
+/*****************************************************************
+** Function: extractJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Times the decode and secret write
+** October 19th, 2026 - Works in pooled buffers
+** October 19th, 2026 - Reads JPEG carriers in the DCT coefficients
+** October 19th, 2026 - Streams Y4M carriers through y4mExtractJob
+** October 19th, 2026 - Tells a secret too damaged to correct from no secret
+** October 19th, 2026 - Writes the files of an archive, or the one named
+** October 19th, 2026 - Takes the carrier from the carrier cache
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray extractJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier, output folder, bit positions and any file to retrieve
+**            JobBuffers *buffers -- Buffers to decode the carrier and hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path and size of each retrieved file, or the error
+**
+** Notes:
+** Only the file name of the secret is used, so a crafted header can
+** not write outside the output folder.
+**********************************************************************/
+QByteArray StegoDaemon::extractJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    if (!job.args.isEmpty() && y4mIsCarrier(job.args[0].toStdString()))
+    {
+        return y4mExtractJob(job, ok);
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() < 3 || job.args.size() > 4 || !parseBits(job.args[2], enabledBits, &detect))
+    {
+        return "bad request";
+    }
+
+    if (jpegIsCarrier(job.args[0].toStdString()))
+    {
+        return (job.args.size() == 3) ? jpegExtractJob(job, buffers, ok) : QByteArray("bad request");
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    if (detect && detectBitMask(&buffers->carrier, enabledBits) == 0)
+    {
+        return "no secret found";
+    }
+
+    SecretHeader header;
+    vector<ArchiveEntry> entries;
+    int result = listSecretFiles(&buffers->carrier, enabledBits, &header, &entries);
+    if (result == STEGO_CORRUPT)
+    {
+        return "secret too damaged";
+    }
+    if (result != STEGO_OK)
+    {
+        return "no secret found";
+    }
+
+    QByteArray written;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (job.args.size() == 4 && QString::fromStdString(entries[i].name) != job.args[3])
+        {
+            continue;
+        }
+
+        result = retrieveSecretFile(&buffers->carrier, enabledBits, &header, &entries[i], &buffers->secret);
+        if (result == STEGO_CORRUPT)
+        {
+            return "secret too damaged";
+        }
+        if (result != STEGO_OK)
+        {
+            return "no secret found";
+        }
+
+        QString path = QDir(job.args[1]).filePath(QFileInfo(QString::fromStdString(entries[i].name)).fileName());
+        traceBegin(&span, STAGE_FILE_WRITE);
+        QFile secret(path);
+        bool saved = secret.open(QIODevice::WriteOnly)
+                     && secret.write(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size();
+        traceEnd(&span, 0, (long long) buffers->secret.size());
+
+        if (!saved)
+        {
+            return "could not write secret";
+        }
+        written += (written.isEmpty() ? "" : "\t") + path.toUtf8() + "\t"
+                   + QByteArray::number((qlonglong) buffers->secret.size());
+    }
+
+    if (written.isEmpty())
+    {
+        return "no such file";
+    }
+
+    *ok = true;
+    return written;
+}
+
+
+
+/*****************************************************************
+** Function: jpegExtractJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray jpegExtractJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- JPEG carrier and output folder
+**            JobBuffers *buffers -- Buffers to hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path and size of the retrieved secret, or the error
+**
+** Notes:
+** Only the file name of the secret is used, the same as extractJob.
+**********************************************************************/
+QByteArray StegoDaemon::jpegExtractJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    string name;
+    int result = jpegExtract(job.args[0].toStdString(), &name, &buffers->secret);
+    if (result == STEGO_ERROR)
+    {
+        return "could not read carrier";
+    }
+    if (result != STEGO_OK)
+    {
+        return "no secret found";
+    }
+
+    QString path = QDir(job.args[1]).filePath(QFileInfo(QString::fromStdString(name)).fileName());
+    TraceSpan span;
+    traceBegin(&span, STAGE_FILE_WRITE);
+    QFile secret(path);
+    bool written = secret.open(QIODevice::WriteOnly)
+                   && secret.write(buffers->secret.data(), (qint64) buffers->secret.size()) == (qint64) buffers->secret.size();
+    traceEnd(&span, 0, (long long) buffers->secret.size());
+
+    if (!written)
+    {
+        return "could not write secret";
+    }
+
+    *ok = true;
+    return path.toUtf8() + "\t" + QByteArray::number((qlonglong) buffers->secret.size());
+}
+
+
+
+/*****************************************************************
+** Function: y4mExtractJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray y4mExtractJob(const DaemonJob &job, bool *ok)
+**            const DaemonJob &job -- Y4M carrier, output folder, bit positions and planes
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Path and size of the retrieved secret, or the error
+**
+** Notes:
+** The secret is written to its file as the frames are read. Only the
+** file name of the secret is used, the same as extractJob.
+**********************************************************************/
+QByteArray StegoDaemon::y4mExtractJob(const DaemonJob &job, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    int planes = Y4M_PLANE_LUMA;
+    if (job.args.size() < 3 || job.args.size() > 4 || !parseBits(job.args[2], enabledBits, &detect) || detect
+        || (job.args.size() == 4 && !parsePlanes(job.args[3], &planes)))
+    {
+        return "bad request";
+    }
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, NUM_BITS);
+    SecretHeader header;
+    int result = y4mReadHeader(job.args[0].toStdString(), &bitMask, planes, &header);
+    if (result == STEGO_ERROR)
+    {
+        return "could not read carrier";
+    }
+    if (result != STEGO_OK)
+    {
+        return "no secret found";
+    }
+
+    QString path = QDir(job.args[1]).filePath(QFileInfo(QString::fromStdString(header.name)).fileName());
+    QFile secret(path);
+    if (!secret.open(QIODevice::WriteOnly))
+    {
+        return "could not write secret";
+    }
+
+    result = y4mExtractStream(job.args[0].toStdString(), &bitMask, planes, &header, writeJobFile, &secret);
+    if (result != STEGO_OK)
+    {
+        secret.remove();
+        return (result == STEGO_WRITE_FAILED) ? "could not write secret" : "could not read carrier";
+    }
+
+    *ok = true;
+    return path.toUtf8() + "\t" + QByteArray::number(header.size);
+}
+
+
+
+/*****************************************************************
+** Function: probeJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Times the decode
+** October 19th, 2026 - Works in pooled buffers
+** October 19th, 2026 - Probes JPEG carriers in the DCT coefficients
+** October 19th, 2026 - Probes Y4M carriers through y4mProbeJob
+** October 19th, 2026 - Takes the carrier from the carrier cache
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray probeJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier and bit positions
+**            JobBuffers *buffers -- Buffers to decode the carrier and hold the secret in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Capacity and secret of the carrier, or the error
+**
+** Notes:
+** Reports how many bytes the carrier can hold with the bit positions
+** and the name and size of the secret it holds, if any, without
+** retrieving it.
+**********************************************************************/
+QByteArray StegoDaemon::probeJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    if (!job.args.isEmpty() && y4mIsCarrier(job.args[0].toStdString()))
+    {
+        return y4mProbeJob(job, ok);
+    }
+
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() != 2 || !parseBits(job.args[1], enabledBits, &detect))
+    {
+        return "bad request";
+    }
+
+    if (jpegIsCarrier(job.args[0].toStdString()))
+    {
+        return jpegProbeJob(job, ok);
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    SecretHeader header;
+    bool found = !(detect && detectBitMask(&buffers->carrier, enabledBits) == 0)
+                 && readSecretHeader(&buffers->carrier, enabledBits, &header) == STEGO_OK;
+
+    int numBits = 0;
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        numBits += (enabledBits[i] && (i < NUM_BITS || carrierBitDepth(buffers->carrier.format()) == 16));
+    }
+    long long capacity = (long long) buffers->carrier.width() * buffers->carrier.height()
+                         * carrierChannels(buffers->carrier.format()) * numBits / 8;
+
+    *ok = true;
+    QByteArray result = "capacity=" + QByteArray::number(capacity);
+    if (found)
+    {
+        return result + "\tsecret=" + QByteArray::fromStdString(header.name)
+                      + "\tsize=" + QByteArray::number(header.size);
+    }
+    return result + "\tsecret=none";
+}
+
+
+
+/*****************************************************************
+** Function: jpegProbeJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray jpegProbeJob(const DaemonJob &job, bool *ok)
+**            const DaemonJob &job -- JPEG carrier
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Capacity and secret of the carrier, or the error
+**********************************************************************/
+QByteArray StegoDaemon::jpegProbeJob(const DaemonJob &job, bool *ok)
+{
+    long long capacity = jpegCapacity(job.args[0].toStdString());
+    if (capacity < 0)
+    {
+        return "could not read carrier";
+    }
+
+    SecretHeader header;
+    bool found = (jpegReadHeader(job.args[0].toStdString(), &header) == STEGO_OK);
+
+    *ok = true;
+    QByteArray result = "capacity=" + QByteArray::number(capacity / 8);
+    if (found)
+    {
+        return result + "\tsecret=" + QByteArray::fromStdString(header.name)
+                      + "\tsize=" + QByteArray::number(header.size);
+    }
+    return result + "\tsecret=none";
+}
+
+
+
+/*****************************************************************
+** Function: y4mProbeJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray y4mProbeJob(const DaemonJob &job, bool *ok)
+**            const DaemonJob &job -- Y4M carrier, bit positions and planes
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Capacity and secret of the carrier, or the error
+**********************************************************************/
+QByteArray StegoDaemon::y4mProbeJob(const DaemonJob &job, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    int planes = Y4M_PLANE_LUMA;
+    if (job.args.size() < 2 || job.args.size() > 3 || !parseBits(job.args[1], enabledBits, &detect) || detect
+        || (job.args.size() == 3 && !parsePlanes(job.args[2], &planes)))
+    {
+        return "bad request";
+    }
+
+    BitMask bitMask;
+    buildBitMask(&bitMask, enabledBits, NUM_BITS);
+    long long capacity = y4mCapacity(job.args[0].toStdString(), &bitMask, planes);
+    if (capacity < 0)
+    {
+        return "could not read carrier";
+    }
+
+    SecretHeader header;
+    bool found = (y4mReadHeader(job.args[0].toStdString(), &bitMask, planes, &header) == STEGO_OK);
+
+    *ok = true;
+    QByteArray result = "capacity=" + QByteArray::number(capacity / 8);
+    if (found)
+    {
+        return result + "\tsecret=" + QByteArray::fromStdString(header.name)
+                      + "\tsize=" + QByteArray::number(header.size);
+    }
+    return result + "\tsecret=none";
+}
+
+
+
+/*****************************************************************
+** Function: listJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Takes the carrier from the carrier cache
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray listJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+**            const DaemonJob &job -- Carrier and bit positions
+**            JobBuffers *buffers -- Buffers to decode the carrier in
+**            bool *ok -- Set to true if the job succeeded
+**
+** Returns:
+**          QByteArray -- Name and size of each file of the secret, or the error
+**
+** Notes:
+** Only the header and index of the secret are retrieved. A secret
+** that is not an archive is listed as its one file.
+**********************************************************************/
+QByteArray StegoDaemon::listJob(const DaemonJob &job, JobBuffers *buffers, bool *ok)
+{
+    bool enabledBits[MAX_NUM_BITS];
+    bool detect;
+    if (job.args.size() != 2 || !parseBits(job.args[1], enabledBits, &detect))
+    {
+        return "bad request";
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_DECODE);
+    QString decodeError;
+    bool decoded = readCachedCarrier(job.args[0], &buffers->carrier, &decodeError);
+    traceEnd(&span, (long long) buffers->carrier.width() * buffers->carrier.height(), buffers->carrier.sizeInBytes());
+
+    if (!decoded)
+    {
+        return "could not read carrier: " + decodeError.toUtf8();
+    }
+
+    if (detect && detectBitMask(&buffers->carrier, enabledBits) == 0)
+    {
+        return "no secret found";
+    }
+
+    SecretHeader header;
+    vector<ArchiveEntry> entries;
+    int result = listSecretFiles(&buffers->carrier, enabledBits, &header, &entries);
+    if (result == STEGO_CORRUPT)
+    {
+        return "secret too damaged";
+    }
+    if (result != STEGO_OK)
+    {
+        return "no secret found";
+    }
+
+    QByteArray list = "files=" + QByteArray::number((qulonglong) entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        list += "\t" + QByteArray::fromStdString(entries[i].name) + "\t" + QByteArray::number(entries[i].size);
+    }
+
+    *ok = true;
+    return list;
+}
+
+
+
+/*****************************************************************
+** Function: parseBits
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool parseBits(const QString &text, bool *enabledBits, bool *detect)
+**            const QString &text -- Comma separated bit positions, or "auto"
+**            bool *enabledBits -- Set to the positions listed
+**            bool *detect -- Set to true if the positions should be detected
+**
+** Returns:
+**          bool -- False if the text is not a valid list
+**********************************************************************/
+bool StegoDaemon::parseBits(const QString &text, bool *enabledBits, bool *detect)
+{
+    for (int i = 0; i < MAX_NUM_BITS; i++)
+    {
+        enabledBits[i] = false;
+    }
+
+    *detect = (text == "auto");
+    if (*detect)
+    {
+        return true;
+    }
+
+    QStringList positions = text.split(',');
+    for (int i = 0; i < positions.size(); i++)
+    {
+        bool valid;
+        int pos = positions[i].toInt(&valid);
+        if (!valid || pos < 0 || pos >= MAX_NUM_BITS)
+        {
+            return false;
+        }
+
+        enabledBits[pos] = true;
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: parsePlanes
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool parsePlanes(const QString &text, int *planes)
+**            const QString &text -- "luma", "chroma" or "all"
+**            int *planes -- Set to the Y4M_PLANE_ flags named
+**
+** Returns:
+**          bool -- False if the text names no planes
+**********************************************************************/
+bool StegoDaemon::parsePlanes(const QString &text, int *planes)
+{
+    if (text == "luma")
+    {
+        *planes = Y4M_PLANE_LUMA;
+    }
+    else if (text == "chroma")
+    {
+        *planes = Y4M_PLANE_CHROMA;
+    }
+    else if (text == "all")
+    {
+        *planes = Y4M_PLANE_LUMA | Y4M_PLANE_CHROMA;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: reply
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void reply(quint64 connection, const QByteArray &line)
+**            quint64 connection -- Client to answer
+**            const QByteArray &line -- Reply, without the newline
+**
+** Returns: void
+**********************************************************************/
+void StegoDaemon::reply(quint64 connection, const QByteArray &line)
+{
+    QLocalSocket *socket = connections.value(connection, 0);
+    if (socket != 0)
+    {
+        socket->write(line + "\n");
+    }
+}
+
+
+
+/*****************************************************************
+** Function: statistics
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+** October 19th, 2026 - Reports the memory reserved
+** October 19th, 2026 - Reports how the carrier cache is doing
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray statistics() const
+**
+** Returns:
+**          QByteArray -- Counters of the jobs run since the daemon started
+**********************************************************************/
+QByteArray StegoDaemon::statistics() const
+{
+    qint64 numJobs = jobsDone + jobsFailed;
+    CarrierCacheStats cache = carrierCacheStats();
+
+    return "done=" + QByteArray::number(jobsDone)
+           + "\tfailed=" + QByteArray::number(jobsFailed)
+           + "\tmean_latency_us=" + QByteArray::number(numJobs ? totalLatency / numJobs / 1000 : 0)
+           + "\tmax_latency_us=" + QByteArray::number(maxLatency / 1000)
+           + "\tqueue=" + QByteArray::number(pending.loadAcquire())
+           + "\tthreads=" + QByteArray::number(pool.maxThreadCount())
+           + "\treserved_mb=" + QByteArray::number(memoryReserved() / (1024 * 1024))
+           + "\tbudget_mb=" + QByteArray::number(memoryBudget() / (1024 * 1024))
+           + "\tcache_hits=" + QByteArray::number(cache.hits)
+           + "\tcache_misses=" + QByteArray::number(cache.misses)
+           + "\tcache_mb=" + QByteArray::number(cache.bytes / (1024 * 1024));
+}
+
+
+
+/*****************************************************************
+** Function: readJobFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long readJobFile(void *context, char *buffer, long length)
+**            void *context -- QFile of the secret
+**            char *buffer -- Receives the next bytes of the secret
+**            long length -- Most bytes to read
+**
+** Returns:
+**          long -- Number of bytes read, 0 at the end of the file or on an error
+**********************************************************************/
+static long readJobFile(void *context, char *buffer, long length)
+{
+    qint64 numRead = ((QFile *) context)->read(buffer, length);
+
+    return (numRead > 0) ? (long) numRead : 0;
+}
+
+
+
+/*****************************************************************
+** Function: writeJobFile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeJobFile(void *context, const char *buffer, long length)
+**            void *context -- QFile of the retrieved secret
+**            const char *buffer -- Next bytes of the secret
+**            long length -- Number of bytes
+**
+** Returns:
+**          bool -- False if the file could not be written
+**********************************************************************/
+static bool writeJobFile(void *context, const char *buffer, long length)
+{
+    return ((QFile *) context)->write(buffer, length) == (qint64) length;
+}
+
+
+
+/*****************************************************************
+** Function: folderFiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QFileInfoList folderFiles(const QString &path)
+**            const QString &path -- Folder given as a secret
+**
+** Returns:
+**          QFileInfoList -- The files in it, by name
+**
+** Notes:
+** Only the files directly in the folder are taken, as an archive
+** keeps file names alone.
+**********************************************************************/
+static QFileInfoList folderFiles(const QString &path)
+{
+    return QDir(path).entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+}
+
+
+
+/*****************************************************************
+** Function: readSecretFiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QByteArray readSecretFiles(const QString &path, JobBuffers *buffers, vector<ArchiveFile> *files)
+**            const QString &path -- Secret file, or a folder of them
+**            JobBuffers *buffers -- Buffers to hold the secret in
+**            vector<ArchiveFile> *files -- Set to each file read, in the secret buffer
+**
+** Returns:
+**          QByteArray -- The error, empty if every file was read
+**
+** Notes:
+** The files of a folder are read one after the other into the secret
+** buffer.
+**********************************************************************/
+static QByteArray readSecretFiles(const QString &path, JobBuffers *buffers, vector<ArchiveFile> *files)
+{
+    QFileInfoList infos;
+    if (QFileInfo(path).isDir())
+    {
+        infos = folderFiles(path);
+        if (infos.isEmpty())
+        {
+            return "could not open secret";
+        }
+    }
+    else
+    {
+        infos.append(QFileInfo(path));
+    }
+
+    long long totalSize = 0;
+    for (int i = 0; i < infos.size(); i++)
+    {
+        totalSize += infos[i].size();
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_SECRET_READ);
+    buffers->secret.resize((size_t) totalSize);
+    files->clear();
+    long long offset = 0;
+    bool opened = true;
+    bool read = true;
+    for (int i = 0; i < infos.size() && opened && read; i++)
+    {
+        QFile secret(infos[i].filePath());
+        long long size = infos[i].size();
+        opened = secret.open(QIODevice::ReadOnly);
+        read = opened && secret.read(buffers->secret.data() + offset, (qint64) size) == (qint64) size;
+
+        ArchiveFile file = {infos[i].fileName().toStdString(), buffers->secret.data() + offset, size};
+        files->push_back(file);
+        offset += size;
+    }
+    traceEnd(&span, 0, totalSize);
+
+    if (!opened)
+    {
+        return "could not open secret";
+    }
+    if (!read)
+    {
+        return "could not read secret";
+    }
+
+    return "";
+}
@@ -0,0 +1,81 @@
+#ifndef STEGODAEMON_H
+#define STEGODAEMON_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include "bufferPool.h"
+
+#define DEFAULT_SOCKET_NAME "imagestego"
+#define DEFAULT_MAX_PENDING 256
+
+//one request read off a connection
+struct DaemonJob
+{
+    quint64 connection;
+    QByteArray id;
+    QByteArray command;
+    QStringList args;
+    qint64 received;            //nanoseconds since the daemon started
+};
+
+class StegoDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    StegoDaemon(QObject *parent = 0);
+    ~StegoDaemon();
+    bool listen(QString, int, int);
+    static bool parseBits(const QString &, bool *, bool *);
+
+signals:
+    void jobFinished(quint64, QByteArray, QByteArray, bool, qint64, qint64, QByteArray);
+
+private slots:
+    void acceptConnection();
+    void readRequests();
+    void dropConnection();
+    void sendResult(quint64, QByteArray, QByteArray, bool, qint64, qint64, QByteArray);
+
+private:
+    static void runJob(StegoDaemon *, DaemonJob);
+    static QByteArray embedJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray jpegEmbedJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray y4mEmbedJob(const DaemonJob &, bool *);
+    static QByteArray appendJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray updateJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray extractJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray jpegExtractJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray y4mExtractJob(const DaemonJob &, bool *);
+    static QByteArray probeJob(const DaemonJob &, JobBuffers *, bool *);
+    static QByteArray jpegProbeJob(const DaemonJob &, bool *);
+    static QByteArray y4mProbeJob(const DaemonJob &, bool *);
+    static QByteArray listJob(const DaemonJob &, JobBuffers *, bool *);
+    static bool parsePlanes(const QString &, int *);
+    void reply(quint64, const QByteArray &);
+    QByteArray statistics() const;
+
+    QLocalServer server;
+    QThreadPool pool;
+    QElapsedTimer clock;
+    QHash<quint64, QLocalSocket *> connections;
+    quint64 nextConnection;
+    int maxPending;
+
+    //jobs accepted but not yet answered
+    QAtomicInt pending;
+
+    qint64 jobsDone;
+    qint64 jobsFailed;
+    qint64 totalLatency;
+    qint64 maxLatency;
+};
+
+#endif // STEGODAEMON_H
@@ -0,0 +1,452 @@
+/**********************************************************************
+**	SOURCE FILE:	stegoTrace.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** long long traceStartJob(const string &)
+** string traceFinishJob()
+** void traceBegin(TraceSpan *, const char *)
+** void traceEnd(TraceSpan *, long long, long long)
+** bool traceWriteChrome(const string &)
+** long long traceClock()
+** string escapeJson(const string &)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Times the stages of each embed and retrieve so a slow job can be
+** pinned on the decode, the bit loop or the save. A job is whatever
+** runs on one thread between traceStartJob and traceFinishJob; every
+** stage timed in between is added to it along with the pixels and
+** bytes it went through.
+**
+** All stages are also kept as a timeline (up to MAX_TRACE_EVENTS of
+** them) that can be written out as Chrome trace events and opened in
+** chrome://tracing or Perfetto.
+*************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include "stegoTrace.h"
+
+using namespace std;
+
+//one timed stage on the timeline
+struct TraceEvent
+{
+    const char *stage;
+    long long start;
+    long long duration;
+    int thread;
+    long long job;
+    long long pixels;
+    long long bytes;
+};
+
+//time and counters of one stage within a job
+struct StageTotal
+{
+    const char *stage;
+    long long duration;
+    long long pixels;
+    long long bytes;
+};
+
+//a job that has not finished yet
+struct JobTrace
+{
+    string label;
+    long long start;
+    vector<StageTotal> stages;
+};
+
+static mutex traceLock;
+static vector<TraceEvent> traceEvents;
+static map<long long, JobTrace> activeJobs;
+static map<long long, string> jobLabels;
+static long long droppedEvents = 0;
+
+static atomic<long long> nextJob(1);
+static atomic<int> nextThread(1);
+static thread_local long long currentJob = 0;
+static thread_local int traceThread = 0;
+
+static const chrono::steady_clock::time_point traceEpoch = chrono::steady_clock::now();
+
+static long long traceClock();
+static string escapeJson(const string &);
+
+
+/*****************************************************************
+** Function: traceStartJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long traceStartJob(const string &label)
+**              const string &label -- Describes the job in summaries and traces
+**
+**
+** Returns:
+**			long long -- Id of the job
+**
+** Notes:
+** Stages timed on this thread from now on belong to the job. A job
+** still open on the thread is dropped.
+**********************************************************************/
+long long traceStartJob(const string &label)
+{
+    long long job = nextJob++;
+
+    JobTrace trace;
+    trace.label = label;
+    trace.start = traceClock();
+
+    lock_guard<mutex> guard(traceLock);
+
+    //a job that was never finished is dropped
+    activeJobs.erase(currentJob);
+    currentJob = job;
+
+    activeJobs[job] = trace;
+    if (traceEvents.size() < MAX_TRACE_EVENTS)
+    {
+        jobLabels[job] = label;
+    }
+
+    return job;
+}
+
+
+
+/*****************************************************************
+** Function: traceFinishJob
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string traceFinishJob()
+**
+**
+** Returns:
+**			string -- One line summary of the job, empty if none was started
+**
+** Notes:
+** Ends the job of this thread. The summary gives the job's total time,
+** the time of each stage in the order they first ran, and the pixels
+** and bytes the embed or extract kernel went through, e.g.
+**
+**   embed cat.png total=41.20ms decode=30.02ms embed=3.10ms pixels=80000 bytes=30000
+**********************************************************************/
+string traceFinishJob()
+{
+    if (currentJob == 0)
+    {
+        return "";
+    }
+
+    long long end = traceClock();
+    long long job = currentJob;
+    currentJob = 0;
+
+    lock_guard<mutex> guard(traceLock);
+    map<long long, JobTrace>::iterator trace = activeJobs.find(job);
+    if (trace == activeJobs.end())
+    {
+        return "";
+    }
+
+    char number[64];
+    stringstream summary;
+    snprintf(number, sizeof(number), "%.2fms", (end - trace->second.start) / 1e6);
+    summary << trace->second.label << " total=" << number;
+
+    long long pixels = 0;
+    long long bytes = 0;
+    for (size_t i = 0; i < trace->second.stages.size(); i++)
+    {
+        const StageTotal &stage = trace->second.stages[i];
+        snprintf(number, sizeof(number), "%.2fms", stage.duration / 1e6);
+        summary << " " << stage.stage << "=" << number;
+
+        if (strcmp(stage.stage, STAGE_EMBED) == 0 || strcmp(stage.stage, STAGE_EXTRACT) == 0)
+        {
+            pixels += stage.pixels;
+            bytes += stage.bytes;
+        }
+    }
+    summary << " pixels=" << pixels << " bytes=" << bytes;
+
+    activeJobs.erase(trace);
+
+    return summary.str();
+}
+
+
+
+/*****************************************************************
+** Function: traceBegin
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void traceBegin(TraceSpan *span, const char *stage)
+**              TraceSpan *span -- Filled in with the stage and its start
+**              const char *stage -- One of the STAGE_ names
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+void traceBegin(TraceSpan *span, const char *stage)
+{
+    span->stage = stage;
+    span->start = traceClock();
+}
+
+
+
+/*****************************************************************
+** Function: traceEnd
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void traceEnd(TraceSpan *span, long long pixels, long long bytes)
+**              TraceSpan *span -- Stage begun by traceBegin
+**              long long pixels -- Pixels the stage went through
+**              long long bytes -- Bytes the stage went through
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Adds the stage to the timeline and to this thread's job. Once the
+** timeline is full, stages still count towards their job.
+**********************************************************************/
+void traceEnd(TraceSpan *span, long long pixels, long long bytes)
+{
+    long long end = traceClock();
+
+    if (traceThread == 0)
+    {
+        traceThread = nextThread++;
+    }
+
+    TraceEvent event;
+    event.stage = span->stage;
+    event.start = span->start;
+    event.duration = end - span->start;
+    event.thread = traceThread;
+    event.job = currentJob;
+    event.pixels = pixels;
+    event.bytes = bytes;
+
+    lock_guard<mutex> guard(traceLock);
+    if (traceEvents.size() < MAX_TRACE_EVENTS)
+    {
+        traceEvents.push_back(event);
+    }
+    else
+    {
+        droppedEvents++;
+    }
+
+    map<long long, JobTrace>::iterator trace = activeJobs.find(currentJob);
+    if (trace == activeJobs.end())
+    {
+        return;
+    }
+
+    vector<StageTotal> &stages = trace->second.stages;
+    size_t i = 0;
+    while (i < stages.size() && strcmp(stages[i].stage, span->stage) != 0)
+    {
+        i++;
+    }
+
+    if (i == stages.size())
+    {
+        StageTotal total = {span->stage, 0, 0, 0};
+        stages.push_back(total);
+    }
+
+    stages[i].duration += event.duration;
+    stages[i].pixels += pixels;
+    stages[i].bytes += bytes;
+}
+
+
+
+/*****************************************************************
+** Function: traceWriteChrome
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool traceWriteChrome(const string &path)
+**              const string &path -- File to write
+**
+**
+** Returns:
+**			bool -- False if the file could not be written
+**
+** Notes:
+** Writes the timeline in the Chrome trace event format, one complete
+** ("X") event per stage with its job, pixels and bytes as arguments.
+**********************************************************************/
+bool traceWriteChrome(const string &path)
+{
+    ofstream out(path.c_str());
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    lock_guard<mutex> guard(traceLock);
+
+    out << "{\"traceEvents\":[";
+    char times[96];
+    for (size_t i = 0; i < traceEvents.size(); i++)
+    {
+        const TraceEvent &event = traceEvents[i];
+        map<long long, string>::const_iterator label = jobLabels.find(event.job);
+
+        snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", event.start / 1e3, event.duration / 1e3);
+        out << (i ? ",\n" : "\n")
+            << "{\"name\":\"" << event.stage << "\",\"cat\":\"stego\",\"ph\":\"X\"," << times
+            << ",\"pid\":1,\"tid\":" << event.thread
+            << ",\"args\":{\"job\":" << event.job
+            << ",\"label\":\"" << ((label != jobLabels.end()) ? escapeJson(label->second) : "") << "\""
+            << ",\"pixels\":" << event.pixels
+            << ",\"bytes\":" << event.bytes << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}\n";
+
+    return (bool) out;
+}
+
+
+
+/*****************************************************************
+** Function: traceClock
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long traceClock()
+**
+**
+** Returns:
+**			long long -- Nanoseconds since the program started
+**********************************************************************/
+static long long traceClock()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - traceEpoch).count();
+}
+
+
+
+/*****************************************************************
+** Function: escapeJson
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string escapeJson(const string &text)
+**              const string &text -- Text to put in a JSON string
+**
+**
+** Returns:
+**			string -- The text with quotes, backslashes and control characters escaped
+**********************************************************************/
+static string escapeJson(const string &text)
+{
+    string escaped;
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        unsigned char c = (unsigned char) text[i];
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += (char) c;
+        }
+        else if (c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else
+        {
+            escaped += (char) c;
+        }
+    }
+
+    return escaped;
+}
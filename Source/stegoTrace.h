@@ -0,0 +1,37 @@
+#ifndef STEGOTRACE_H
+#define STEGOTRACE_H
+
+#include <string>
+
+#define MAX_TRACE_EVENTS 200000
+
+//stages a job is broken into
+#define STAGE_DECODE "decode"
+#define STAGE_PREPARE "prepare"
+#define STAGE_DETECT "detect"
+#define STAGE_COST_MAP "cost_map"
+#define STAGE_HEADER_ENCODE "header_encode"
+#define STAGE_HEADER_DECODE "header_decode"
+#define STAGE_SECRET_READ "secret_read"
+#define STAGE_EMBED "embed"
+#define STAGE_EXTRACT "extract"
+#define STAGE_FEC_ENCODE "fec_encode"
+#define STAGE_FEC_DECODE "fec_decode"
+#define STAGE_SECRET_WRITE "secret_write"
+#define STAGE_ENCODE "encode"
+#define STAGE_FILE_WRITE "file_write"
+
+//a stage that has begun on the calling thread
+struct TraceSpan
+{
+    const char *stage;
+    long long start;            //nanoseconds on the trace clock
+};
+
+long long traceStartJob(const std::string &);
+std::string traceFinishJob();
+void traceBegin(TraceSpan *, const char *);
+void traceEnd(TraceSpan *, long long, long long);
+bool traceWriteChrome(const std::string &);
+
+#endif // STEGOTRACE_H
@@ -0,0 +1,1387 @@
+/**********************************************************************
+**	SOURCE FILE:	tiledImageItem.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    TiledImageItem(const QImage *, QGraphicsItem *parent = 0)
+**    ~TiledImageItem()
+**    QRectF boundingRect() const
+**    void paint(QPainter *, const QStyleOptionGraphicsItem *, QWidget *)
+**    void refreshRows(int, int)
+**    void setView(const ViewSettings &)
+**    void setReference(const QImage *)
+**    void addLevel(int, int, QImage)
+**    void addTile(int, quint64, QImage)
+**    void buildLevels(TiledImageItem *, int, QImage, int)
+**    void halveBand(const QImage &, QImage *, int, int)
+**    void renderTile(TiledImageItem *, TileRender)
+**    QImage sampleArea(const QImage &, const QRect &, int)
+**    bool buildHeatRamp()
+**    void startBuild()
+**    void cancelBuild()
+**    int chooseLevel(qreal) const
+**    const QImage *levelImage(int) const
+**    QSize levelSize(int) const
+**    quint64 tileKey(int, int, int) const
+**    QPixmap *fetchTile(int, int, int)
+**    void startRender(int, int, int, quint64)
+**    int countTiles(int, const QRectF &) const
+**    void dropTileRows(int, int, int)
+**    void dropViewTiles(int, int)
+**    void drawLevel(QPainter *, int, const QRectF &)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Graphics item that displays a carrier image from a tile pyramid.
+** Downsampled levels are built on a background thread and only the
+** tiles that are visible at the current zoom are turned into pixmaps.
+** Pixmaps live in a cache with a fixed memory limit so very large
+** carriers never need one giant pixmap. When only some rows of the
+** image change, only the tiles and level rows covering them are redone.
+**
+** Instead of the image, the item can show one bit plane of it, its
+** difference from a reference image (the carrier before the secret
+** went in) or a heatmap of where the two differ, all amplified so
+** single bit changes can be seen. The tiles of these views are
+** sampled straight from the source at the zoom they are drawn at,
+** rendered on worker threads and kept in the same cache as the image
+** tiles, keyed by the view, so going back to a view already seen does
+** not render it again.
+*************************************************************************/
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtConcurrent/QtConcurrentRun>
+#include "tiledImageItem.h"
+#include "imageStego.h"
+
+using namespace std;
+
+static bool buildHeatRamp();
+
+//colours of the heatmap, from nothing changed to every channel changed
+static QRgb heatRamp[256];
+static bool heatRampBuilt = buildHeatRamp();
+
+
+/*****************************************************************
+** Function: TiledImageItem
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          TiledImageItem(const QImage *image, QGraphicsItem *parent)
+**            const QImage *image -- Full resolution image to display
+**            QGraphicsItem *parent -- Parent item (if any)
+**
+** Returns: N/A (Constructor)
+**
+** Notes:
+** The image is not copied; it must stay alive for as long as the
+** item is in the scene. Building of the downsampled levels starts
+** right away.
+**********************************************************************/
+TiledImageItem::TiledImageItem(const QImage *image, QGraphicsItem *parent) : QGraphicsObject(parent)
+{
+    source = image;
+    generation = 0;
+    numLevels = 1;
+
+    view.mode = VIEW_IMAGE;
+    view.channel = VIEW_ALL_CHANNELS;
+    view.bit = 0;
+    view.gain = 255;
+    reference = 0;
+    renderGeneration = 0;
+
+    //keep halving until the whole image fits in one tile
+    int longestSide = qMax(source->width(), source->height());
+    while (longestSide > TILE_SIZE)
+    {
+        longestSide /= 2;
+        numLevels++;
+    }
+
+    //cost of the cache is measured in KB
+    tileCache.setMaxCost(MAX_TILE_CACHE_KB);
+
+    //we only ever draw the part of the item that is exposed
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    startBuild();
+}
+
+
+
+/*****************************************************************
+** Function: ~TiledImageItem
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          ~TiledImageItem()
+**
+** Returns: N/A (Destructor)
+**
+** Notes:
+** Stops any level building that is still running before the item
+** goes away and waits for the tiles being rendered.
+**********************************************************************/
+TiledImageItem::~TiledImageItem()
+{
+    cancelBuild();
+
+    //renders call back into the item, so they have to be done first
+    for (int i = 0; i < renders.size(); i++)
+    {
+        renders[i].waitForFinished();
+    }
+}
+
+
+
+/*****************************************************************
+** Function: boundingRect
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QRectF boundingRect() const
+**
+** Returns:
+**          QRectF -- Area of the full resolution image
+**
+** Notes:
+** The item is always laid out in full resolution coordinates no
+** matter which level is being drawn.
+**********************************************************************/
+QRectF TiledImageItem::boundingRect() const
+{
+    return QRectF(source->rect());
+}
+
+
+
+/*****************************************************************
+** Function: paint
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+**            QPainter *painter -- Painter of the view
+**            const QStyleOptionGraphicsItem *option -- Exposed area and transform
+**            QWidget *widget -- Widget being painted on (unused)
+**
+** Returns: void
+**
+** Notes:
+** Picks the level that matches the current zoom. If that level has
+** not been built yet, a finer level is used as long as only a few
+** tiles are needed, otherwise a placeholder is drawn until the level
+** is ready. Views other than the image never wait for a level.
+**********************************************************************/
+void TiledImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if (exposed.isEmpty())
+    {
+        return;
+    }
+
+    int wanted = chooseLevel(option->levelOfDetailFromTransform(painter->worldTransform()));
+    int level = wanted;
+
+    //views are sampled straight from the source at any level
+    if (view.mode != VIEW_IMAGE)
+    {
+        drawLevel(painter, level, exposed);
+        return;
+    }
+
+    //fall back to the closest finer level that is ready
+    while (level > 0 && levelImage(level) == 0)
+    {
+        level--;
+    }
+
+    if (level != wanted && countTiles(level, exposed) > MAX_FALLBACK_TILES)
+    {
+        painter->fillRect(exposed, Qt::lightGray);
+        return;
+    }
+
+    if (level > 0)
+    {
+        painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    }
+
+    drawLevel(painter, level, exposed);
+}
+
+
+
+/*****************************************************************
+** Function: refreshRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void refreshRows(int firstRow, int lastRow)
+**            int firstRow -- First row of the source that changed
+**            int lastRow -- Last row of the source that changed
+**
+** Returns: void
+**
+** Notes:
+** Updates the display after some rows of the source were changed.
+** The rows are pushed down through every built level and only the
+** tiles covering them are thrown away, so the cost depends on how
+** many rows changed rather than on the size of the image. Tiles of
+** the other views over the rows are rendered again when next drawn.
+**********************************************************************/
+void TiledImageItem::refreshRows(int firstRow, int lastRow)
+{
+    firstRow = qMax(0, firstRow);
+    lastRow = qMin(source->height() - 1, lastRow);
+    if (firstRow > lastRow)
+    {
+        return;
+    }
+
+    dropViewTiles(firstRow, lastRow);
+
+    //levels that are still being built (or not handed over yet) would
+    //miss the change, so start over in that case
+    bool complete = !builder.isRunning();
+    for (int level = 1; level < numLevels; level++)
+    {
+        if (levels[level].isNull())
+        {
+            complete = false;
+        }
+    }
+
+    if (!complete)
+    {
+        startBuild();
+        update();
+        return;
+    }
+
+    dropTileRows(0, firstRow, lastRow);
+
+    for (int level = 1; level < numLevels; level++)
+    {
+        firstRow /= 2;
+        lastRow = qMin(levels[level].height() - 1, lastRow / 2);
+
+        if (firstRow > lastRow)
+        {
+            break;
+        }
+
+        halveBand(*levelImage(level - 1), &levels[level], firstRow, lastRow);
+        dropTileRows(level, firstRow, lastRow);
+    }
+
+    update();
+}
+
+
+
+/*****************************************************************
+** Function: setView
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setView(const ViewSettings &settings)
+**            const ViewSettings &settings -- What to show of the image
+**
+** Returns: void
+**
+** Notes:
+** Settings a mode does not use are left out, so views that look the
+** same share their tiles. Tiles of the views stay cached, so switching
+** back and forth only renders what has not been seen yet.
+**********************************************************************/
+void TiledImageItem::setView(const ViewSettings &settings)
+{
+    ViewSettings next = settings;
+
+    if (next.mode == VIEW_IMAGE)
+    {
+        next.channel = VIEW_ALL_CHANNELS;
+    }
+
+    if (next.mode != VIEW_BIT_PLANE)
+    {
+        next.bit = 0;
+    }
+
+    //the gain is not part of the tile keys
+    if (next.gain != view.gain)
+    {
+        dropViewTiles(0, source->height() - 1);
+    }
+
+    view = next;
+    update();
+}
+
+
+
+/*****************************************************************
+** Function: setReference
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void setReference(const QImage *image)
+**            const QImage *image -- Image the source is compared to, or 0
+**
+** Returns: void
+**
+** Notes:
+** The image is not copied; it must stay alive for as long as it is
+** the reference. Without a reference (or one of another size) the
+** difference and heatmap views show no changes.
+**********************************************************************/
+void TiledImageItem::setReference(const QImage *image)
+{
+    reference = image;
+    dropViewTiles(0, source->height() - 1);
+    update();
+}
+
+
+
+/*****************************************************************
+** Function: addLevel
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void addLevel(int gen, int level, QImage image)
+**            int gen -- Build generation the level belongs to
+**            int level -- Level number
+**            QImage image -- Downsampled image for the level
+**
+** Returns: void
+**
+** Notes:
+** Called on the GUI thread whenever the background build finishes a
+** level. Levels from an older build are thrown away.
+**********************************************************************/
+void TiledImageItem::addLevel(int gen, int level, QImage image)
+{
+    if (gen != generation || level >= numLevels)
+    {
+        return;
+    }
+
+    levels[level] = image;
+    update();
+}
+
+
+
+/*****************************************************************
+** Function: addTile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void addTile(int gen, quint64 key, QImage image)
+**            int gen -- Render generation the tile belongs to
+**            quint64 key -- Cache key of the tile
+**            QImage image -- Rendered tile
+**
+** Returns: void
+**
+** Notes:
+** Called on the GUI thread whenever a tile of a view is rendered.
+** Tiles rendered before the source or reference changed are thrown
+** away.
+**********************************************************************/
+void TiledImageItem::addTile(int gen, quint64 key, QImage image)
+{
+    if (gen != renderGeneration)
+    {
+        return;
+    }
+
+    rendering.remove(key);
+
+    QPixmap *tile = new QPixmap(QPixmap::fromImage(image));
+    tileCache.insert(key, tile, qMax(1, (tile->width() * tile->height() * 4) / 1024));
+    update();
+}
+
+
+
+/*****************************************************************
+** Function: buildLevels
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void buildLevels(TiledImageItem *item, int gen, QImage base, int count)
+**            TiledImageItem *item -- Item to hand the levels to
+**            int gen -- Build generation
+**            QImage base -- Full resolution image (shallow copy)
+**            int count -- Total number of levels
+**
+** Returns: void
+**
+** Notes:
+** Runs on a worker thread. Each level is made by halving the level
+** before it and is passed back to the GUI thread as soon as it is
+** done, so the view can start using coarse levels early.
+**********************************************************************/
+void TiledImageItem::buildLevels(TiledImageItem *item, int gen, QImage base, int count)
+{
+    QImage previous = base;
+
+    for (int level = 1; level < count; level++)
+    {
+        QImage next(qMax(1, previous.width() / 2), qMax(1, previous.height() / 2), QImage::Format_ARGB32_Premultiplied);
+
+        //work in bands so a cancel does not have to wait for a whole level
+        for (int row = 0; row < next.height(); row += BUILD_BAND_ROWS)
+        {
+            if (item->cancelled.loadAcquire())
+            {
+                return;
+            }
+
+            halveBand(previous, &next, row, qMin(next.height(), row + BUILD_BAND_ROWS) - 1);
+        }
+
+        QMetaObject::invokeMethod(item, "addLevel", Qt::QueuedConnection,
+                                  Q_ARG(int, gen), Q_ARG(int, level), Q_ARG(QImage, next));
+
+        previous = next;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: halveBand
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void halveBand(const QImage &src, QImage *dst, int firstRow, int lastRow)
+**            const QImage &src -- Level being downsampled
+**            QImage *dst -- Half size level being written
+**            int firstRow -- First row of dst to write
+**            int lastRow -- Last row of dst to write
+**
+** Returns: void
+**
+** Notes:
+** Averages every 2x2 block of src into one pixel of dst. Only the
+** source rows under the band are converted, so carriers in any
+** format can be halved without converting the whole image first.
+** Since each destination row only depends on two source rows, a band
+** gives exactly the same pixels as halving the whole level.
+**********************************************************************/
+void TiledImageItem::halveBand(const QImage &src, QImage *dst, int firstRow, int lastRow)
+{
+    if (src.width() < 2 || src.height() < 2)
+    {
+        //nothing left to average, just shrink what is there
+        *dst = src.scaled(dst->size()).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        return;
+    }
+
+    QImage band = src.copy(0, firstRow * 2, src.width(), (lastRow - firstRow + 1) * 2)
+                     .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        const quint32 *top = (const quint32 *) band.constScanLine((row - firstRow) * 2);
+        const quint32 *bottom = (const quint32 *) band.constScanLine((row - firstRow) * 2 + 1);
+        quint32 *out = (quint32 *) dst->scanLine(row);
+
+        for (int x = 0; x < dst->width(); x++)
+        {
+            quint32 p0 = top[x * 2];
+            quint32 p1 = top[x * 2 + 1];
+            quint32 p2 = bottom[x * 2];
+            quint32 p3 = bottom[x * 2 + 1];
+
+            //add two channels at a time, each sum fits in its 16 bit half
+            quint32 redBlue = (p0 & 0x00FF00FF) + (p1 & 0x00FF00FF) + (p2 & 0x00FF00FF) + (p3 & 0x00FF00FF);
+            quint32 alphaGreen = ((p0 >> 8) & 0x00FF00FF) + ((p1 >> 8) & 0x00FF00FF)
+                               + ((p2 >> 8) & 0x00FF00FF) + ((p3 >> 8) & 0x00FF00FF);
+
+            redBlue = ((redBlue + 0x00020002) >> 2) & 0x00FF00FF;
+            alphaGreen = ((alphaGreen + 0x00020002) >> 2) & 0x00FF00FF;
+
+            out[x] = redBlue | (alphaGreen << 8);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: renderTile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void renderTile(TiledImageItem *item, TileRender job)
+**            TiledImageItem *item -- Item to hand the tile to
+**            TileRender job -- Tile to render and the images it comes from
+**
+** Returns: void
+**
+** Notes:
+** Runs on a worker thread. The tile is sampled from the source and
+** the reference and converted to the layout the secret is read from,
+** so the channel values are exactly the ones embedding changes. Palette
+** indices are compared by colour since embedding sorts the palette.
+** The heatmap colours each block of HEAT_BLOCK x HEAT_BLOCK pixels by
+** the share of its channels that changed.
+**********************************************************************/
+void TiledImageItem::renderTile(TiledImageItem *item, TileRender job)
+{
+    QImage tile = sampleArea(job.image, job.area, job.step);
+    QImage other = job.reference.isNull() ? tile : sampleArea(job.reference, job.area, job.step);
+
+    if (job.view.mode != VIEW_BIT_PLANE && tile.format() == QImage::Format_Indexed8)
+    {
+        tile = tile.convertToFormat(QImage::Format_RGB32);
+    }
+
+    PixelFormat format = carrierLayout(&tile);
+    if (other.format() != tile.format())
+    {
+        other = other.convertToFormat(tile.format());
+    }
+
+    int width = tile.width();
+    int height = tile.height();
+    int numChannels = channelsInFormat(format);
+    long count = (long) width * numChannels;
+
+    vector<unsigned short> samples(count);
+    vector<unsigned short> others(count);
+    vector<unsigned char> values(count);
+
+    //a single channel image only has the one channel to show
+    int channel = (numChannels == 1) ? 0 : job.view.channel;
+    int firstChannel = (channel == VIEW_ALL_CHANNELS) ? 0 : channel;
+    int lastChannel = (channel == VIEW_ALL_CHANNELS) ? numChannels - 1 : channel;
+
+    int numBlocks = (width + HEAT_BLOCK - 1) / HEAT_BLOCK;
+    vector<int> changes(numBlocks, 0);
+    vector<QRgb> colours(numBlocks);
+
+    QImage result(width, height, QImage::Format_RGB32);
+
+    for (int y = 0; y < height; y++)
+    {
+        readScanlineSamples(tile.constScanLine(y), width, format, samples.data());
+
+        if (job.view.mode == VIEW_BIT_PLANE)
+        {
+            bitPlaneSamples(samples.data(), count, job.view.bit, values.data());
+        }
+        else
+        {
+            readScanlineSamples(other.constScanLine(y), width, format, others.data());
+
+            //for the heatmap any change counts the same
+            differenceSamples(samples.data(), others.data(), count,
+                              (job.view.mode == VIEW_HEATMAP) ? 255 : job.view.gain, values.data());
+        }
+
+        if (job.view.mode != VIEW_HEATMAP)
+        {
+            QRgb *out = (QRgb *) result.scanLine(y);
+            for (int x = 0; x < width; x++)
+            {
+                const unsigned char *pixel = &values[(long) x * numChannels];
+
+                if (channel == VIEW_ALL_CHANNELS)
+                {
+                    out[x] = qRgb(pixel[0], pixel[1], pixel[2]);
+                }
+                else
+                {
+                    out[x] = qRgb(pixel[channel], pixel[channel], pixel[channel]);
+                }
+            }
+            continue;
+        }
+
+        for (int x = 0; x < width; x++)
+        {
+            for (int c = firstChannel; c <= lastChannel; c++)
+            {
+                changes[x / HEAT_BLOCK] += (values[(long) x * numChannels + c] != 0);
+            }
+        }
+
+        //colour a row of blocks once its last row is counted
+        if ((y + 1) % HEAT_BLOCK != 0 && y != height - 1)
+        {
+            continue;
+        }
+
+        int top = y - y % HEAT_BLOCK;
+        for (int block = 0; block < numBlocks; block++)
+        {
+            int total = qMin(HEAT_BLOCK, width - block * HEAT_BLOCK) * (y - top + 1) * (lastChannel - firstChannel + 1);
+
+            //round up so a single change still shows
+            colours[block] = heatRamp[(changes[block] * 255 + total - 1) / total];
+            changes[block] = 0;
+        }
+
+        for (int row = top; row <= y; row++)
+        {
+            QRgb *out = (QRgb *) result.scanLine(row);
+            for (int x = 0; x < width; x++)
+            {
+                out[x] = colours[x / HEAT_BLOCK];
+            }
+        }
+    }
+
+    QMetaObject::invokeMethod(item, "addTile", Qt::QueuedConnection,
+                              Q_ARG(int, job.generation), Q_ARG(quint64, job.key), Q_ARG(QImage, result));
+}
+
+
+
+/*****************************************************************
+** Function: sampleArea
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QImage sampleArea(const QImage &image, const QRect &area, int step)
+**            const QImage &image -- Full resolution image
+**            const QRect &area -- Area in the coordinates of a level
+**            int step -- Pixels of the image per pixel of the level
+**
+** Returns:
+**          QImage -- Every step-th pixel of the area, in the image's format
+**
+** Notes:
+** Pixels are picked rather than averaged since an average of bit
+** planes means nothing. Only the pixels picked are read, so the cost
+** is the same at any zoom. 1 bit images come back as palette indices.
+**********************************************************************/
+QImage TiledImageItem::sampleArea(const QImage &image, const QRect &area, int step)
+{
+    if (image.depth() < 8)
+    {
+        QImage tile(area.size(), QImage::Format_Indexed8);
+        tile.setColorTable(image.colorTable());
+
+        for (int y = 0; y < area.height(); y++)
+        {
+            unsigned char *out = tile.scanLine(y);
+            for (int x = 0; x < area.width(); x++)
+            {
+                out[x] = (unsigned char) image.pixelIndex((area.left() + x) * step, (area.top() + y) * step);
+            }
+        }
+        return tile;
+    }
+
+    if (step == 1)
+    {
+        return image.copy(area);
+    }
+
+    int pixelSize = image.depth() / 8;
+    QImage tile(area.size(), image.format());
+    tile.setColorTable(image.colorTable());
+
+    for (int y = 0; y < area.height(); y++)
+    {
+        const unsigned char *line = image.constScanLine((area.top() + y) * step);
+        unsigned char *out = tile.scanLine(y);
+
+        for (int x = 0; x < area.width(); x++)
+        {
+            memcpy(out + x * pixelSize, line + (long) (area.left() + x) * step * pixelSize, pixelSize);
+        }
+    }
+
+    return tile;
+}
+
+
+
+/*****************************************************************
+** Function: buildHeatRamp
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool buildHeatRamp()
+**
+** Returns:
+**          bool -- Always true, the ramp is built when the program loads
+**
+** Notes:
+** Black for no change, then dark blue up through red to yellow.
+**********************************************************************/
+static bool buildHeatRamp()
+{
+    heatRamp[0] = qRgb(0, 0, 0);
+
+    for (int i = 1; i < 256; i++)
+    {
+        if (i <= 85)
+        {
+            heatRamp[i] = qRgb(0, 0, 64 + (i * 191) / 85);
+        }
+        else if (i <= 170)
+        {
+            heatRamp[i] = qRgb(((i - 85) * 255) / 85, 0, 255 - ((i - 85) * 255) / 85);
+        }
+        else
+        {
+            heatRamp[i] = qRgb(255, ((i - 170) * 255) / 85, 0);
+        }
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: startBuild
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void startBuild()
+**
+** Returns: void
+**
+** Notes:
+** Throws away all levels and tiles and starts building the levels
+** again from the source image.
+**********************************************************************/
+void TiledImageItem::startBuild()
+{
+    cancelBuild();
+
+    generation++;
+    levels.fill(QImage(), numLevels);
+    tileCache.clear();
+
+    //tiles of views being rendered would land in the empty cache
+    renderGeneration++;
+    rendering.clear();
+
+    if (numLevels > 1)
+    {
+        cancelled.storeRelease(0);
+        builder = QtConcurrent::run(buildLevels, this, generation, *source, numLevels);
+    }
+}
+
+
+
+/*****************************************************************
+** Function: cancelBuild
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void cancelBuild()
+**
+** Returns: void
+**
+** Notes:
+** Asks the background build to stop and waits for it.
+**********************************************************************/
+void TiledImageItem::cancelBuild()
+{
+    cancelled.storeRelease(1);
+    builder.waitForFinished();
+}
+
+
+
+/*****************************************************************
+** Function: chooseLevel
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int chooseLevel(qreal detail) const
+**            qreal detail -- Screen pixels per image pixel
+**
+** Returns:
+**          int -- Level that best matches the zoom
+**
+** Notes:
+** A level is used while it has at least one image pixel for every
+** screen pixel.
+**********************************************************************/
+int TiledImageItem::chooseLevel(qreal detail) const
+{
+    if (detail >= 1.0 || detail <= 0.0)
+    {
+        return 0;
+    }
+
+    int level = (int) floor(log2(1.0 / detail));
+    return qBound(0, level, numLevels - 1);
+}
+
+
+
+/*****************************************************************
+** Function: levelImage
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          const QImage *levelImage(int level) const
+**            int level -- Level to fetch
+**
+** Returns:
+**          const QImage * -- Image of the level or 0 if it is not built yet
+**********************************************************************/
+const QImage *TiledImageItem::levelImage(int level) const
+{
+    if (level == 0)
+    {
+        return source;
+    }
+
+    if (levels[level].isNull())
+    {
+        return 0;
+    }
+
+    return &levels[level];
+}
+
+
+
+/*****************************************************************
+** Function: levelSize
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QSize levelSize(int level) const
+**            int level -- Level to measure
+**
+** Returns:
+**          QSize -- Size of the level, whether it is built or not
+**********************************************************************/
+QSize TiledImageItem::levelSize(int level) const
+{
+    QSize size = source->size();
+
+    //halved the same way the levels are built
+    for (int i = 0; i < level; i++)
+    {
+        size = QSize(qMax(1, size.width() / 2), qMax(1, size.height() / 2));
+    }
+
+    return size;
+}
+
+
+
+/*****************************************************************
+** Function: tileKey
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          quint64 tileKey(int level, int col, int row) const
+**            int level -- Level of the tile
+**            int col -- Column of the tile
+**            int row -- Row of the tile
+**
+** Returns:
+**          quint64 -- Cache key of the tile in the current view
+**
+** Notes:
+** The top byte holds the view, which is 0 for the image itself.
+**********************************************************************/
+quint64 TiledImageItem::tileKey(int level, int col, int row) const
+{
+    quint64 viewKey = 0;
+    if (view.mode != VIEW_IMAGE)
+    {
+        viewKey = (quint64) view.mode | ((quint64) (view.channel + 1) << 2) | ((quint64) view.bit << 4);
+    }
+
+    return (viewKey << 56) | ((quint64) level << 48) | ((quint64) row << 24) | (quint64) col;
+}
+
+
+
+/*****************************************************************
+** Function: fetchTile
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          QPixmap *fetchTile(int level, int col, int row)
+**            int level -- Level of the tile
+**            int col -- Column of the tile
+**            int row -- Row of the tile
+**
+** Returns:
+**          QPixmap * -- Pixmap of the tile, owned by the cache, or 0 while
+**                       a tile of a view is being rendered
+**
+** Notes:
+** Tiles are only uploaded as pixmaps the first time they are seen.
+** The pointer is only good until the next tile is fetched since the
+** cache may evict it. Tiles of the other views are rendered in the
+** background and show up once they are done.
+**********************************************************************/
+QPixmap *TiledImageItem::fetchTile(int level, int col, int row)
+{
+    quint64 key = tileKey(level, col, row);
+
+    QPixmap *tile = tileCache.object(key);
+    if (tile == 0 && view.mode != VIEW_IMAGE)
+    {
+        startRender(level, col, row, key);
+    }
+    else if (tile == 0)
+    {
+        const QImage *image = levelImage(level);
+        QRect area = QRect(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE).intersected(image->rect());
+
+        tile = new QPixmap(QPixmap::fromImage(image->copy(area)));
+        int cost = qMax(1, (tile->width() * tile->height() * 4) / 1024);
+
+        //the cache owns the pixmap from here on
+        tileCache.insert(key, tile, cost);
+        tile = tileCache.object(key);
+    }
+
+    return tile;
+}
+
+
+
+/*****************************************************************
+** Function: startRender
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void startRender(int level, int col, int row, quint64 key)
+**            int level -- Level of the tile
+**            int col -- Column of the tile
+**            int row -- Row of the tile
+**            quint64 key -- Cache key of the tile
+**
+** Returns: void
+**
+** Notes:
+** Hands the tile of the current view to the thread pool, unless it is
+** already being rendered. The workers get shallow copies of the images,
+** so an embed that changes the source while they run does not touch
+** what they read.
+**********************************************************************/
+void TiledImageItem::startRender(int level, int col, int row, quint64 key)
+{
+    if (rendering.contains(key))
+    {
+        return;
+    }
+
+    TileRender job;
+    job.generation = renderGeneration;
+    job.key = key;
+    job.area = QRect(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+                   .intersected(QRect(QPoint(0, 0), levelSize(level)));
+    job.step = 1 << level;
+    job.view = view;
+    job.image = *source;
+
+    if (reference != 0 && reference->size() == source->size())
+    {
+        job.reference = *reference;
+    }
+
+    //forget the renders that are done
+    for (int i = renders.size() - 1; i >= 0; i--)
+    {
+        if (renders[i].isFinished())
+        {
+            renders.removeAt(i);
+        }
+    }
+
+    rendering.insert(key);
+    renders.append(QtConcurrent::run(renderTile, this, job));
+}
+
+
+
+/*****************************************************************
+** Function: countTiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int countTiles(int level, const QRectF &area) const
+**            int level -- Level being drawn
+**            const QRectF &area -- Area in full resolution coordinates
+**
+** Returns:
+**          int -- Number of tiles needed to cover the area
+**********************************************************************/
+int TiledImageItem::countTiles(int level, const QRectF &area) const
+{
+    int tileSpan = TILE_SIZE << level;
+
+    int cols = (int) floor((area.right() - 1) / tileSpan) - (int) floor(area.left() / tileSpan) + 1;
+    int rows = (int) floor((area.bottom() - 1) / tileSpan) - (int) floor(area.top() / tileSpan) + 1;
+
+    return cols * rows;
+}
+
+
+
+/*****************************************************************
+** Function: dropTileRows
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void dropTileRows(int level, int firstRow, int lastRow)
+**            int level -- Level the rows belong to
+**            int firstRow -- First changed row of the level
+**            int lastRow -- Last changed row of the level
+**
+** Returns: void
+**
+** Notes:
+** Removes the cached tiles that cover the rows so they are uploaded
+** again the next time they are drawn.
+**********************************************************************/
+void TiledImageItem::dropTileRows(int level, int firstRow, int lastRow)
+{
+    int numCols = (levelImage(level)->width() + TILE_SIZE - 1) / TILE_SIZE;
+
+    for (int row = firstRow / TILE_SIZE; row <= lastRow / TILE_SIZE; row++)
+    {
+        for (int col = 0; col < numCols; col++)
+        {
+            tileCache.remove(((quint64) level << 48) | ((quint64) row << 24) | (quint64) col);
+        }
+    }
+}
+
+
+
+/*****************************************************************
+** Function: dropViewTiles
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void dropViewTiles(int firstRow, int lastRow)
+**            int firstRow -- First changed row of the source
+**            int lastRow -- Last changed row of the source
+**
+** Returns: void
+**
+** Notes:
+** Removes the cached tiles of every view other than the image that
+** cover the rows, at any level. Tiles still being rendered may have
+** read the old rows, so they are thrown away when they arrive.
+**********************************************************************/
+void TiledImageItem::dropViewTiles(int firstRow, int lastRow)
+{
+    QList<quint64> keys = tileCache.keys();
+
+    for (int i = 0; i < keys.size(); i++)
+    {
+        if ((keys[i] >> 56) == 0)
+        {
+            continue;
+        }
+
+        int level = (int) ((keys[i] >> 48) & 0xFF);
+        qint64 row = (qint64) ((keys[i] >> 24) & 0xFFFFFF);
+        qint64 top = (row * TILE_SIZE) << level;
+        qint64 bottom = (((row + 1) * TILE_SIZE) << level) - 1;
+
+        if (top <= lastRow && bottom >= firstRow)
+        {
+            tileCache.remove(keys[i]);
+        }
+    }
+
+    renderGeneration++;
+    rendering.clear();
+}
+
+
+
+/*****************************************************************
+** Function: drawLevel
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void drawLevel(QPainter *painter, int level, const QRectF &area)
+**            QPainter *painter -- Painter of the view
+**            int level -- Level to draw from
+**            const QRectF &area -- Area in full resolution coordinates
+**
+** Returns: void
+**
+** Notes:
+** Draws every tile of the level that touches the area, scaled back
+** up into full resolution coordinates. Tiles that are not ready yet
+** are drawn as a placeholder.
+**********************************************************************/
+void TiledImageItem::drawLevel(QPainter *painter, int level, const QRectF &area)
+{
+    QSize size = levelSize(level);
+
+    //levels are rounded down when halved so work out the exact scale
+    qreal scaleX = (qreal) source->width() / size.width();
+    qreal scaleY = (qreal) source->height() / size.height();
+
+    int firstCol = qMax(0, (int) floor(area.left() / scaleX / TILE_SIZE));
+    int lastCol = qMin((size.width() - 1) / TILE_SIZE, (int) floor(area.right() / scaleX / TILE_SIZE));
+    int firstRow = qMax(0, (int) floor(area.top() / scaleY / TILE_SIZE));
+    int lastRow = qMin((size.height() - 1) / TILE_SIZE, (int) floor(area.bottom() / scaleY / TILE_SIZE));
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int col = firstCol; col <= lastCol; col++)
+        {
+            QRect tileArea = QRect(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+                                 .intersected(QRect(QPoint(0, 0), size));
+            QRectF target(tileArea.x() * scaleX, tileArea.y() * scaleY,
+                          tileArea.width() * scaleX, tileArea.height() * scaleY);
+
+            QPixmap *tile = fetchTile(level, col, row);
+            if (tile == 0)
+            {
+                painter->fillRect(target, Qt::lightGray);
+                continue;
+            }
+
+            painter->drawPixmap(target, *tile, QRectF(tile->rect()));
+        }
+    }
+}
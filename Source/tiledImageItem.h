@@ -0,0 +1,106 @@
+#ifndef TILEDIMAGEITEM_H
+#define TILEDIMAGEITEM_H
+
+#include <QGraphicsObject>
+#include <QImage>
+#include <QPixmap>
+#include <QCache>
+#include <QVector>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QList>
+#include <QSet>
+
+#define TILE_SIZE 256
+#define MAX_TILE_CACHE_KB (96 * 1024)
+#define MAX_FALLBACK_TILES 64
+#define BUILD_BAND_ROWS 64
+#define HEAT_BLOCK 8
+#define VIEW_ALL_CHANNELS -1
+
+//what the item shows of the image
+enum ViewMode
+{
+    VIEW_IMAGE,         //the image itself
+    VIEW_BIT_PLANE,     //one bit position of the channels, amplified
+    VIEW_DIFFERENCE,    //amplified difference from the reference image
+    VIEW_HEATMAP        //share of changed channels in each block
+};
+
+struct ViewSettings
+{
+    ViewMode mode;
+    int channel;        //channel shown, or VIEW_ALL_CHANNELS
+    int bit;            //bit position of VIEW_BIT_PLANE
+    int gain;           //amplification of VIEW_DIFFERENCE (1 to 255)
+};
+
+//one tile of a view, rendered on a worker thread
+struct TileRender
+{
+    int generation;
+    quint64 key;
+    QRect area;         //tile in the coordinates of its level
+    int step;           //source pixels between the samples of the tile
+    ViewSettings view;
+    QImage image;
+    QImage reference;
+};
+
+class TiledImageItem : public QGraphicsObject
+{
+    Q_OBJECT
+
+public:
+    TiledImageItem(const QImage *, QGraphicsItem *parent = 0);
+    ~TiledImageItem();
+
+    QRectF boundingRect() const;
+    void paint(QPainter *, const QStyleOptionGraphicsItem *, QWidget *);
+    void refreshRows(int, int);
+    void setView(const ViewSettings &);
+    void setReference(const QImage *);
+
+private slots:
+    void addLevel(int, int, QImage);
+    void addTile(int, quint64, QImage);
+
+private:
+    static void buildLevels(TiledImageItem *, int, QImage, int);
+    static void halveBand(const QImage &, QImage *, int, int);
+    static void renderTile(TiledImageItem *, TileRender);
+    static QImage sampleArea(const QImage &, const QRect &, int);
+    void startBuild();
+    void cancelBuild();
+    int chooseLevel(qreal) const;
+    const QImage *levelImage(int) const;
+    QSize levelSize(int) const;
+    quint64 tileKey(int, int, int) const;
+    QPixmap *fetchTile(int, int, int);
+    void startRender(int, int, int, quint64);
+    int countTiles(int, const QRectF &) const;
+    void dropTileRows(int, int, int);
+    void dropViewTiles(int, int);
+    void drawLevel(QPainter *, int, const QRectF &);
+
+    //full resolution image, owned by the main window
+    const QImage *source;
+
+    //downsampled levels, each level is half the size of the one before it
+    //(index 0 is unused since level 0 is the source itself)
+    QVector<QImage> levels;
+    QCache<quint64, QPixmap> tileCache;
+    QFuture<void> builder;
+    QAtomicInt cancelled;
+    int generation;
+    int numLevels;
+
+    //view of the image and the tiles of it being rendered
+    ViewSettings view;
+    const QImage *reference;
+    QSet<quint64> rendering;
+    QList<QFuture<void> > renders;
+    int renderGeneration;
+};
+
+#endif // TILEDIMAGEITEM_H
@@ -0,0 +1,1116 @@
+/**********************************************************************
+**	SOURCE FILE:	y4mStego.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+** bool y4mIsCarrier(const string &)
+** long long y4mJobMemory(const string &)
+** long long y4mCapacity(const string &, const BitMask *, int)
+** int y4mEmbed(const string &, const string &, const BitMask *, int, const string &, long long,
+**              StegoReader, void *)
+** int y4mReadHeader(const string &, const BitMask *, int, SecretHeader *)
+** int y4mExtractStream(const string &, const BitMask *, int, const SecretHeader *, StegoWriter, void *)
+** bool openStream(Y4mStream *, const string &)
+** void closeStream(Y4mStream *)
+** bool readLine(FILE *, string *)
+** int readFrame(Y4mStream *, Y4mFrame *)
+** bool writeFrame(FILE *, const Y4mFrame *)
+** long long frameBytes(const Y4mStream *, const BitMask *, int)
+** long long countFrames(const Y4mStream *, const string &)
+** bool fillPayload(Y4mPayload *, unsigned char *, long)
+** void embedFrame(const Y4mStream *, const BitMask *, int, Y4mFrame *)
+** void retrieveFrame(const Y4mStream *, const BitMask *, int, Y4mFrame *)
+** bool checkArguments(const BitMask *, int)
+** int framesInFlight()
+**
+**
+**	DATE:       October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Embeds a secret across the frames of a raw Y4M (YUV4MPEG2) video,
+** streaming the file through rather than holding it, so a carrier and
+** a secret of several gigabytes go through at the speed of the disk.
+**
+** Each plane of a frame is worked on as one long 8 bit grayscale
+** scanline with the usual bit mask, the luma plane first and then the
+** two chroma planes, whichever of them are chosen. Every frame holds
+** the same whole number of bytes of the secret; the few slots at the
+** end of a frame that do not make up a byte are left alone. The
+** header is the same name and size as stegoCore writes, with no
+** options.
+**
+** The frames are read in order into a ring of at most Y4M_MAX_FRAMES
+** buffers. Each one is embedded (or retrieved) on a thread of its own
+** while the next ones are read, and a buffer is written out, in frame
+** order, before it is read into again.
+*************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "y4mStego.h"
+#include "stegoTrace.h"
+
+using namespace std;
+
+//layout of the frames of a Y4M stream
+struct Y4mStream
+{
+    FILE *file;
+    string header;                  //stream header, newline included
+    int width;
+    int height;
+    int numPlanes;                  //1 for mono, otherwise 3
+    long planeSize[3];              //samples in each plane
+    long frameSize;                 //bytes of the planes of a frame
+};
+
+//a frame in the ring
+struct Y4mFrame
+{
+    string header;                  //frame header, newline included
+    vector<unsigned char> planes;
+    vector<unsigned char> payload;  //bytes of the secret this frame holds
+    long numBits;                   //bits of the payload in use
+    bool pending;                   //read but not yet written or handed on
+    thread worker;
+};
+
+//header followed by the secret, handed out a frame at a time
+struct Y4mPayload
+{
+    string header;
+    size_t headerDone;
+    StegoReader reader;
+    void *context;
+};
+
+static bool openStream(Y4mStream *, const string &);
+static void closeStream(Y4mStream *);
+static bool readLine(FILE *, string *);
+static int readFrame(Y4mStream *, Y4mFrame *);
+static bool writeFrame(FILE *, const Y4mFrame *);
+static long long frameBytes(const Y4mStream *, const BitMask *, int);
+static long long countFrames(const Y4mStream *, const string &);
+static bool fillPayload(Y4mPayload *, unsigned char *, long);
+static void embedFrame(const Y4mStream *, const BitMask *, int, Y4mFrame *);
+static void retrieveFrame(const Y4mStream *, const BitMask *, int, Y4mFrame *);
+static bool checkArguments(const BitMask *, int);
+static int framesInFlight();
+
+
+/*****************************************************************
+** Function: y4mIsCarrier
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool y4mIsCarrier(const string &path)
+**              const string &path -- File to check
+**
+**
+** Returns:
+**			bool -- True if the file starts like a Y4M stream
+**********************************************************************/
+bool y4mIsCarrier(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char start[10];
+    bool y4m = fread(start, 1, 10, file) == 10 && memcmp(start, "YUV4MPEG2 ", 10) == 0;
+    fclose(file);
+
+    return y4m;
+}
+
+
+
+/*****************************************************************
+** Function: y4mJobMemory
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long y4mJobMemory(const string &path)
+**              const string &path -- Y4M carrier
+**
+**
+** Returns:
+**			long long -- Most memory an embed or retrieve of the carrier
+**                       holds, or -1 if it is not a readable Y4M stream
+**
+** Notes:
+** The same whatever the size of the secret, which is streamed.
+**********************************************************************/
+long long y4mJobMemory(const string &path)
+{
+    Y4mStream stream;
+    long long memory = openStream(&stream, path) ? (long long) stream.frameSize * Y4M_MAX_FRAMES * 2 : -1;
+    closeStream(&stream);
+
+    return memory;
+}
+
+
+
+/*****************************************************************
+** Function: y4mCapacity
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long y4mCapacity(const string &path, const BitMask *bitMask, int planes)
+**              const string &path -- Y4M carrier
+**              const BitMask *bitMask -- Positions that are available
+**              int planes -- Y4M_PLANE_ flags of the planes to use
+**
+**
+** Returns:
+**			long long -- Number of bits the carrier can hold, header included,
+**                       or -1 if it can not be read
+**
+** Notes:
+** Counts the frames from the size of the file, which is exact unless
+** the frame headers carry parameters of their own.
+**********************************************************************/
+long long y4mCapacity(const string &path, const BitMask *bitMask, int planes)
+{
+    if (!checkArguments(bitMask, planes))
+    {
+        return -1;
+    }
+
+    Y4mStream stream;
+    long long capacity = -1;
+    if (openStream(&stream, path))
+    {
+        capacity = countFrames(&stream, path) * frameBytes(&stream, bitMask, planes) * 8;
+    }
+    closeStream(&stream);
+
+    return capacity;
+}
+
+
+
+/*****************************************************************
+** Function: y4mEmbed
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int y4mEmbed(const string &carrierPath, const string &outputPath, const BitMask *bitMask,
+**                       int planes, const string &name, long long size, StegoReader reader, void *context)
+**              const string &carrierPath -- Y4M carrier
+**              const string &outputPath -- Y4M to write, not the carrier itself
+**              const BitMask *bitMask -- Positions that are available
+**              int planes -- Y4M_PLANE_ flags of the planes to use
+**              const string &name -- Name of the secret's file
+**              long long size -- Size of the secret
+**              StegoReader reader -- Hands over the secret
+**              void *context -- Passed to the reader
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Frames after the secret are copied through as they are. Nothing is
+** written if the secret does not fit, and an output left unfinished
+** by an error is removed.
+**********************************************************************/
+int y4mEmbed(const string &carrierPath, const string &outputPath, const BitMask *bitMask, int planes,
+             const string &name, long long size, StegoReader reader, void *context)
+{
+    if (!checkArguments(bitMask, planes) || name.empty() || size < 0)
+    {
+        return STEGO_ERROR;
+    }
+
+    Y4mStream stream;
+    long long bytesPerFrame = openStream(&stream, carrierPath) ? frameBytes(&stream, bitMask, planes) : 0;
+    if (bytesPerFrame == 0)
+    {
+        closeStream(&stream);
+        return STEGO_ERROR;
+    }
+
+    //the file name and the file size are each followed by a null as a delimeter
+    Y4mPayload payload;
+    stringstream ss;
+    ss << name << '\0' << size << '\0';
+    payload.header = ss.str();
+    payload.headerDone = 0;
+    payload.reader = reader;
+    payload.context = context;
+
+    long long payloadLeft = (long long) payload.header.length() + size;
+    if ((payloadLeft + bytesPerFrame - 1) / bytesPerFrame > countFrames(&stream, carrierPath))
+    {
+        closeStream(&stream);
+        return STEGO_TOO_BIG;
+    }
+
+    FILE *output = fopen(outputPath.c_str(), "wb");
+    if (output == NULL || fwrite(stream.header.data(), 1, stream.header.length(), output) != stream.header.length())
+    {
+        if (output != NULL)
+        {
+            fclose(output);
+        }
+        closeStream(&stream);
+        return STEGO_WRITE_FAILED;
+    }
+
+    int inFlight = framesInFlight();
+    vector<Y4mFrame> frames(inFlight);
+    for (int i = 0; i < inFlight; i++)
+    {
+        frames[i].planes.resize(stream.frameSize);
+        frames[i].payload.resize((size_t) bytesPerFrame);
+        frames[i].pending = false;
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_EMBED);
+
+    int result = STEGO_OK;
+    long long numFrames = 0;
+    long long index;
+    for (index = 0; ; index++)
+    {
+        //the frame read into this buffer last time goes out first
+        Y4mFrame *frame = &frames[index % inFlight];
+        if (frame->pending)
+        {
+            if (frame->worker.joinable())
+            {
+                frame->worker.join();
+            }
+            frame->pending = false;
+
+            if (!writeFrame(output, frame))
+            {
+                result = STEGO_WRITE_FAILED;
+                break;
+            }
+        }
+
+        int read = readFrame(&stream, frame);
+        if (read <= 0)
+        {
+            result = (read < 0) ? STEGO_ERROR : result;
+            break;
+        }
+        frame->pending = true;
+        frame->numBits = 0;
+        numFrames++;
+
+        if (payloadLeft > 0)
+        {
+            long length = (long) min(bytesPerFrame, payloadLeft);
+            if (!fillPayload(&payload, frame->payload.data(), length))
+            {
+                result = STEGO_READ_FAILED;
+                break;
+            }
+
+            frame->numBits = length * 8;
+            payloadLeft -= length;
+            frame->worker = thread(embedFrame, &stream, bitMask, planes, frame);
+        }
+    }
+
+    //the frames still in the ring are written oldest first
+    for (long long i = index + 1; i <= index + inFlight; i++)
+    {
+        Y4mFrame *frame = &frames[i % inFlight];
+        if (!frame->pending)
+        {
+            continue;
+        }
+
+        if (frame->worker.joinable())
+        {
+            frame->worker.join();
+        }
+        frame->pending = false;
+
+        if (result == STEGO_OK && !writeFrame(output, frame))
+        {
+            result = STEGO_WRITE_FAILED;
+        }
+    }
+
+    traceEnd(&span, numFrames * stream.width * stream.height, (long long) stream.frameSize * numFrames);
+    closeStream(&stream);
+
+    //a carrier with fewer frames than its size promised
+    if (result == STEGO_OK && payloadLeft > 0)
+    {
+        result = STEGO_TOO_BIG;
+    }
+    if (fclose(output) != 0 && result == STEGO_OK)
+    {
+        result = STEGO_WRITE_FAILED;
+    }
+    if (result != STEGO_OK)
+    {
+        remove(outputPath.c_str());
+    }
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: y4mReadHeader
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int y4mReadHeader(const string &path, const BitMask *bitMask, int planes, SecretHeader *header)
+**              const string &path -- Y4M that may have a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              int planes -- Y4M_PLANE_ flags of the planes used
+**              SecretHeader *header -- Filled in with the header found
+**
+**
+** Returns:
+**			int -- STEGO_OK, STEGO_NO_SECRET if there is no believable header,
+**                 or STEGO_ERROR if the file is not a readable Y4M stream
+**
+** Notes:
+** Reads only the first frames, as far as the longest header there
+** can be.
+**********************************************************************/
+int y4mReadHeader(const string &path, const BitMask *bitMask, int planes, SecretHeader *header)
+{
+    if (!checkArguments(bitMask, planes))
+    {
+        return STEGO_ERROR;
+    }
+
+    Y4mStream stream;
+    long long bytesPerFrame = openStream(&stream, path) ? frameBytes(&stream, bitMask, planes) : 0;
+    if (bytesPerFrame == 0)
+    {
+        closeStream(&stream);
+        return STEGO_ERROR;
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_HEADER_DECODE);
+
+    long maxLength = MAX_NAME_LENGTH + MAX_SIZE_LENGTH + 2;
+    string text;
+    Y4mFrame frame;
+    frame.planes.resize(stream.frameSize);
+    frame.payload.resize((size_t) bytesPerFrame);
+
+    while ((long) text.length() < maxLength && readFrame(&stream, &frame) > 0)
+    {
+        long length = (long) min(bytesPerFrame, (long long) (maxLength - text.length()));
+        frame.numBits = length * 8;
+        retrieveFrame(&stream, bitMask, planes, &frame);
+        text.append((const char *) frame.payload.data(), length);
+    }
+
+    long long capacity = countFrames(&stream, path) * bytesPerFrame;
+    closeStream(&stream);
+    traceEnd(&span, 0, (long long) text.length());
+
+    //first we need the file name, then the file size
+    size_t nameEnd = text.find('\0');
+    size_t sizeEnd = (nameEnd == string::npos) ? string::npos : text.find('\0', nameEnd + 1);
+    if (sizeEnd == string::npos || nameEnd == 0 || nameEnd > MAX_NAME_LENGTH)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    //no options are written into a video, and a size this long could not fit anyway
+    string fileSizeStr = text.substr(nameEnd + 1, sizeEnd - nameEnd - 1);
+    if (fileSizeStr.empty() || fileSizeStr.length() > 18 || fileSizeStr.find_first_not_of("0123456789") != string::npos)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    long long fileSize = atoll(fileSizeStr.c_str());
+    long long dataByte = (long long) sizeEnd + 1;
+    if (fileSize <= 0 || fileSize > capacity - dataByte)
+    {
+        return STEGO_NO_SECRET;
+    }
+
+    header->name = text.substr(0, nameEnd);
+    header->size = fileSize;
+    header->dataSlot = dataByte * 8;
+    stegoDefaultOptions(&header->options);
+
+    return STEGO_OK;
+}
+
+
+
+/*****************************************************************
+** Function: y4mExtractStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int y4mExtractStream(const string &path, const BitMask *bitMask, int planes,
+**                               const SecretHeader *header, StegoWriter writer, void *context)
+**              const string &path -- Y4M that has a secret embedded
+**              const BitMask *bitMask -- Positions that have embedded data
+**              int planes -- Y4M_PLANE_ flags of the planes used
+**              const SecretHeader *header -- Header from y4mReadHeader
+**              StegoWriter writer -- Takes the secret, in order
+**              void *context -- Passed to the writer
+**
+**
+** Returns:
+**			int -- STEGO_OK, or one of the STEGO_ errors
+**
+** Notes:
+** Stops reading at the last frame of the secret.
+**********************************************************************/
+int y4mExtractStream(const string &path, const BitMask *bitMask, int planes,
+                     const SecretHeader *header, StegoWriter writer, void *context)
+{
+    if (!checkArguments(bitMask, planes))
+    {
+        return STEGO_ERROR;
+    }
+
+    Y4mStream stream;
+    long long bytesPerFrame = openStream(&stream, path) ? frameBytes(&stream, bitMask, planes) : 0;
+    if (bytesPerFrame == 0)
+    {
+        closeStream(&stream);
+        return STEGO_ERROR;
+    }
+
+    long long firstByte = header->dataSlot / 8;
+    long long lastByte = firstByte + header->size;
+    long long numFrames = (lastByte + bytesPerFrame - 1) / bytesPerFrame;
+
+    int inFlight = framesInFlight();
+    vector<Y4mFrame> frames(inFlight);
+    for (int i = 0; i < inFlight; i++)
+    {
+        frames[i].planes.resize(stream.frameSize);
+        frames[i].payload.resize((size_t) bytesPerFrame);
+        frames[i].numBits = (long) bytesPerFrame * 8;
+        frames[i].pending = false;
+    }
+
+    TraceSpan span;
+    traceBegin(&span, STAGE_EXTRACT);
+
+    int result = STEGO_OK;
+    long long index;
+    for (index = 0; index < numFrames + inFlight; index++)
+    {
+        //the frame retrieved into this buffer last time is handed on first
+        Y4mFrame *frame = &frames[index % inFlight];
+        if (frame->pending)
+        {
+            frame->worker.join();
+            frame->pending = false;
+
+            long long start = (index - inFlight) * bytesPerFrame;
+            long long from = max(start, firstByte);
+            long long to = min(start + bytesPerFrame, lastByte);
+            if (result == STEGO_OK && from < to
+                && !writer(context, (const char *) frame->payload.data() + (from - start), (long) (to - from)))
+            {
+                result = STEGO_WRITE_FAILED;
+            }
+        }
+
+        if (index >= numFrames || result != STEGO_OK)
+        {
+            continue;
+        }
+
+        if (readFrame(&stream, frame) <= 0)
+        {
+            result = STEGO_ERROR;
+            continue;
+        }
+
+        frame->pending = true;
+        frame->worker = thread(retrieveFrame, &stream, bitMask, planes, frame);
+    }
+
+    traceEnd(&span, numFrames * stream.width * stream.height, header->size);
+    closeStream(&stream);
+
+    return result;
+}
+
+
+
+/*****************************************************************
+** Function: openStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool openStream(Y4mStream *stream, const string &path)
+**              Y4mStream *stream -- Set to the layout of the stream, ready at the first frame
+**              const string &path -- Y4M to read
+**
+**
+** Returns:
+**			bool -- False if the file is not a Y4M stream this can read
+**
+** Notes:
+** Takes 8 bit 4:2:0, 4:2:2, 4:4:4, 4:1:1 and mono streams; without a
+** C parameter a stream is 4:2:0. The stream has to be closed even
+** when this fails.
+**********************************************************************/
+static bool openStream(Y4mStream *stream, const string &path)
+{
+    stream->width = 0;
+    stream->height = 0;
+    stream->frameSize = 0;
+    stream->file = fopen(path.c_str(), "rb");
+    if (stream->file == NULL || !readLine(stream->file, &stream->header)
+        || stream->header.compare(0, 10, "YUV4MPEG2 ") != 0)
+    {
+        return false;
+    }
+
+    string colourSpace = "420";
+    stringstream ss(stream->header.substr(10));
+    string parameter;
+    while (ss >> parameter)
+    {
+        if (parameter[0] == 'W')
+        {
+            stream->width = atoi(parameter.c_str() + 1);
+        }
+        else if (parameter[0] == 'H')
+        {
+            stream->height = atoi(parameter.c_str() + 1);
+        }
+        else if (parameter[0] == 'C')
+        {
+            colourSpace = parameter.substr(1);
+        }
+    }
+
+    //subsampling of the chroma planes across and down
+    int across;
+    int down;
+    stream->numPlanes = 3;
+    if (colourSpace == "420" || colourSpace == "420jpeg" || colourSpace == "420paldv" || colourSpace == "420mpeg2")
+    {
+        across = 2;
+        down = 2;
+    }
+    else if (colourSpace == "422" || colourSpace == "411" || colourSpace == "444")
+    {
+        across = (colourSpace == "422") ? 2 : (colourSpace == "411") ? 4 : 1;
+        down = 1;
+    }
+    else if (colourSpace == "mono")
+    {
+        across = 1;
+        down = 1;
+        stream->numPlanes = 1;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (stream->width <= 0 || stream->height <= 0 || (long long) stream->width * stream->height > 0x7FFFFFFF)
+    {
+        return false;
+    }
+
+    stream->planeSize[0] = (long) stream->width * stream->height;
+    stream->planeSize[1] = (long) ((stream->width + across - 1) / across) * ((stream->height + down - 1) / down);
+    stream->planeSize[2] = stream->planeSize[1];
+    stream->frameSize = 0;
+    for (int p = 0; p < stream->numPlanes; p++)
+    {
+        stream->frameSize += stream->planeSize[p];
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: closeStream
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void closeStream(Y4mStream *stream)
+**              Y4mStream *stream -- Stream from openStream
+**
+**
+** Returns:
+**			void
+**********************************************************************/
+static void closeStream(Y4mStream *stream)
+{
+    if (stream->file != NULL)
+    {
+        fclose(stream->file);
+        stream->file = NULL;
+    }
+}
+
+
+
+/*****************************************************************
+** Function: readLine
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool readLine(FILE *file, string *line)
+**              FILE *file -- File to read from
+**              string *line -- Set to the line, newline included
+**
+**
+** Returns:
+**			bool -- False at the end of the file, or if the line is longer than Y4M_MAX_LINE
+**********************************************************************/
+static bool readLine(FILE *file, string *line)
+{
+    line->clear();
+
+    int character;
+    while ((character = getc(file)) != EOF && line->length() < Y4M_MAX_LINE)
+    {
+        *line += (char) character;
+        if (character == '\n')
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+/*****************************************************************
+** Function: readFrame
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int readFrame(Y4mStream *stream, Y4mFrame *frame)
+**              Y4mStream *stream -- Stream to read the next frame of
+**              Y4mFrame *frame -- Receives the frame header and planes
+**
+**
+** Returns:
+**			int -- 1 for a frame, 0 at the end of the stream, -1 for a broken frame
+**********************************************************************/
+static int readFrame(Y4mStream *stream, Y4mFrame *frame)
+{
+    if (!readLine(stream->file, &frame->header))
+    {
+        return frame->header.empty() ? 0 : -1;
+    }
+
+    if (frame->header.compare(0, 5, "FRAME") != 0)
+    {
+        return -1;
+    }
+
+    return (fread(frame->planes.data(), 1, stream->frameSize, stream->file) == (size_t) stream->frameSize) ? 1 : -1;
+}
+
+
+
+/*****************************************************************
+** Function: writeFrame
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool writeFrame(FILE *file, const Y4mFrame *frame)
+**              FILE *file -- Output stream
+**              const Y4mFrame *frame -- Frame to write
+**
+**
+** Returns:
+**			bool -- False if the frame could not be written
+**********************************************************************/
+static bool writeFrame(FILE *file, const Y4mFrame *frame)
+{
+    return fwrite(frame->header.data(), 1, frame->header.length(), file) == frame->header.length()
+           && fwrite(frame->planes.data(), 1, frame->planes.size(), file) == frame->planes.size();
+}
+
+
+
+/*****************************************************************
+** Function: frameBytes
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long frameBytes(const Y4mStream *stream, const BitMask *bitMask, int planes)
+**              const Y4mStream *stream -- Layout of the stream
+**              const BitMask *bitMask -- Positions that are available
+**              int planes -- Y4M_PLANE_ flags of the planes to use
+**
+**
+** Returns:
+**			long long -- Bytes of the secret each frame holds
+**********************************************************************/
+static long long frameBytes(const Y4mStream *stream, const BitMask *bitMask, int planes)
+{
+    long long samples = 0;
+    if (planes & Y4M_PLANE_LUMA)
+    {
+        samples += stream->planeSize[0];
+    }
+    if ((planes & Y4M_PLANE_CHROMA) && stream->numPlanes == 3)
+    {
+        samples += stream->planeSize[1] + stream->planeSize[2];
+    }
+
+    return samples * bitMask->numBits / 8;
+}
+
+
+
+/*****************************************************************
+** Function: countFrames
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          long long countFrames(const Y4mStream *stream, const string &path)
+**              const Y4mStream *stream -- Layout of the stream
+**              const string &path -- File the stream is in
+**
+**
+** Returns:
+**			long long -- Number of frames, assuming plain FRAME headers
+**********************************************************************/
+static long long countFrames(const Y4mStream *stream, const string &path)
+{
+    ifstream file(path, ios_base::binary | ios_base::ate);
+    long long fileSize = file.is_open() ? (long long) file.tellg() : 0;
+    long long frameSize = (long long) strlen("FRAME\n") + stream->frameSize;
+
+    return (fileSize > (long long) stream->header.length())
+           ? (fileSize - (long long) stream->header.length()) / frameSize : 0;
+}
+
+
+
+/*****************************************************************
+** Function: fillPayload
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool fillPayload(Y4mPayload *payload, unsigned char *buffer, long length)
+**              Y4mPayload *payload -- Header and secret still to hand out
+**              unsigned char *buffer -- Receives the next bytes
+**              long length -- Number of bytes wanted
+**
+**
+** Returns:
+**			bool -- False if the reader ran out first
+**
+** Notes:
+** Hands out what is left of the header before asking the reader.
+**********************************************************************/
+static bool fillPayload(Y4mPayload *payload, unsigned char *buffer, long length)
+{
+    long done = (long) min((size_t) length, payload->header.length() - payload->headerDone);
+    memcpy(buffer, payload->header.data() + payload->headerDone, (size_t) done);
+    payload->headerDone += (size_t) done;
+
+    while (done < length)
+    {
+        long numRead = payload->reader(payload->context, (char *) buffer + done, length - done);
+        if (numRead <= 0)
+        {
+            return false;
+        }
+        done += numRead;
+    }
+
+    return true;
+}
+
+
+
+/*****************************************************************
+** Function: embedFrame
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void embedFrame(const Y4mStream *stream, const BitMask *bitMask, int planes, Y4mFrame *frame)
+**              const Y4mStream *stream -- Layout of the stream
+**              const BitMask *bitMask -- Positions that are available
+**              int planes -- Y4M_PLANE_ flags of the planes to use
+**              Y4mFrame *frame -- Frame to embed its payload in
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own. Each plane is one long scanline.
+**********************************************************************/
+static void embedFrame(const Y4mStream *stream, const BitMask *bitMask, int planes, Y4mFrame *frame)
+{
+    unsigned char *plane = frame->planes.data();
+    long done = 0;
+
+    for (int p = 0; p < stream->numPlanes && done < frame->numBits; p++)
+    {
+        if (planes & ((p == 0) ? Y4M_PLANE_LUMA : Y4M_PLANE_CHROMA))
+        {
+            done += embedBitsInScanline(plane, (int) stream->planeSize[p], FORMAT_GRAY8, bitMask, 0,
+                                        frame->payload.data(), done, frame->numBits - done, NULL);
+        }
+        plane += stream->planeSize[p];
+    }
+}
+
+
+
+/*****************************************************************
+** Function: retrieveFrame
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          void retrieveFrame(const Y4mStream *stream, const BitMask *bitMask, int planes, Y4mFrame *frame)
+**              const Y4mStream *stream -- Layout of the stream
+**              const BitMask *bitMask -- Positions that have embedded data
+**              int planes -- Y4M_PLANE_ flags of the planes used
+**              Y4mFrame *frame -- Frame to retrieve its payload from
+**
+**
+** Returns:
+**			void
+**
+** Notes:
+** Runs on a thread of its own, except when reading the header.
+**********************************************************************/
+static void retrieveFrame(const Y4mStream *stream, const BitMask *bitMask, int planes, Y4mFrame *frame)
+{
+    const unsigned char *plane = frame->planes.data();
+    long done = 0;
+
+    for (int p = 0; p < stream->numPlanes && done < frame->numBits; p++)
+    {
+        if (planes & ((p == 0) ? Y4M_PLANE_LUMA : Y4M_PLANE_CHROMA))
+        {
+            done += retrieveBitsFromScanline(plane, (int) stream->planeSize[p], FORMAT_GRAY8, bitMask, 0,
+                                             frame->payload.data(), done, frame->numBits - done);
+        }
+        plane += stream->planeSize[p];
+    }
+}
+
+
+
+/*****************************************************************
+** Function: checkArguments
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          bool checkArguments(const BitMask *bitMask, int planes)
+**              const BitMask *bitMask -- Positions asked for
+**              int planes -- Y4M_PLANE_ flags asked for
+**
+**
+** Returns:
+**			bool -- False unless there is an 8 bit position and a plane to use
+**********************************************************************/
+static bool checkArguments(const BitMask *bitMask, int planes)
+{
+    return bitMask->depth == NUM_BITS && bitMask->numBits > 0
+           && (planes & (Y4M_PLANE_LUMA | Y4M_PLANE_CHROMA)) != 0
+           && (planes & ~(Y4M_PLANE_LUMA | Y4M_PLANE_CHROMA)) == 0;
+}
+
+
+
+/*****************************************************************
+** Function: framesInFlight
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int framesInFlight()
+**
+**
+** Returns:
+**			int -- Size of the ring of frames
+**
+** Notes:
+** One frame per core with one more being read, at least two and at
+** most Y4M_MAX_FRAMES.
+**********************************************************************/
+static int framesInFlight()
+{
+    int numFrames = (int) thread::hardware_concurrency() + 1;
+
+    return max(2, min(numFrames, Y4M_MAX_FRAMES));
+}
@@ -0,0 +1,22 @@
+#ifndef Y4MSTEGO_H
+#define Y4MSTEGO_H
+
+#include <string>
+#include "stegoCore.h"
+
+//planes of a frame that hold the secret
+#define Y4M_PLANE_LUMA 1
+#define Y4M_PLANE_CHROMA 2
+
+#define Y4M_MAX_LINE 1024           //longest stream or frame header
+#define Y4M_MAX_FRAMES 16           //most frames one embed or retrieve holds at once
+
+bool y4mIsCarrier(const std::string &);
+long long y4mJobMemory(const std::string &);
+long long y4mCapacity(const std::string &, const BitMask *, int);
+int y4mEmbed(const std::string &, const std::string &, const BitMask *, int, const std::string &, long long,
+             StegoReader, void *);
+int y4mReadHeader(const std::string &, const BitMask *, int, SecretHeader *);
+int y4mExtractStream(const std::string &, const BitMask *, int, const SecretHeader *, StegoWriter, void *);
+
+#endif // Y4MSTEGO_H
@@ -0,0 +1,184 @@
+/**********************************************************************
+**	SOURCE FILE:	detectBitMaskTest.cpp
+**
+**	PROGRAM:	Steganography
+**
+**	FUNCTIONS:
+**    int main(int, char **)
+**    string randomName(mt19937 *)
+**
+**
+**	DATE:        October 19th, 2026
+**
+**
+**	DESIGNER:	Rhea Lauzon
+**
+**
+**	PROGRAMMER: Rhea Lauzon
+**
+**	NOTES:
+** Embeds secrets into carriers of random pixels with random bit masks,
+** names, sizes and options, and checks that stegoDetectBitMask finds
+** the mask each was embedded with. It must never give a wrong mask.
+** Now and then a mask next to the real one decodes to another header
+** just as believable, e.g. "thovo08" for "photo08", and detection gives
+** none; that may happen to at most one carrier in MAX_UNDETECTED_SHARE.
+** It only needs the Qt-free core:
+**
+**   g++ -O2 -pthread -I../Source detectBitMaskTest.cpp ../Source/stegoCore.cpp
+**       ../Source/imageManipulation.cpp ../Source/reedSolomon.cpp ../Source/stegoTrace.cpp
+**
+** The number of carriers can be given on the command line. Exits with
+** 1 if any mask was detected wrong or too many were not detected.
+*************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "stegoCore.h"
+
+#define DEFAULT_NUM_CARRIERS 1000
+#define MAX_UNDETECTED_SHARE 200
+
+using namespace std;
+
+static string randomName(mt19937 *random);
+
+
+/*****************************************************************
+** Function: main
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          int main(int argc, char **argv)
+**              int argc -- Number of arguments
+**              char **argv -- Number of carriers to try, if given
+**
+** Returns:
+**          int -- 0 if the masks were detected, 1 otherwise
+**********************************************************************/
+int main(int argc, char **argv)
+{
+    int numCarriers = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_CARRIERS;
+    const char *optionTexts[] = {"", "", "", "matrix=3", "fec=32", "adaptive=40", "fec=16;matrix=2"};
+    const PixelFormat formats[] = {FORMAT_RGB32, FORMAT_RGB32, FORMAT_RGBA64, FORMAT_GRAY8};
+    mt19937 random(2026);
+    int numTried = 0;
+    int numWrong = 0;
+    int numUndetected = 0;
+
+    for (int i = 0; i < numCarriers; i++)
+    {
+        PixelFormat format = formats[random() % 4];
+        int width = 60 + random() % 300;
+        int height = 60 + random() % 300;
+        long stride = (long) width * pixelSizeInFormat(format);
+
+        vector<unsigned char> pixels(stride * height);
+        for (size_t p = 0; p < pixels.size(); p++)
+        {
+            pixels[p] = (unsigned char) random();
+        }
+
+        PixelBuffer carrier = {pixels.data(), width, height, stride, format};
+
+        //legacy masks only ever used the low 8 positions
+        unsigned int mask = 1 + random() % 255;
+        bool enabledBits[MAX_NUM_BITS] = {false};
+        for (int pos = 0; pos < NUM_BITS; pos++)
+        {
+            enabledBits[pos] = (mask >> pos) & 1;
+        }
+
+        BitMask bitMask;
+        buildBitMask(&bitMask, enabledBits, depthInFormat(format));
+
+        const char *optionText = optionTexts[random() % 7];
+        StegoOptions options;
+        stegoParseOptions(optionText, &options);
+
+        long long capacity = stegoCapacity(&carrier, &bitMask, &options) / 8 - MAX_NAME_LENGTH - 64;
+        if (capacity < 1)
+        {
+            continue;
+        }
+
+        string name = randomName(&random);
+        vector<char> secret(1 + random() % min(capacity, 20000LL));
+        for (size_t b = 0; b < secret.size(); b++)
+        {
+            secret[b] = (char) random();
+        }
+
+        if (stegoEmbed(&carrier, &bitMask, &options, name, secret.data(), secret.size(), NULL) != STEGO_OK)
+        {
+            continue;
+        }
+        numTried++;
+
+        bool detectedBits[MAX_NUM_BITS];
+        unsigned int detected = 0;
+        stegoDetectBitMask(&carrier, detectedBits);
+        for (int pos = 0; pos < MAX_NUM_BITS; pos++)
+        {
+            detected |= (unsigned int) detectedBits[pos] << pos;
+        }
+
+        if (detected != mask)
+        {
+            (detected == 0) ? numUndetected++ : numWrong++;
+            printf("carrier %d: %dx%d embedded with mask %02x as \"%s\" (%s), detected %02x\n",
+                   i, width, height, mask, name.c_str(), optionText, detected);
+        }
+    }
+
+    printf("%d of %d masks detected, %d wrong\n", numTried - numWrong - numUndetected, numTried, numWrong);
+
+    return (numWrong == 0 && numUndetected <= numTried / MAX_UNDETECTED_SHARE) ? 0 : 1;
+}
+
+
+
+/*****************************************************************
+** Function: randomName
+**
+** Date: October 19th, 2026
+**
+** Revisions:
+**
+**
+** Designer: Rhea Lauzon
+**
+** Programmer: Rhea Lauzon
+**
+** Interface:
+**          string randomName(mt19937 *random)
+**              mt19937 *random -- Generator to draw from
+**
+** Returns:
+**          string -- File name of a secret, a word with digits and an extension
+**********************************************************************/
+static string randomName(mt19937 *random)
+{
+    const char *words[] = {"secret", "report", "notes", "IMG_", "photo", "backup", "Plans", "data", "a"};
+    const char *extensions[] = {".txt", ".pdf", ".zip", ".jpg", ".docx", ".tar.gz", ""};
+
+    string name = words[(*random)() % 9];
+    int numDigits = (*random)() % 5;
+    for (int d = 0; d < numDigits; d++)
+    {
+        name += (char) ('0' + (*random)() % 10);
+    }
+
+    return name + extensions[(*random)() % 7];
+}